@@ -27,21 +27,66 @@
 
 #include <QThread>
 #include <QTcpSocket>
+#include <QElapsedTimer>
 #include <QCoreApplication>
 
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
 #include "../daemon_port.h"
+#include "../main/diagnostics/Metrics.h"
+#include "../main/diagnostics/Tracer.h"
 
 extern "C" {
     #include "key_sender.h"
 }
 
-KeySenderDaemon::KeySenderDaemon()
+// The maximum number of schedules, further schedules are ignored
+static const int maxSchedules = 64;
+
+// The minimum interval of periodic schedules in ms
+static const int minimumInterval = 100;
+
+// The maximum motion of a single pointer move and of an injected motion
+static const int maxMotion = 4096;
+static const int maxPendingMotion = 32767;
+
+KeySenderDaemon::KeySenderDaemon() :
+    KeySenderDaemon(KEYSENDER_PORT, false)
+{}
+
+KeySenderDaemon::KeySenderDaemon(quint16 port, bool nullDevice) :
+    openConnections(0), connections(0), pointerMoves(0), pointerFlushes(0),
+    pendingMotionX(0), pendingMotionY(0), schedules(), timerNotifier(NULL),
+    keySenderInitialized(false)
 {
+    memset(commandBuffer, 0, sizeof(commandBuffer));
+
+    // A single timer with absolute deadlines for all schedules
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd >= 0)
+    {
+        timerNotifier = new QSocketNotifier(timerFd, QSocketNotifier::Read,
+                                            this);
+        connect(timerNotifier, SIGNAL(activated(int)),
+                this, SLOT(runSchedules()));
+    }
+    else
+    {
+        qWarning("Scheduling not available, no timer");
+    }
+
     server = new QTcpServer(this);
 
     connect(server, SIGNAL(newConnection()), this, SLOT(newConnection()));
 
-    if(!server->listen(QHostAddress::LocalHost, KEYSENDER_PORT))
+    if(!server->listen(QHostAddress::LocalHost, port))
     {
         qWarning("Server could not start");
         QCoreApplication::exit(EXIT_FAILURE);
@@ -52,8 +97,17 @@ KeySenderDaemon::KeySenderDaemon()
         qDebug("Server started");
     }
 
-    init_keysender();
-    QThread::sleep(0.5); // Make sure that the keysender is ready
+    if (nullDevice)
+    {
+        init_null_keysender();
+        qInfo("Writing keys to the null device");
+    }
+    else
+    {
+        init_keysender();
+        QThread::sleep(0.5); // Make sure that the keysender is ready
+    }
+    keySenderInitialized = true;
 
     qInfo("Key sender up and running. Waiting for commands...");
 }
@@ -61,16 +115,37 @@ KeySenderDaemon::KeySenderDaemon()
 KeySenderDaemon::~KeySenderDaemon()
 {
     qInfo("Stopping server");
-    destroy_keysender();
+    if (keySenderInitialized)
+    {
+        destroy_keysender();
+    }
 
     server->close();
     delete server;
+
+    delete timerNotifier;
+    if (timerFd >= 0)
+    {
+        close(timerFd);
+    }
+}
+
+bool KeySenderDaemon::isListening() const
+{
+    return server->isListening();
+}
+
+quint16 KeySenderDaemon::serverPort() const
+{
+    return server->serverPort();
 }
 
 void KeySenderDaemon::newConnection()
 {
     qInfo("Received new connection");
     QTcpSocket *serverSocket = server->nextPendingConnection();
+    connections.fetchAndAddRelaxed(1);
+    openConnections++;
 
     connect(serverSocket, SIGNAL(readyRead()), this, SLOT(readyRead()));
     connect(serverSocket, SIGNAL(disconnected()), this, SLOT(disconnected()));
@@ -84,36 +159,467 @@ void KeySenderDaemon::readyRead()
 
     while (socket->canReadLine())
     {
-        QString command = socket->readLine().trimmed();
+        TraceSpan span("daemon receive");
 
-        if (command == "sendNext")
+        // Read into our own buffer, so no memory is allocated per command
+        qint64 length = socket->readLine(commandBuffer, sizeof(commandBuffer));
+        quint64 traceId = 0;
+        Command command = Ignored;
+
+        // A line that does not fit is dropped as a whole, so its pieces
+        // can't be taken for commands
+        if (length > 0 && commandBuffer[length - 1] != '\n')
         {
-            qInfo("sendNext");
-            send_next();
+            discardLine(socket);
+            commandBuffer[length] = '\0';
         }
-        else if (command == "sendPrev")
+        else
         {
-            qInfo("sendPrev");
-            send_prev();
+            command = parseCommand(commandBuffer, length, &traceId);
         }
-        else if (command == "startPresentation")
+
+        // The trace id is sent in a line before its command
+        if (command == Trace)
         {
-            qInfo("startPresentation");
-            send_start_presentation();
+            pendingTraces.insert(socket, traceId);
+            continue;
         }
-        else if (command == "stopPresentation")
+
+        // Continue the trace of the presenter server
+        traceId = pendingTraces.take(socket);
+        Tracer::setCurrentTrace(traceId);
+        Tracer* tracer = Tracer::instance();
+        if (tracer && traceId != 0)
         {
-            qInfo("stopPresentation");
-            send_stop_presentation();
+            tracer->flowEnd(traceId);
         }
-        else
+
+        // Keep the order of the moves and the other commands, so e.g. a
+        // pong confirms the moves before
+        if (command != Move)
+        {
+            flushMotion();
+        }
+
+        switch (command)
         {
-            qWarning("Ignoring command: '%s'", command.toStdString().c_str());
+            case Ping:
+                // Allows clients to measure the latency of the daemon
+                socket->write("pong\n", 5);
+                continue;
+
+            case Stats:
+                // Queried by the metrics server of the presenter server,
+                // which closes the connection afterwards
+                statsConnections.insert(socket);
+                socket->write(statistics());
+                continue;
+
+            case Schedule:
+                addSchedule(commandBuffer, socket);
+                continue;
+
+            case Cancel:
+                cancelSchedule(commandBuffer, socket);
+                continue;
+
+            case CancelAll:
+                schedules.cancelAll(quintptr(socket));
+                armTimer();
+                continue;
+
+            case Move:
+                // Moves arrive faster than the display refreshes, so all
+                // moves of this read are injected at once
+                addMotion(commandBuffer);
+                continue;
+
+            case Ignored:
+                qWarning("Ignoring command: '%s'", commandBuffer);
+                commands[Ignored].fetchAndAddRelaxed(1);
+                continue;
+
+            default:
+                break;
         }
+
+        injectAndCount(command);
+    }
+
+    flushMotion();
+}
+
+void KeySenderDaemon::discardLine(QIODevice* device)
+{
+    char rest[64];
+    qint64 length = 0;
+    do
+    {
+        length = device->readLine(rest, sizeof(rest));
+    }
+    while (length > 0 && rest[length - 1] != '\n');
+}
+
+KeySenderDaemon::Command KeySenderDaemon::parseCommand(char* line,
+                                                       qint64 length,
+                                                       quint64* traceId)
+{
+    if (traceId)
+    {
+        *traceId = 0;
+    }
+
+    while (length > 0 && isspace((unsigned char)line[length - 1]))
+    {
+        length--;
+    }
+    length = qMax(length, qint64(0));
+    line[length] = '\0';
+
+    const char* separator = strchr(line, ' ');
+    qint64 nameLength = separator ? separator - line : length;
+
+    if (matches(line, nameLength, "schedule"))
+    {
+        return Schedule;
+    }
+    else if (matches(line, nameLength, "cancel"))
+    {
+        return Cancel;
+    }
+    else if (matches(line, nameLength, "move"))
+    {
+        return Move;
+    }
+
+    else if (matches(line, nameLength, "trace"))
+    {
+        // A line of its own, so daemons without tracing ignore it and
+        // still run the command after it
+        char* end = NULL;
+        quint64 id = separator ? strtoull(separator + 1, &end, 10) : 0;
+        if (!separator || !isdigit((unsigned char)separator[1])
+            || *end != '\0')
+        {
+            return Ignored;
+        }
+
+        if (traceId)
+        {
+            *traceId = id;
+        }
+        return Trace;
+    }
+
+    // The other commands have no arguments
+    if (separator)
+    {
+        return Ignored;
+    }
+
+    if (matches(line, nameLength, "sendNext"))
+    {
+        return SendNext;
+    }
+    else if (matches(line, nameLength, "sendPrev"))
+    {
+        return SendPrev;
+    }
+    else if (matches(line, nameLength, "startPresentation"))
+    {
+        return StartPresentation;
+    }
+    else if (matches(line, nameLength, "stopPresentation"))
+    {
+        return StopPresentation;
+    }
+    else if (matches(line, nameLength, "ping"))
+    {
+        return Ping;
+    }
+    else if (matches(line, nameLength, "stats"))
+    {
+        return Stats;
+    }
+    else if (matches(line, nameLength, "cancelAll"))
+    {
+        return CancelAll;
+    }
+
+    return Ignored;
+}
+
+bool KeySenderDaemon::matches(const char* line, qint64 length,
+                              const char* command)
+{
+    return qint64(strlen(command)) == length
+            && memcmp(line, command, size_t(length)) == 0;
+}
+
+void KeySenderDaemon::addSchedule(const char* line, QIODevice* connection)
+{
+    quint32 id = 0;
+    char name[32];
+    int delay = -1;
+    int interval = -1;
+    int fields = sscanf(line, "schedule %u %31s %d %d", &id, name, &delay,
+                        &interval);
+    if (fields != 4 || delay < 0 || interval < 0
+        || (interval > 0 && interval < minimumInterval))
+    {
+        qWarning("Ignoring invalid schedule: '%s'", line);
+        answerSchedule(connection, fields >= 1 ? id : 0, false);
+        return;
+    }
+
+    Command command = parseCommand(name, qint64(strlen(name)));
+    if (command > StopPresentation)
+    {
+        qWarning("Ignoring schedule of command: '%s'", name);
+        answerSchedule(connection, id, false);
+        return;
+    }
+
+    // The owner must match the sender of the cancel commands
+    quintptr owner = quintptr(static_cast<QObject*>(connection));
+    schedules.cancel(id, owner);
+    if (schedules.size() >= maxSchedules)
+    {
+        qWarning("Ignoring schedule, too many schedules");
+        answerSchedule(connection, id, false);
+        return;
+    }
+
+    ::Schedule schedule;
+    schedule.id = id;
+    schedule.owner = owner;
+    schedule.command = command;
+    schedule.deadline = now() + qint64(delay) * 1000;
+    schedule.interval = qint64(interval) * 1000;
+    schedules.add(schedule);
+    armTimer();
+    answerSchedule(connection, id, true);
+}
+
+void KeySenderDaemon::answerSchedule(QIODevice* connection, quint32 id,
+                                     bool accepted)
+{
+    if (id == 0)
+    {
+        return;
+    }
+
+    char answer[32];
+    int length = snprintf(answer, sizeof(answer), "%s %u\n",
+                          accepted ? "scheduled" : "rejected", id);
+    connection->write(answer, length);
+}
+
+void KeySenderDaemon::cancelSchedule(const char* line,
+                                     QObject* connection)
+{
+    quint32 id = 0;
+    if (sscanf(line, "cancel %u", &id) != 1)
+    {
+        qWarning("Ignoring invalid cancel: '%s'", line);
+        return;
     }
+
+    schedules.cancel(id, quintptr(connection));
+    armTimer();
+}
+
+void KeySenderDaemon::addMotion(const char* line)
+{
+    int dx = 0;
+    int dy = 0;
+    if (sscanf(line, "move %d %d", &dx, &dy) != 2
+        || qAbs(dx) > maxMotion || qAbs(dy) > maxMotion)
+    {
+        qWarning("Ignoring invalid move: '%s'", line);
+        return;
+    }
+
+    pendingMotionX += dx;
+    pendingMotionY += dy;
+    pointerMoves.fetchAndAddRelaxed(1);
+}
+
+void KeySenderDaemon::flushMotion()
+{
+    if (pendingMotionX == 0 && pendingMotionY == 0)
+    {
+        return;
+    }
+
+    TraceSpan span("uinput write");
+    send_pointer_motion(
+            int(qBound(qint64(-maxPendingMotion), pendingMotionX,
+                       qint64(maxPendingMotion))),
+            int(qBound(qint64(-maxPendingMotion), pendingMotionY,
+                       qint64(maxPendingMotion))));
+    pendingMotionX = 0;
+    pendingMotionY = 0;
+    pointerFlushes.fetchAndAddRelaxed(1);
+}
+
+void KeySenderDaemon::armTimer()
+{
+    if (timerFd < 0)
+    {
+        return;
+    }
+
+    // A zero deadline disarms the timer
+    struct itimerspec deadline;
+    memset(&deadline, 0, sizeof(deadline));
+    qint64 next = schedules.nextDeadline();
+    if (next >= 0)
+    {
+        deadline.it_value.tv_sec = next / 1000000;
+        deadline.it_value.tv_nsec = (next % 1000000) * 1000;
+    }
+
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &deadline, NULL);
+}
+
+void KeySenderDaemon::runSchedules()
+{
+    // Reset the expiration count, so the notifier does not fire again
+    quint64 expirations = 0;
+    if (read(timerFd, &expirations, sizeof(expirations)) < 0
+        && errno != EAGAIN)
+    {
+        qWarning("Could not read schedule timer");
+    }
+
+    ::Schedule due;
+    while (schedules.takeDue(now(), &due))
+    {
+        injectAndCount(Command(due.command));
+    }
+
+    armTimer();
+}
+
+void KeySenderDaemon::injectAndCount(Command command)
+{
+    QElapsedTimer injectionTimer;
+    injectionTimer.start();
+    inject(command);
+    commands[command].fetchAndAddRelaxed(1);
+    injectionLatency.record(injectionTimer.nsecsElapsed() / 1000);
+}
+
+qint64 KeySenderDaemon::now()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return qint64(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+}
+
+void KeySenderDaemon::inject(Command command)
+{
+    TraceSpan span("uinput write");
+
+    switch (command)
+    {
+        case SendNext:
+            send_next();
+            break;
+
+        case SendPrev:
+            send_prev();
+            break;
+
+        case StartPresentation:
+            send_start_presentation();
+            break;
+
+        case StopPresentation:
+            send_stop_presentation();
+            break;
+
+        default:
+            break;
+    }
+}
+
+QByteArray KeySenderDaemon::statistics() const
+{
+    static const char* const commandNames[commandCount] = {
+        "sendNext", "sendPrev", "startPresentation", "stopPresentation",
+        "ignored"
+    };
+
+    QByteArray out;
+    out.reserve(2048);
+
+    Metrics::appendHeader(out, "presenter_daemon_commands_total", "counter",
+                          "Commands received by the key sender daemon.");
+    for (int command = 0; command < commandCount; command++)
+    {
+        Metrics::appendSample(out, "presenter_daemon_commands_total",
+                              QByteArray("command=\"")
+                                  + commandNames[command] + "\"",
+                              commands[command].load());
+    }
+
+    Metrics::appendHeader(out, "presenter_daemon_injection_errors_total",
+                          "counter", "Key events that could not be injected.");
+    Metrics::appendSample(out, "presenter_daemon_injection_errors_total",
+                          QByteArray(), quint64(get_send_errors()));
+
+    Metrics::appendHeader(out, "presenter_daemon_connections_total",
+                          "counter", "Connections accepted by the daemon.");
+    Metrics::appendSample(out, "presenter_daemon_connections_total",
+                          QByteArray(), connections.load());
+
+    Metrics::appendHeader(out, "presenter_daemon_pointer_moves_total",
+                          "counter", "Pointer moves received by the daemon.");
+    Metrics::appendSample(out, "presenter_daemon_pointer_moves_total",
+                          QByteArray(), pointerMoves.load());
+
+    Metrics::appendHeader(out, "presenter_daemon_pointer_flushes_total",
+                          "counter",
+                          "Injected pointer motions, each combines the moves "
+                          "received at once.");
+    Metrics::appendSample(out, "presenter_daemon_pointer_flushes_total",
+                          QByteArray(), pointerFlushes.load());
+
+    Metrics::appendHeader(out, "presenter_daemon_schedules", "gauge",
+                          "Pending scheduled commands.");
+    Metrics::appendSample(out, "presenter_daemon_schedules",
+                          QByteArray(), quint64(schedules.size()));
+
+    Metrics::appendHistogram(out, "presenter_daemon_injection_latency_seconds",
+                             "Time to inject the key events of a command.",
+                             injectionLatency);
+
+    out.append("# EOF\n");
+    return out;
 }
 
 void KeySenderDaemon::disconnected()
 {
+    // Schedules don't outlive their connection, a later connection might
+    // get the same address
+    if (schedules.cancelAll(quintptr(sender())) > 0)
+    {
+        armTimer();
+    }
+    pendingTraces.remove(sender());
+
+    openConnections--;
+
+    // Only the presenter server stops the daemon, and only once its last
+    // connection is gone, e.g. while it reconnects
+    if (statsConnections.remove(sender())
+        || openConnections > statsConnections.size())
+    {
+        return;
+    }
+
     QCoreApplication::exit(EXIT_SUCCESS);
 }
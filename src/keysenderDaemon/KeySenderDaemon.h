@@ -26,12 +26,21 @@
 #ifndef SRC_KEYSENDERDAEMON_KEYSENDERDAEMON_H_
 #define SRC_KEYSENDERDAEMON_KEYSENDERDAEMON_H_
 
+#include <QSet>
+#include <QHash>
 #include <QObject>
+#include <QIODevice>
 #include <QTcpServer>
+#include <QAtomicInteger>
+#include <QSocketNotifier>
+
+#include "../main/connector/ScheduleHeap.h"
+#include "../main/diagnostics/LatencyHistogram.h"
 
 /**
  * The key sender daemon. Will listen on a network port and emit key presses
- * once it receives the corresponding message.
+ * once it receives the corresponding message. The "stats" command returns
+ * the statistics of the daemon in the Prometheus text format.
  */
 class KeySenderDaemon: public QObject {
     Q_OBJECT
@@ -42,11 +51,70 @@ class KeySenderDaemon: public QObject {
          */
         KeySenderDaemon();
 
+        /**
+         * Creates a new daemon instance on a given port and starts up
+         * the server.
+         *
+         * @param port The port to listen on. 0 to choose a free port.
+         * @param nullDevice If true, the keys are written to the null device
+         *                   instead of being injected into the system.
+         */
+        KeySenderDaemon(quint16 port, bool nullDevice);
+
         /**
          * Stops the server instance.
          */
         ~KeySenderDaemon();
 
+        /**
+         * Returns if the server is listening for commands.
+         *
+         * @return True if the server is listening.
+         */
+        bool isListening() const;
+
+        /**
+         * Returns the port the server is listening on.
+         *
+         * @return The port.
+         */
+        quint16 serverPort() const;
+
+        /**
+         * The commands of the daemon protocol. The commands up to
+         * {@link #Ignored} are counted in the statistics.
+         */
+        enum Command
+        {
+            SendNext,
+            SendPrev,
+            StartPresentation,
+            StopPresentation,
+            Ignored,
+            Ping,
+            Stats,
+            Schedule,
+            Cancel,
+            CancelAll,
+            Move,
+            Trace
+        };
+
+        /**
+         * Parses a received line. Trailing whitespace is removed in place
+         * and the line is terminated, so it can be logged. The arguments of
+         * {@link #Schedule}, {@link #Cancel} and {@link #Move} are not
+         * checked.
+         *
+         * @param line The line. Must have room for a terminating null byte.
+         * @param length The length of the line.
+         * @param traceId Receives the trace id of a {@link #Trace} line, 0
+         *                for other lines. May be NULL.
+         * @return The command, {@link #Ignored} if the line is unknown.
+         */
+        static Command parseCommand(char* line, qint64 length,
+                                    quint64* traceId = NULL);
+
     public slots:
         /**
          * Handler for incomming network connections.
@@ -59,15 +127,208 @@ class KeySenderDaemon: public QObject {
         void readyRead();
 
         /**
-         * Handler for disconnecting clients. Will close the sender if called.
+         * Handler for disconnecting clients. Cancels their schedules. Closes
+         * the sender once the last client that is no statistics connection
+         * disconnected.
          */
         void disconnected();
 
+        /**
+         * Handler for the schedule timer. Runs the schedules that are due.
+         */
+        void runSchedules();
+
     private:
+
         /**
          * The server instance.
          */
         QTcpServer* server;
+
+        /**
+         * The connections that queried the statistics. Closing them does
+         * not stop the daemon.
+         */
+        QSet<QObject*> statsConnections;
+
+        /**
+         * The trace ids of the presenter server that were received for the
+         * next command of a connection.
+         */
+        QHash<QObject*, quint64> pendingTraces;
+
+        /**
+         * The number of open connections, including the statistics
+         * connections.
+         */
+        int openConnections;
+
+        /**
+         * The number of received commands.
+         */
+        QAtomicInteger<quint64> commands[commandCount];
+
+        /**
+         * The number of accepted connections.
+         */
+        QAtomicInteger<quint64> connections;
+
+        /**
+         * The time to inject the key events.
+         */
+        LatencyHistogram injectionLatency;
+
+        /**
+         * The number of received pointer moves.
+         */
+        QAtomicInteger<quint64> pointerMoves;
+
+        /**
+         * The number of injected pointer motions, each of them combines
+         * the moves that were received at once.
+         */
+        QAtomicInteger<quint64> pointerFlushes;
+
+        /**
+         * The horizontal motion that was received, but not injected yet.
+         */
+        qint64 pendingMotionX;
+
+        /**
+         * The vertical motion that was received, but not injected yet.
+         */
+        qint64 pendingMotionY;
+
+        /**
+         * The scheduled commands of all connections. Each connection owns
+         * its schedules and chooses their ids.
+         */
+        ScheduleHeap schedules;
+
+        /**
+         * The timer for the earliest deadline of the schedules, -1 if not
+         * available.
+         */
+        int timerFd;
+
+        /**
+         * Notifies once the schedule timer expired.
+         */
+        QSocketNotifier* timerNotifier;
+
+        /**
+         * If the key sender has been initialized.
+         */
+        bool keySenderInitialized;
+
+        /**
+         * Buffer for the received commands. Allocated once with the daemon,
+         * so handling a command does not allocate memory.
+         */
+        char commandBuffer[64];
+
+        /**
+         * Checks if a command matches a given command name.
+         *
+         * @param line The command, not terminated.
+         * @param length The length of the command.
+         * @param command The name of the command.
+         * @return True if the command has the given name.
+         */
+        static bool matches(const char* line, qint64 length,
+                            const char* command);
+
+        /**
+         * Adds a schedule. The line has the format
+         * "schedule <id> <command> <delay ms> <interval ms>", an interval
+         * of 0 runs the command once. A schedule of the connection with
+         * the same id is replaced. The connection is answered with
+         * "scheduled <id>" or "rejected <id>".
+         *
+         * @param line The received line.
+         * @param connection The connection that sent the line.
+         */
+        void addSchedule(const char* line, QIODevice* connection);
+
+        /**
+         * Answers a schedule request.
+         *
+         * @param connection The connection that sent the request.
+         * @param id The id of the schedule, nothing is answered for 0.
+         * @param accepted If the schedule was added.
+         */
+        void answerSchedule(QIODevice* connection, quint32 id,
+                            bool accepted);
+
+        /**
+         * Cancels a schedule of a connection. The line has the format
+         * "cancel <id>".
+         *
+         * @param line The received line.
+         * @param connection The connection that sent the line.
+         */
+        void cancelSchedule(const char* line, QObject* connection);
+
+        /**
+         * Adds a pointer move to the pending motion. The line has the
+         * format "move <dx> <dy>".
+         *
+         * @param line The received line.
+         */
+        void addMotion(const char* line);
+
+        /**
+         * Injects the pending motion as a single relative move.
+         */
+        void flushMotion();
+
+        /**
+         * Arms the timer for the earliest deadline or disarms it if there
+         * are no schedules. The deadline is absolute, so the schedules
+         * don't drift.
+         */
+        void armTimer();
+
+        /**
+         * Injects a command and adds it to the statistics.
+         *
+         * @param command The command, one of the counted commands except
+         *                {@link #Ignored}.
+         */
+        void injectAndCount(Command command);
+
+        /**
+         * Returns the time of the monotonic clock of the system, which is
+         * also used by the schedule timer.
+         *
+         * @return The time in microseconds.
+         */
+        static qint64 now();
+
+        /**
+         * Injects the key events of a command.
+         *
+         * @param command The command, one of the counted commands except
+         *                {@link #Ignored}.
+         */
+        void inject(Command command);
+
+        /**
+         * Reads and drops the rest of a line that did not fit into the
+         * command buffer.
+         *
+         * @param device The device with the rest of the line. Must contain
+         *               the end of the line.
+         */
+        static void discardLine(QIODevice* device);
+
+        /**
+         * Renders the statistics in the Prometheus text format. The output
+         * is terminated by a "# EOF" line.
+         *
+         * @return The rendered statistics.
+         */
+        QByteArray statistics() const;
 };
 
 #endif /* SRC_KEYSENDERDAEMON_KEYSENDERDAEMON_H_ */
@@ -24,9 +24,15 @@
  */
 
 #include <QCoreApplication>
+#include <QCommandLineParser>
 
 #include "KeySenderDaemon.h"
+#include "RealtimeConfig.h"
+#include "../daemon_port.h"
+#include "../main/diagnostics/FileLogSink.h"
+#include "../main/diagnostics/Tracer.h"
 
+#include <sched.h>
 #include <signal.h>
 
 /**
@@ -60,10 +66,120 @@ int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Presenter key sender daemon");
+    parser.addHelpOption();
+
+    QCommandLineOption priorityOption("realtime-priority",
+            "Run with the given real-time priority (1-99).", "priority");
+    parser.addOption(priorityOption);
+    QCommandLineOption policyOption("sched",
+            "The real-time scheduling policy, \"fifo\" (default) or \"rr\".",
+            "policy", "fifo");
+    parser.addOption(policyOption);
+    QCommandLineOption cpuOption("cpu", "Pin the daemon to the given cpu.",
+            "cpu");
+    parser.addOption(cpuOption);
+    QCommandLineOption lockOption("mlock",
+            "Lock the memory of the daemon to avoid page faults.");
+    parser.addOption(lockOption);
+    QCommandLineOption nullDeviceOption("null-device",
+            "Write the keys to the null device instead of injecting them.");
+    parser.addOption(nullDeviceOption);
+    QCommandLineOption logFileOption("log-file",
+            "Write the log to the given file instead of stderr.", "file");
+    parser.addOption(logFileOption);
+    QCommandLineOption traceOption("trace",
+            "Write a Chrome trace of the commands to the given file.",
+            "file");
+    parser.addOption(traceOption);
+
+    parser.process(app);
+
+    RealtimeConfig realtimeConfig;
+    if (parser.isSet(priorityOption))
+    {
+        bool valid = false;
+        int priority = parser.value(priorityOption).toInt(&valid);
+        if (!valid || priority < 1 || priority > 99)
+        {
+            qWarning("Invalid real-time priority, must be between 1 and 99");
+            return EXIT_FAILURE;
+        }
+        realtimeConfig.setPriority(priority);
+    }
+
+    int policy;
+    if (!RealtimeConfig::parsePolicy(parser.value(policyOption), &policy))
+    {
+        qWarning("Invalid scheduling policy, must be \"fifo\" or \"rr\"");
+        return EXIT_FAILURE;
+    }
+    realtimeConfig.setPolicy(policy);
+
+    if (parser.isSet(cpuOption))
+    {
+        bool valid = false;
+        int cpu = parser.value(cpuOption).toInt(&valid);
+        if (!valid || cpu < 0 || cpu >= CPU_SETSIZE)
+        {
+            qWarning("Invalid cpu, must be between 0 and %d",
+                     CPU_SETSIZE - 1);
+            return EXIT_FAILURE;
+        }
+        realtimeConfig.setCpu(cpu);
+    }
+    realtimeConfig.setLockMemory(parser.isSet(lockOption));
+
+    // Write the log from a background thread, so logging does not delay
+    // the commands
+    FileLogSink* logSink = NULL;
+    if (parser.isSet(logFileOption))
+    {
+        logSink = new FileLogSink(parser.value(logFileOption));
+        if (logSink->open())
+        {
+            FileLogSink::install(logSink, false);
+        }
+        else
+        {
+            qWarning("Could not open log file %s",
+                     qPrintable(parser.value(logFileOption)));
+        }
+    }
+
+    // Continues the traces of the presenter server, if it traces as well
+    Tracer* tracer = NULL;
+    if (parser.isSet(traceOption))
+    {
+        tracer = new Tracer(parser.value(traceOption));
+        if (tracer->open())
+        {
+            Tracer::setInstance(tracer);
+        }
+        else
+        {
+            qWarning("Could not open trace file %s",
+                     qPrintable(parser.value(traceOption)));
+        }
+    }
+
     setShutDownSignal(SIGINT); // shut down on ctrl-c
     setShutDownSignal(SIGTERM); // shut down on killall
 
     // Start the key sender daemon
-    KeySenderDaemon sender;
-    return app.exec();
+    KeySenderDaemon sender(KEYSENDER_PORT, parser.isSet(nullDeviceOption));
+
+    // Everything the commands need is allocated now, so lock it. The log
+    // and trace writers are running, so their threads get the settings too.
+    if (realtimeConfig.isEnabled() && !realtimeConfig.apply())
+    {
+        qWarning("Real-time mode not fully enabled");
+    }
+
+    int result = app.exec();
+
+    delete tracer;
+    delete logSink;
+    return result;
 }
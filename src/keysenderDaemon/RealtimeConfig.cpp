@@ -0,0 +1,201 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * RealtimeConfig.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "RealtimeConfig.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include <QtGlobal>
+
+// The stack size that is touched after locking the memory
+static const int prefaultStackSize = 64 * 1024;
+
+/**
+ * Touches a part of the stack, so the pages are mapped before the first
+ * command needs them.
+ */
+static void prefaultStack()
+{
+    // Volatile writes, so they are not optimized away
+    volatile char stack[prefaultStackSize];
+    for (int i = 0; i < prefaultStackSize; i += 256)
+    {
+        stack[i] = 0;
+    }
+}
+
+/**
+ * Reads the ids of all threads of our process.
+ *
+ * @param threads Filled with the thread ids.
+ * @param maxThreads The size of the array.
+ * @return The number of threads or -1 if they could not be read.
+ */
+static int listThreads(pid_t* threads, int maxThreads)
+{
+    DIR* directory = opendir("/proc/self/task");
+    if (!directory)
+    {
+        return -1;
+    }
+
+    int count = 0;
+    struct dirent* entry = NULL;
+    while ((entry = readdir(directory)) != NULL && count < maxThreads)
+    {
+        if (entry->d_name[0] != '.')
+        {
+            threads[count++] = pid_t(atoi(entry->d_name));
+        }
+    }
+    closedir(directory);
+
+    return count;
+}
+
+RealtimeConfig::RealtimeConfig() :
+    priority(0), policy(SCHED_FIFO), cpu(-1), lockMemory(false)
+{}
+
+void RealtimeConfig::setPriority(int priority)
+{
+    this->priority = priority;
+}
+
+void RealtimeConfig::setPolicy(int policy)
+{
+    this->policy = policy;
+}
+
+void RealtimeConfig::setCpu(int cpu)
+{
+    this->cpu = cpu;
+}
+
+void RealtimeConfig::setLockMemory(bool lockMemory)
+{
+    this->lockMemory = lockMemory;
+}
+
+bool RealtimeConfig::isEnabled() const
+{
+    return priority > 0 || cpu >= 0 || lockMemory;
+}
+
+bool RealtimeConfig::apply() const
+{
+    bool result = true;
+
+    // The scheduling settings are per thread, so they are applied to each
+    // thread of the process. Threads started later inherit them.
+    pid_t threads[64];
+    int threadCount = 0;
+    if (cpu >= 0 || priority > 0)
+    {
+        threadCount = listThreads(threads, sizeof(threads) / sizeof(pid_t));
+        if (threadCount < 0)
+        {
+            qWarning("Could not list threads: %s", strerror(errno));
+            threads[0] = 0;
+            threadCount = 1;
+            result = false;
+        }
+    }
+
+    if (cpu >= CPU_SETSIZE)
+    {
+        qWarning("Could not pin to cpu %d: not supported", cpu);
+        result = false;
+    }
+    else if (cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        for (int i = 0; i < threadCount; i++)
+        {
+            if (sched_setaffinity(threads[i], sizeof(cpus), &cpus) != 0)
+            {
+                qWarning("Could not pin thread %d to cpu %d: %s",
+                         int(threads[i]), cpu, strerror(errno));
+                result = false;
+            }
+        }
+    }
+
+    if (lockMemory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            qWarning("Could not lock memory: %s", strerror(errno));
+            result = false;
+        }
+        else
+        {
+            prefaultStack();
+        }
+    }
+
+    if (priority > 0)
+    {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority;
+        for (int i = 0; i < threadCount; i++)
+        {
+            if (sched_setscheduler(threads[i], policy, &param) != 0)
+            {
+                qWarning("Could not set real-time priority %d of thread "
+                         "%d: %s", priority, int(threads[i]),
+                         strerror(errno));
+                result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool RealtimeConfig::parsePolicy(const QString& name, int* policy)
+{
+    if (name == "fifo")
+    {
+        *policy = SCHED_FIFO;
+        return true;
+    }
+    else if (name == "rr")
+    {
+        *policy = SCHED_RR;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,124 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * RealtimeConfig.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_KEYSENDERDAEMON_REALTIMECONFIG_H_
+#define SRC_KEYSENDERDAEMON_REALTIMECONFIG_H_
+
+#include <QString>
+
+/**
+ * The real-time settings of the key sender daemon. By default, all settings
+ * are disabled and the daemon runs as normal process. The settings usually
+ * need root rights or the CAP_SYS_NICE and CAP_IPC_LOCK capabilities.
+ */
+class RealtimeConfig
+{
+    public:
+        /**
+         * Creates a new config with all settings disabled.
+         */
+        RealtimeConfig();
+
+        /**
+         * Sets the real-time priority.
+         *
+         * @param priority The priority, from 1 to 99. 0 disables the
+         *                 real-time scheduling.
+         */
+        void setPriority(int priority);
+
+        /**
+         * Sets the real-time scheduling policy. Defaults to SCHED_FIFO.
+         *
+         * @param policy SCHED_FIFO or SCHED_RR.
+         */
+        void setPolicy(int policy);
+
+        /**
+         * Pins the threads to a cpu.
+         *
+         * @param cpu The index of the cpu. -1 disables the pinning. Indices
+         *            of CPU_SETSIZE and above are not supported.
+         */
+        void setCpu(int cpu);
+
+        /**
+         * Sets if all current and future memory should be locked, so the
+         * key sender never waits for a page fault.
+         *
+         * @param lockMemory True to lock the memory.
+         */
+        void setLockMemory(bool lockMemory);
+
+        /**
+         * Returns if any of the real-time settings is enabled.
+         *
+         * @return True if a setting is enabled.
+         */
+        bool isEnabled() const;
+
+        /**
+         * Applies the enabled settings to all threads of the process, so it
+         * must be called once all worker threads were started. Threads that
+         * are started later inherit the settings of the thread that starts
+         * them. Each failed setting is logged as warning, the other settings
+         * are still applied.
+         *
+         * @return True if all enabled settings were applied.
+         */
+        bool apply() const;
+
+        /**
+         * Converts the name of a scheduling policy.
+         *
+         * @param name The name, "fifo" or "rr".
+         * @param policy Set to the policy if the name is known.
+         * @return True if the name is known.
+         */
+        static bool parsePolicy(const QString& name, int* policy);
+
+    private:
+        /**
+         * The real-time priority, 0 if disabled.
+         */
+        int priority;
+
+        /**
+         * The real-time scheduling policy.
+         */
+        int policy;
+
+        /**
+         * The cpu to pin to, -1 if disabled.
+         */
+        int cpu;
+
+        /**
+         * If the memory should be locked.
+         */
+        bool lockMemory;
+};
+
+#endif /* SRC_KEYSENDERDAEMON_REALTIMECONFIG_H_ */
@@ -22,10 +22,24 @@
  *  Created on: 14.07.2017
  *      Author: Felix Wohlfrom
  */
+#include <QDir>
 #include <QApplication>
 #include <QMessageBox>
+#include <QSystemTrayIcon>
+#include <QCommandLineParser>
+#include <QStandardPaths>
 
 #include "gui/MainWindow.h"
+#include "diagnostics/FileLogSink.h"
+#include "diagnostics/FlightRecorder.h"
+#include "diagnostics/Metrics.h"
+#include "diagnostics/MetricsServer.h"
+#include "diagnostics/StartupClock.h"
+#include "diagnostics/Tracer.h"
+
+#ifdef __linux__
+    #include "daemon_port.h"
+#endif
 
 #ifdef _DEBUG
     #ifdef _WIN32
@@ -44,6 +58,9 @@
 
 int main(int argc, char *argv[])
 {
+    // The servers report their time to ready relative to this
+    StartupClock::start();
+
     // Enable debug console on win32
     #ifdef _DEBUG
         #ifdef _WIN32
@@ -64,7 +81,118 @@ int main(int argc, char *argv[])
 
     QApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Presenter server");
+    parser.addHelpOption();
+
+    QCommandLineOption trayOption("tray",
+            "Start in the system tray without showing the window.");
+    parser.addOption(trayOption);
+    QCommandLineOption metricsPortOption("metrics-port",
+            "Serve metrics for Prometheus on the given local port.", "port");
+    parser.addOption(metricsPortOption);
+    QCommandLineOption noKeyInjectionOption("no-key-injection",
+            "Handle the commands without injecting keys, e.g. for load "
+            "tests.");
+    parser.addOption(noKeyInjectionOption);
+    QCommandLineOption datagramCommandsOption("datagram-commands",
+            "Also accept commands as udp datagrams. These are accepted from "
+            "any sender on the network without a connection.");
+    parser.addOption(datagramCommandsOption);
+    QCommandLineOption traceOption("trace",
+            "Write a Chrome trace of the command pipeline to the given file. "
+            "Can also be set with the PRESENTER_TRACE environment variable.",
+            "file");
+    parser.addOption(traceOption);
+    parser.process(app);
+
+    // 0 is valid and serves the metrics on any free port
+    bool validMetricsPort = true;
+    quint16 metricsPort = parser.isSet(metricsPortOption)
+            ? parser.value(metricsPortOption).toUShort(&validMetricsPort)
+            : 0;
+    if (!validMetricsPort)
+    {
+        qWarning("Invalid metrics port, must be between 0 and 65535");
+        return EXIT_FAILURE;
+    }
+
+    // Keep a log file for post mortem analysis
+    QString logDir = QStandardPaths::writableLocation(
+            QStandardPaths::AppLocalDataLocation);
+    QDir().mkpath(logDir);
+    FileLogSink logSink(logDir + "/presenter_server.log");
+    if (logSink.open())
+    {
+        FileLogSink::install(&logSink);
+    }
+
+    // Record the last commands, use the flight dump tool to read them
+    FlightRecorder flightRecorder(logDir + "/flight_recorder.bin");
+    if (flightRecorder.open())
+    {
+        FlightRecorder::setInstance(&flightRecorder);
+    }
+    else
+    {
+        qWarning("Could not open flight recorder");
+    }
+
+    // The metrics are only collected if someone scrapes them
+    Metrics metrics;
+    MetricsServer metricsServer(&metrics, metricsPort);
+    if (parser.isSet(metricsPortOption))
+    {
+        #ifdef __linux__
+            metricsServer.setDaemonPort(KEYSENDER_PORT);
+        #endif
+
+        if (metricsServer.open())
+        {
+            Metrics::setInstance(&metrics);
+            qInfo("Serving metrics on http://localhost:%d/metrics",
+                  metricsServer.serverPort());
+        }
+        else
+        {
+            qWarning("Could not serve metrics: %s",
+                     qPrintable(metricsServer.errorString()));
+        }
+    }
+
+    // Tracing is for deep investigations only, so it is opt-in
+    QString traceFile = parser.isSet(traceOption)
+            ? parser.value(traceOption)
+            : QString::fromLocal8Bit(qgetenv("PRESENTER_TRACE"));
+    Tracer tracer(traceFile);
+    if (!traceFile.isEmpty())
+    {
+        if (tracer.open())
+        {
+            Tracer::setInstance(&tracer);
+            qInfo("Tracing the commands to %s", qPrintable(traceFile));
+        }
+        else
+        {
+            qWarning("Could not open trace file %s", qPrintable(traceFile));
+        }
+    }
+
+    // The window is only created if it is shown, so running in the
+    // system tray only saves its memory
     MainWindow window;
-    window.show();
-    return app.exec();
+    window.setKeyInjectionEnabled(!parser.isSet(noKeyInjectionOption));
+    window.setDatagramCommandsEnabled(parser.isSet(datagramCommandsOption));
+    if (!parser.isSet(trayOption)
+        || !QSystemTrayIcon::isSystemTrayAvailable())
+    {
+        window.show();
+    }
+    int result = app.exec();
+
+    metricsServer.close();
+    Tracer::setInstance(NULL);
+    tracer.close();
+    FileLogSink::install(NULL);
+    return result;
 }
@@ -0,0 +1,194 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ClientRegistry.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ClientRegistry.h"
+
+ClientRegistry::ClientRegistry() :
+    nextId(1)
+{
+    clock.start();
+}
+
+ClientRegistry::~ClientRegistry()
+{
+    for (ClientState* block: blocks)
+    {
+        delete[] block;
+    }
+}
+
+ClientState* ClientRegistry::add(QObject* connection, const QString& name)
+{
+    if (freeStates.isEmpty())
+    {
+        ClientState* block = new ClientState[blockSize];
+        blocks.append(block);
+        freeStates.reserve(blocks.size() * blockSize);
+        for (int i = blockSize - 1; i >= 0; i--)
+        {
+            freeStates.append(&block[i]);
+        }
+        clientsById.reserve(blocks.size() * blockSize);
+        clientsByConnection.reserve(blocks.size() * blockSize);
+    }
+
+    ClientState* client = freeStates.takeLast();
+    client->id = nextId++;
+    client->connection = connection;
+    client->name = name;
+    client->messagePart.clear();
+    client->receiveBuffer.resize(0);
+    client->messageBuffer.resize(0);
+    client->fragmented = false;
+    client->pending = false;
+    client->bytesReceived = 0;
+    client->bytesSent = 0;
+    client->messages = 0;
+    client->commands = 0;
+    client->latency.reset();
+    client->viewer = false;
+    client->timeSync = false;
+    client->timeSyncProbe = -1;
+    client->timeSyncTime = 0;
+    client->clockSync.reset();
+    client->lastActivity = now();
+    client->connectedTime = client->lastActivity;
+    client->reportedCommands = 0;
+    client->reportedTime = client->lastActivity;
+
+    // Forget the names if there are too many, e.g. from a load test
+    if (connectionCounts.size() >= maxKnownNames
+        && !connectionCounts.contains(name))
+    {
+        connectionCounts.clear();
+    }
+
+    // Only a name that comes back after its connection closed reconnected
+    QHash<QString, int>::iterator count = connectionCounts.find(name);
+    if (count == connectionCounts.end())
+    {
+        count = connectionCounts.insert(name, 0);
+    }
+    else if (!openConnections.contains(name))
+    {
+        ++*count;
+    }
+    client->reconnects = *count;
+    openConnections[name]++;
+
+    clientsById.insert(client->id, client);
+    clientsByConnection.insert(connection, client);
+
+    return client;
+}
+
+ClientState* ClientRegistry::find(quint32 id) const
+{
+    return clientsById.value(id, NULL);
+}
+
+ClientState* ClientRegistry::find(const QObject* connection) const
+{
+    return clientsByConnection.value(connection, NULL);
+}
+
+void ClientRegistry::remove(ClientState* client)
+{
+    if (!client || !clientsById.remove(client->id))
+    {
+        return;
+    }
+
+    clientsByConnection.remove(client->connection);
+    client->connection = NULL;
+    client->pendingState.clear();
+    freeStates.append(client);
+
+    QHash<QString, int>::iterator open = openConnections.find(client->name);
+    if (open != openConnections.end() && --*open <= 0)
+    {
+        openConnections.erase(open);
+    }
+}
+
+void ClientRegistry::clear()
+{
+    for (ClientState* client: clientsById)
+    {
+        client->connection = NULL;
+        client->pendingState.clear();
+        freeStates.append(client);
+    }
+
+    clientsById.clear();
+    clientsByConnection.clear();
+    openConnections.clear();
+}
+
+int ClientRegistry::size() const
+{
+    return clientsById.size();
+}
+
+qint64 ClientRegistry::now() const
+{
+    return clock.elapsed();
+}
+
+ClientRegistry::const_iterator ClientRegistry::begin() const
+{
+    return clientsById.constBegin();
+}
+
+ClientRegistry::const_iterator ClientRegistry::end() const
+{
+    return clientsById.constEnd();
+}
+
+ClientStatistics ClientRegistry::statistics(ClientState& client)
+{
+    qint64 time = now();
+
+    ClientStatistics statistics;
+    statistics.id = client.id;
+    statistics.name = client.name;
+    statistics.commandsPerSecond = time > client.reportedTime
+            ? (client.commands - client.reportedCommands) * 1000.0
+                / (time - client.reportedTime)
+            : 0;
+    statistics.bytesReceived = client.bytesReceived;
+    statistics.bytesSent = client.bytesSent;
+    statistics.latencyP50 = client.latency.percentile(0.5);
+    statistics.latencyP99 = client.latency.percentile(0.99);
+    statistics.roundTrip = client.clockSync.roundTrip();
+    statistics.clockOffset = client.clockSync.offset();
+    statistics.reconnects = client.reconnects;
+    statistics.idleTime = time - client.lastActivity;
+
+    client.reportedCommands = client.commands;
+    client.reportedTime = time;
+
+    return statistics;
+}
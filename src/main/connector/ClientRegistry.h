@@ -0,0 +1,409 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ClientRegistry.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_CLIENTREGISTRY_H_
+#define SRC_MAIN_CONNECTOR_CLIENTREGISTRY_H_
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QMetaType>
+#include <QElapsedTimer>
+
+#include "ClockSync.h"
+#include "../diagnostics/LatencyHistogram.h"
+
+/**
+ * The state of a connected client.
+ */
+struct ClientState
+{
+    /**
+     * The unique id of the connection.
+     */
+    quint32 id;
+
+    /**
+     * The object that represents the connection, e.g. the socket.
+     */
+    QObject* connection;
+
+    /**
+     * The cached name of the client.
+     */
+    QString name;
+
+    /**
+     * A not completely received message. A message is complete once
+     * two consecutive new line characters are received.
+     */
+    QString messagePart;
+
+    /**
+     * The received, not yet handled bytes of connectors that parse frames.
+     * Its memory is kept with the pooled state, so it is reused by the
+     * next client.
+     */
+    QByteArray receiveBuffer;
+
+    /**
+     * The payload of a fragmented message that is not complete yet.
+     */
+    QByteArray messageBuffer;
+
+    /**
+     * If the first frames of a fragmented message were received.
+     */
+    bool fragmented;
+
+    /**
+     * If the connection did not complete the handshake of its protocol
+     * yet. Pending connections are not counted as clients.
+     */
+    bool pending;
+
+    /**
+     * Time the client connected, see {@link ClientRegistry#now}.
+     */
+    qint64 connectedTime;
+
+    /**
+     * The number of bytes received from the client.
+     */
+    quint64 bytesReceived;
+
+    /**
+     * The number of bytes sent to the client.
+     */
+    quint64 bytesSent;
+
+    /**
+     * The number of complete messages received from the client.
+     */
+    quint64 messages;
+
+    /**
+     * The number of commands received from the client.
+     */
+    quint64 commands;
+
+    /**
+     * The time to handle the commands of the client, including the key
+     * injection.
+     */
+    LatencyHistogram latency;
+
+    /**
+     * How often a client with the same name connected again after its
+     * previous connection was closed.
+     */
+    int reconnects;
+
+    /**
+     * The number of commands at the last statistics snapshot.
+     */
+    quint64 reportedCommands;
+
+    /**
+     * Time of the last statistics snapshot, see {@link ClientRegistry#now}.
+     */
+    qint64 reportedTime;
+
+    /**
+     * If the client subscribed to the slide state, see
+     * {@link SlideStateModel}.
+     */
+    bool viewer;
+
+    /**
+     * The latest slide state that could not be sent yet because the
+     * client did not read the previous one. Empty if nothing is pending.
+     */
+    QByteArray pendingState;
+
+    /**
+     * Time of the last activity, see {@link ClientRegistry#now}.
+     */
+    qint64 lastActivity;
+
+    /**
+     * If the client asked for time synchronization, so it is probed
+     * periodically.
+     */
+    bool timeSync;
+
+    /**
+     * The server time of the probe that was not answered yet, see
+     * {@link ClockSync#now}. -1 if no probe is pending.
+     */
+    qint64 timeSyncProbe;
+
+    /**
+     * The time the last probe was sent, see {@link ClientRegistry#now}.
+     */
+    qint64 timeSyncTime;
+
+    /**
+     * The clock offset and round trip estimate of the client.
+     */
+    ClockSync clockSync;
+};
+
+/**
+ * A snapshot of the statistics of a connected client. Created in the thread
+ * of the connector, so it can be passed to other threads.
+ */
+struct ClientStatistics
+{
+    /**
+     * The unique id of the connection.
+     */
+    quint32 id;
+
+    /**
+     * The name of the connector.
+     */
+    QString connector;
+
+    /**
+     * The name of the client.
+     */
+    QString name;
+
+    /**
+     * The commands per second since the last snapshot.
+     */
+    double commandsPerSecond;
+
+    /**
+     * The number of bytes received from the client.
+     */
+    quint64 bytesReceived;
+
+    /**
+     * The number of bytes sent to the client.
+     */
+    quint64 bytesSent;
+
+    /**
+     * The median time to handle a command in microseconds, -1 if the
+     * client did not send commands yet.
+     */
+    qint64 latencyP50;
+
+    /**
+     * The 99th percentile of the time to handle a command in microseconds,
+     * -1 if the client did not send commands yet.
+     */
+    qint64 latencyP99;
+
+    /**
+     * The network round trip time in microseconds, -1 if the client does
+     * not synchronize its clock.
+     */
+    qint64 roundTrip;
+
+    /**
+     * The offset of the client clock in microseconds.
+     */
+    qint64 clockOffset;
+
+    /**
+     * How often a client with the same name connected again after its
+     * previous connection was closed.
+     */
+    int reconnects;
+
+    /**
+     * The time since the last activity of the client in milliseconds.
+     */
+    qint64 idleTime;
+};
+
+Q_DECLARE_METATYPE(ClientStatistics)
+
+/**
+ * Stores the state of the connected clients of a connector. The states can be
+ * found by connection id or by connection object in constant time. They are
+ * allocated from a pool, so connecting clients does not allocate memory
+ * once the pool has grown to the number of concurrent clients.
+ */
+class ClientRegistry
+{
+    public:
+        /**
+         * Iterator over the states of all clients.
+         */
+        typedef QHash<quint32, ClientState*>::const_iterator const_iterator;
+
+        /**
+         * Creates an empty registry.
+         */
+        ClientRegistry();
+
+        /**
+         * Releases all states and the pool.
+         */
+        ~ClientRegistry();
+
+        /**
+         * Adds a new client.
+         *
+         * @param connection The object that represents the connection.
+         * @param name The name of the client.
+         * @return The state of the new client.
+         */
+        ClientState* add(QObject* connection, const QString& name);
+
+        /**
+         * Finds a client by its connection id.
+         *
+         * @param id The connection id.
+         * @return The state of the client or NULL if not found.
+         */
+        ClientState* find(quint32 id) const;
+
+        /**
+         * Finds a client by its connection object.
+         *
+         * @param connection The object that represents the connection.
+         * @return The state of the client or NULL if not found.
+         */
+        ClientState* find(const QObject* connection) const;
+
+        /**
+         * Removes a client and returns its state to the pool.
+         *
+         * @param client The state of the client.
+         */
+        void remove(ClientState* client);
+
+        /**
+         * Removes all clients. The connection objects are not touched.
+         */
+        void clear();
+
+        /**
+         * Returns the number of clients.
+         *
+         * @return The number of clients.
+         */
+        int size() const;
+
+        /**
+         * Returns the current time of the monotonic clock used for the
+         * activity of the clients.
+         *
+         * @return The time in milliseconds.
+         */
+        qint64 now() const;
+
+        /**
+         * Returns an iterator to the first client.
+         *
+         * @return The iterator.
+         */
+        const_iterator begin() const;
+
+        /**
+         * Returns an iterator behind the last client.
+         *
+         * @return The iterator.
+         */
+        const_iterator end() const;
+
+        /**
+         * Creates a snapshot of the statistics of a client. The command rate
+         * is calculated since the previous snapshot of the client.
+         *
+         * @param client The state of the client.
+         * @return The statistics.
+         */
+        ClientStatistics statistics(ClientState& client);
+
+    private:
+        /**
+         * The number of states that are allocated at once.
+         */
+        static const int blockSize = 64;
+
+        /**
+         * The number of client names that are remembered to count
+         * reconnects.
+         */
+        static const int maxKnownNames = 1024;
+
+        /**
+         * The id of the next connection.
+         */
+        quint32 nextId;
+
+        /**
+         * The clients by connection id.
+         */
+        QHash<quint32, ClientState*> clientsById;
+
+        /**
+         * The clients by connection object.
+         */
+        QHash<const QObject*, ClientState*> clientsByConnection;
+
+        /**
+         * The states that are currently not used.
+         */
+        QVector<ClientState*> freeStates;
+
+        /**
+         * The allocated blocks of states.
+         */
+        QList<ClientState*> blocks;
+
+        /**
+         * The number of reconnects per client name.
+         */
+        QHash<QString, int> connectionCounts;
+
+        /**
+         * The number of open connections per client name. Names are the
+         * peer addresses for most connectors, so several clients behind
+         * the same address are connected at the same time without being
+         * reconnects.
+         */
+        QHash<QString, int> openConnections;
+
+        /**
+         * The monotonic clock for the client activity.
+         */
+        QElapsedTimer clock;
+
+        // The registry owns the states, so it can't be copied
+        ClientRegistry(const ClientRegistry&);
+        ClientRegistry& operator=(const ClientRegistry&);
+};
+
+#endif /* SRC_MAIN_CONNECTOR_CLIENTREGISTRY_H_ */
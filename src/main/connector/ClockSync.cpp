@@ -0,0 +1,109 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ClockSync.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ClockSync.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+
+ClockSync::ClockSync()
+{
+    reset();
+}
+
+void ClockSync::reset()
+{
+    count = 0;
+    best = -1;
+}
+
+bool ClockSync::addSample(qint64 t0, qint64 t1, qint64 t2, qint64 t3)
+{
+    // The client can't answer before it received the request, and the
+    // answer can't arrive before the request was sent
+    qint64 roundTrip = (t3 - t0) - (t2 - t1);
+    if (t2 < t1 || t3 < t0 || roundTrip < 0)
+    {
+        return false;
+    }
+
+    int index = count % window;
+    roundTrips[index] = roundTrip;
+    offsets[index] = ((t1 - t0) + (t2 - t3)) / 2;
+    count++;
+
+    // Choose again if the best exchange was just replaced
+    if (best < 0 || best == index)
+    {
+        best = 0;
+        int filled = count < window ? count : window;
+        for (int i = 1; i < filled; i++)
+        {
+            if (roundTrips[i] < roundTrips[best])
+            {
+                best = i;
+            }
+        }
+    }
+    else if (roundTrip <= roundTrips[best])
+    {
+        best = index;
+    }
+
+    return true;
+}
+
+int ClockSync::samples() const
+{
+    return count;
+}
+
+qint64 ClockSync::roundTrip() const
+{
+    return best < 0 ? -1 : roundTrips[best];
+}
+
+qint64 ClockSync::offset() const
+{
+    return best < 0 ? 0 : offsets[best];
+}
+
+qint64 ClockSync::now()
+{
+    // Initialized once, even if connectors in several threads ask
+    struct Clock
+    {
+        QElapsedTimer timer;
+        qint64 epoch;
+
+        Clock() : epoch(QDateTime::currentMSecsSinceEpoch() * 1000)
+        {
+            timer.start();
+        }
+    };
+    static const Clock clock;
+
+    return clock.epoch + clock.timer.nsecsElapsed() / 1000;
+}
@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ClockSync.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_CLOCKSYNC_H_
+#define SRC_MAIN_CONNECTOR_CLOCKSYNC_H_
+
+#include <QtGlobal>
+
+/**
+ * Estimates the clock offset and the round trip time of a client from NTP
+ * style timestamp exchanges. The server sends its time t0, the client
+ * answers with t0, its receive time t1 and its send time t2, and the server
+ * receives the answer at t3. Of the last exchanges, the one with the
+ * shortest round trip is used, as it was delayed least by queues.
+ */
+class ClockSync
+{
+    public:
+        /**
+         * The number of exchanges the estimate is chosen from.
+         */
+        static const int window = 8;
+
+        /**
+         * Creates an estimate without exchanges.
+         */
+        ClockSync();
+
+        /**
+         * Forgets all exchanges.
+         */
+        void reset();
+
+        /**
+         * Adds an exchange. All times are in microseconds.
+         *
+         * @param t0 The time the server sent the request.
+         * @param t1 The time the client received the request.
+         * @param t2 The time the client sent the answer.
+         * @param t3 The time the server received the answer.
+         * @return False if the exchange is impossible and was ignored.
+         */
+        bool addSample(qint64 t0, qint64 t1, qint64 t2, qint64 t3);
+
+        /**
+         * Returns the number of exchanges that were added.
+         *
+         * @return The number of exchanges.
+         */
+        int samples() const;
+
+        /**
+         * Returns the estimated network round trip time, without the time
+         * the client needed to answer.
+         *
+         * @return The round trip time in microseconds or -1 if unknown.
+         */
+        qint64 roundTrip() const;
+
+        /**
+         * Returns the estimated offset of the client clock. Add it to a
+         * server time to get the client time.
+         *
+         * @return The offset in microseconds, 0 if unknown.
+         */
+        qint64 offset() const;
+
+        /**
+         * Returns the time of the server for the exchanges. It is aligned
+         * to the system clock when first called and then monotonic, so
+         * adjustments of the system clock don't disturb the round trips.
+         *
+         * @return The time in microseconds since the Unix epoch.
+         */
+        static qint64 now();
+
+    private:
+        /**
+         * The round trip times of the last exchanges.
+         */
+        qint64 roundTrips[window];
+
+        /**
+         * The clock offsets of the last exchanges.
+         */
+        qint64 offsets[window];
+
+        /**
+         * The number of exchanges that were added.
+         */
+        int count;
+
+        /**
+         * The index of the exchange with the shortest round trip.
+         */
+        int best;
+};
+
+#endif /* SRC_MAIN_CONNECTOR_CLOCKSYNC_H_ */
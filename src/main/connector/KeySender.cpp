@@ -25,24 +25,63 @@
 
 #include "KeySender.h"
 
+#include "../diagnostics/Tracer.h"
+
 #ifdef _WIN32
     extern "C" {
         #include "key_sender.h"
     }
+
+    #include "../diagnostics/Metrics.h"
+
+    /**
+     * Adds the key events that failed since a given count to the metrics.
+     *
+     * @param previousErrors The number of failed events before sending.
+     */
+    static void countInjectionErrors(unsigned long previousErrors)
+    {
+        Metrics* metrics = Metrics::instance();
+        unsigned long errors = get_send_errors() - previousErrors;
+        if (metrics && errors > 0)
+        {
+            metrics->countInjectionErrors(int(errors));
+        }
+    }
 #endif // _WIN32
 
 #ifdef __linux__
     #include <QHostAddress>
 
+    #include <stdio.h>
+
     #include "daemon_port.h"
 #endif // __linux__
 
-KeySender::KeySender()
+KeySender::KeySender() : KeySender(true)
+{}
+
+KeySender::KeySender(bool connectToSystem) :
+    lastScheduleId(0), schedules(), scheduleTimer(this)
 {
+    // A single timer for all schedules, precise as presenters notice if
+    // an auto-advance is off
+    scheduleTimer.setSingleShot(true);
+    scheduleTimer.setTimerType(Qt::PreciseTimer);
+    connect(&scheduleTimer, SIGNAL(timeout()), this, SLOT(runSchedules()));
+    scheduleClock.start();
+
     #ifdef __linux__
+        socket = NULL;
+        if (!connectToSystem)
+        {
+            return;
+        }
+
         socket = new QTcpSocket(this);
         connect(socket, SIGNAL(error(QAbstractSocket::SocketError)),
                 this, SLOT(socketError(QAbstractSocket::SocketError)));
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readDaemon()));
 
         socket->connectToHost(QHostAddress::LocalHost, KEYSENDER_PORT);
 
@@ -51,62 +90,334 @@ KeySender::KeySender()
             emit error("Could not connect to key sender daemon. "
                     "Make sure it is up and running.");
         }
+    #else
+        Q_UNUSED(connectToSystem);
     #endif // __linux__
 }
 
 KeySender::~KeySender()
 {
     #ifdef __linux__
-        socket->close();
-        delete socket;
+        if (socket)
+        {
+            socket->close();
+            delete socket;
+        }
     #endif // __linux__
 }
 
 void KeySender::sendNext()
 {
+    TraceSpan span("KeySender write");
+
     #ifdef _WIN32
+        unsigned long errors = get_send_errors();
         send_next();
+        countInjectionErrors(errors);
     #endif // _WIN32
 
     #ifdef __linux__
-        socket->write("sendNext\n");
+        sendToDaemon("sendNext");
     #endif // __linux__
 }
 
 void KeySender::sendPrev()
 {
+    TraceSpan span("KeySender write");
+
     #ifdef _WIN32
+        unsigned long errors = get_send_errors();
         send_prev();
+        countInjectionErrors(errors);
     #endif // _WIN32
 
     #ifdef __linux__
-        socket->write("sendPrev\n");
+        sendToDaemon("sendPrev");
     #endif // __linux__
 }
 
 void KeySender::startPresentation()
 {
+    TraceSpan span("KeySender write");
+
     #ifdef _WIN32
+        unsigned long errors = get_send_errors();
         send_start_presentation();
+        countInjectionErrors(errors);
     #endif // _WIN32
 
     #ifdef __linux__
-        socket->write("startPresentation\n");
+        sendToDaemon("startPresentation");
     #endif // __linux__
 }
 
 void KeySender::stopPresentation()
 {
+    TraceSpan span("KeySender write");
+
     #ifdef _WIN32
+        unsigned long errors = get_send_errors();
         send_stop_presentation();
+        countInjectionErrors(errors);
+    #endif // _WIN32
+
+    #ifdef __linux__
+        sendToDaemon("stopPresentation");
+    #endif // __linux__
+}
+
+void KeySender::movePointer(int dx, int dy)
+{
+    #ifdef _WIN32
+        unsigned long errors = get_send_errors();
+        send_pointer_motion(dx, dy);
+        countInjectionErrors(errors);
     #endif // _WIN32
 
     #ifdef __linux__
-        socket->write("stopPresentation\n");
+        // Not traced, moves are too frequent. The daemon combines the moves
+        // that arrive at once.
+        char line[32];
+        int length = snprintf(line, sizeof(line), "move %d %d\n", dx, dy);
+        socket->write(line, length);
+    #endif // __linux__
+}
+
+void KeySender::schedule(Command command, int delay, int interval,
+                         quint32 owner)
+{
+    if (delay < 0 || interval < 0
+        || (interval > 0 && interval < minimumInterval))
+    {
+        emit scheduled(owner, 0);
+        return;
+    }
+
+    Schedule schedule;
+    schedule.id = ++lastScheduleId;
+    schedule.owner = owner;
+    schedule.command = command;
+    schedule.deadline = scheduleClock.nsecsElapsed() / 1000
+            + qint64(delay) * 1000;
+    schedule.interval = qint64(interval) * 1000;
+
+    #ifdef __linux__
+        if (socket)
+        {
+            static const char* const commandNames[] = {
+                "sendNext", "sendPrev", "startPresentation",
+                "stopPresentation"
+            };
+
+            pruneDaemonSchedules();
+            daemonSchedules.insert(schedule.id, schedule);
+
+            // The daemon runs the schedule and enforces the limit, the
+            // answer is signalled once it arrives
+            char line[96];
+            int length = snprintf(line, sizeof(line), "schedule %u %s %d %d\n",
+                                  schedule.id, commandNames[command],
+                                  delay, interval);
+            socket->write(line, length);
+            return;
+        }
+    #endif // __linux__
+
+    if (schedules.size() >= maxSchedules)
+    {
+        emit scheduled(owner, 0);
+        return;
+    }
+
+    schedules.add(schedule);
+    armScheduleTimer();
+    emit scheduled(owner, schedule.id);
+}
+
+void KeySender::cancelSchedule(quint32 id, quint32 owner)
+{
+    #ifdef __linux__
+        if (socket)
+        {
+            QHash<quint32, Schedule>::iterator schedule =
+                    daemonSchedules.find(id);
+            if (schedule == daemonSchedules.end()
+                || schedule->owner != owner)
+            {
+                return;
+            }
+            daemonSchedules.erase(schedule);
+
+            char line[32];
+            int length = snprintf(line, sizeof(line), "cancel %u\n", id);
+            socket->write(line, length);
+            return;
+        }
     #endif // __linux__
+
+    schedules.cancel(id, owner);
+    armScheduleTimer();
+}
+
+void KeySender::cancelSchedules(quint32 owner)
+{
+    #ifdef __linux__
+        if (socket)
+        {
+            QHash<quint32, Schedule>::iterator schedule =
+                    daemonSchedules.begin();
+            while (schedule != daemonSchedules.end())
+            {
+                if (schedule->owner != owner)
+                {
+                    ++schedule;
+                    continue;
+                }
+
+                char line[32];
+                int length = snprintf(line, sizeof(line), "cancel %u\n",
+                                      schedule->id);
+                socket->write(line, length);
+                schedule = daemonSchedules.erase(schedule);
+            }
+            return;
+        }
+    #endif // __linux__
+
+    if (schedules.cancelAll(owner) > 0)
+    {
+        armScheduleTimer();
+    }
+}
+
+void KeySender::cancelSchedules()
+{
+    #ifdef __linux__
+        if (socket)
+        {
+            daemonSchedules.clear();
+            socket->write("cancelAll\n");
+            return;
+        }
+    #endif // __linux__
+
+    schedules.clear();
+    armScheduleTimer();
+}
+
+void KeySender::armScheduleTimer()
+{
+    qint64 deadline = schedules.nextDeadline();
+    if (deadline < 0)
+    {
+        scheduleTimer.stop();
+        return;
+    }
+
+    // Round up, a timer that fires early would just be armed again
+    qint64 remaining = deadline - scheduleClock.nsecsElapsed() / 1000;
+    scheduleTimer.start(int(qMax(qint64(0), (remaining + 999) / 1000)));
+}
+
+void KeySender::runSchedules()
+{
+    Schedule due;
+    while (schedules.takeDue(scheduleClock.nsecsElapsed() / 1000, &due))
+    {
+        switch (due.command)
+        {
+            case NextSlide:
+                sendNext();
+                break;
+
+            case PrevSlide:
+                sendPrev();
+                break;
+
+            case StartPresentation:
+                startPresentation();
+                break;
+
+            case StopPresentation:
+                stopPresentation();
+                break;
+        }
+    }
+
+    armScheduleTimer();
 }
 
 #ifdef __linux__
+    void KeySender::sendToDaemon(const char* command)
+    {
+        // The trace id is a line of its own, so older daemons just ignore
+        // it and still run the command. Both lines are written at once.
+        quint64 traceId = Tracer::currentTrace();
+        Tracer* tracer = Tracer::instance();
+        char line[80];
+        int length;
+        if (tracer && traceId != 0)
+        {
+            tracer->flowStart(traceId);
+            length = snprintf(line, sizeof(line), "trace %llu\n%s\n",
+                              (unsigned long long) traceId, command);
+        }
+        else
+        {
+            length = snprintf(line, sizeof(line), "%s\n", command);
+        }
+
+        socket->write(line, length);
+    }
+
+    void KeySender::readDaemon()
+    {
+        char line[64];
+        while (socket->canReadLine())
+        {
+            socket->readLine(line, sizeof(line));
+
+            quint32 id = 0;
+            bool accepted = sscanf(line, "scheduled %u", &id) == 1;
+            if (!accepted && sscanf(line, "rejected %u", &id) != 1)
+            {
+                continue;
+            }
+
+            // Cancelled schedules were removed, nobody waits for them
+            QHash<quint32, Schedule>::iterator schedule =
+                    daemonSchedules.find(id);
+            if (schedule == daemonSchedules.end())
+            {
+                continue;
+            }
+
+            quint32 owner = quint32(schedule->owner);
+            if (!accepted)
+            {
+                daemonSchedules.erase(schedule);
+            }
+            emit scheduled(owner, accepted ? id : 0);
+        }
+    }
+
+    void KeySender::pruneDaemonSchedules()
+    {
+        qint64 now = scheduleClock.nsecsElapsed() / 1000;
+        QHash<quint32, Schedule>::iterator schedule = daemonSchedules.begin();
+        while (schedule != daemonSchedules.end())
+        {
+            if (schedule->interval == 0 && schedule->deadline <= now)
+            {
+                schedule = daemonSchedules.erase(schedule);
+            }
+            else
+            {
+                ++schedule;
+            }
+        }
+    }
+
     void KeySender::socketError(const QAbstractSocket::SocketError socketError)
     {
         if (socketError == QAbstractSocket::ConnectionRefusedError)
@@ -26,9 +26,14 @@
 #ifndef SRC_MAIN_CONNECTOR_KEYSENDER_H_
 #define SRC_MAIN_CONNECTOR_KEYSENDER_H_
 
+#include <QTimer>
 #include <QObject>
+#include <QElapsedTimer>
+
+#include "ScheduleHeap.h"
 
 #ifdef __linux__
+    #include <QHash>
     #include <QTcpSocket>
 #endif // __linux__
 
@@ -43,6 +48,27 @@ class KeySender: public QObject
     Q_OBJECT
 
     public:
+        /**
+         * The commands that can be scheduled.
+         */
+        enum Command
+        {
+            NextSlide,
+            PrevSlide,
+            StartPresentation,
+            StopPresentation
+        };
+
+        /**
+         * The maximum number of schedules.
+         */
+        static const int maxSchedules = 64;
+
+        /**
+         * The minimum interval of periodic schedules in milliseconds.
+         */
+        static const int minimumInterval = 100;
+
         /**
          * Creates a new keysender instance for the specific platform.
          */
@@ -56,22 +82,80 @@ class KeySender: public QObject
         /**
          * Sends the key to switch to next slide.
          */
-        void sendNext();
+        virtual void sendNext();
 
         /**
          * Sends the key to switch to previous slide.
          */
-        void sendPrev();
+        virtual void sendPrev();
 
         /**
          * Sends the key to start the presentation.
          */
-        void startPresentation();
+        virtual void startPresentation();
 
         /**
          * Sends the key to stop the presentation.
          */
-        void stopPresentation();
+        virtual void stopPresentation();
+
+        /**
+         * Moves the pointer relative to its position. Called at the rate of
+         * the motion of a client, so it must not block or allocate.
+         *
+         * @param dx The horizontal motion in pixels.
+         * @param dy The vertical motion in pixels.
+         */
+        virtual void movePointer(int dx, int dy);
+
+        /**
+         * Schedules a command. Periodic commands run at absolute deadlines
+         * that advance by their interval, so they don't drift. The id of
+         * the schedule is signalled with {@link #scheduled}. On linux, the
+         * key sender daemon runs the schedules, so the id is signalled once
+         * the daemon answered.
+         *
+         * @param command The command.
+         * @param delay The delay until the first run in milliseconds.
+         * @param interval The interval of a periodic command in
+         *                 milliseconds, 0 to run the command once.
+         * @param owner The id of the client that owns the schedule, 0 if
+         *              the client is unknown.
+         */
+        void schedule(Command command, int delay, int interval,
+                      quint32 owner);
+
+        /**
+         * Cancels a schedule. Does nothing if the schedule already ran or
+         * belongs to another client.
+         *
+         * @param id The id of the schedule.
+         * @param owner The id of the client that cancels the schedule.
+         */
+        void cancelSchedule(quint32 id, quint32 owner);
+
+        /**
+         * Cancels all schedules of a client, e.g. once it disconnected.
+         *
+         * @param owner The id of the client.
+         */
+        void cancelSchedules(quint32 owner);
+
+        /**
+         * Cancels all schedules.
+         */
+        void cancelSchedules();
+
+    protected:
+        /**
+         * Creates a key sender. Subclasses that replace the key injection,
+         * e.g. for tests, don't need to connect to the platform specific
+         * implementation.
+         *
+         * @param connectToSystem If the platform specific implementation
+         *                        should be used.
+         */
+        explicit KeySender(bool connectToSystem);
 
         // FIXME: After dropping ubuntu 16.04 support, this can be moved into
         // the #ifdef __linux__ block
@@ -83,6 +167,47 @@ class KeySender: public QObject
              */
             void error(const QString& message);
 
+            /**
+             * Signals the answer to a schedule request.
+             *
+             * @param owner The id of the client that owns the schedule.
+             * @param id The id of the schedule, 0 if it was rejected.
+             */
+            void scheduled(quint32 owner, quint32 id);
+
+    private:
+        /**
+         * The id of the last schedule.
+         */
+        quint32 lastScheduleId;
+
+        /**
+         * The schedules that are run by this key sender.
+         */
+        ScheduleHeap schedules;
+
+        /**
+         * Wakes up at the earliest deadline of the schedules.
+         */
+        QTimer scheduleTimer;
+
+        /**
+         * The monotonic clock of the schedule deadlines.
+         */
+        QElapsedTimer scheduleClock;
+
+        /**
+         * Arms the timer for the earliest deadline or stops it if there
+         * are no schedules.
+         */
+        void armScheduleTimer();
+
+    private slots:
+        /**
+         * Runs the schedules that are due.
+         */
+        void runSchedules();
+
     #ifdef __linux__
         private slots:
             /**
@@ -92,11 +217,39 @@ class KeySender: public QObject
              */
             void socketError(const QAbstractSocket::SocketError socketError);
 
+            /**
+             * Reads the answers of the keysender daemon to the schedule
+             * requests.
+             */
+            void readDaemon();
+
         private:
             /**
-             * The socket that connects to the keysender daemon.
+             * The socket that connects to the keysender daemon. NULL if
+             * the key sender does not connect to the system.
              */
             QTcpSocket* socket;
+
+            /**
+             * The schedules that were sent to the keysender daemon, by
+             * their id. Kept to check the owner of a schedule, schedules
+             * that ran once are removed when the next one is added.
+             */
+            QHash<quint32, Schedule> daemonSchedules;
+
+            /**
+             * Removes the schedules that ran once from
+             * {@link #daemonSchedules}.
+             */
+            void pruneDaemonSchedules();
+
+            /**
+             * Sends a command to the keysender daemon. If the command is
+             * traced, its trace id is sent in a trace line before it.
+             *
+             * @param command The command, e.g. "sendNext".
+             */
+            void sendToDaemon(const char* command);
     #endif // __linux__
 };
 
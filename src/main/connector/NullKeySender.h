@@ -0,0 +1,74 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * NullKeySender.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_NULLKEYSENDER_H_
+#define SRC_MAIN_CONNECTOR_NULLKEYSENDER_H_
+
+#include "KeySender.h"
+
+/**
+ * A key sender that drops all keys. Used to measure the server without
+ * controlling the presentation, e.g. with the load generator.
+ */
+class NullKeySender: public KeySender
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new key sender that does not inject keys.
+         */
+        NullKeySender();
+
+        /**
+         * Drops the "next" key.
+         */
+        void sendNext();
+
+        /**
+         * Drops the "previous" key.
+         */
+        void sendPrev();
+
+        /**
+         * Drops the "start presentation" key.
+         */
+        void startPresentation();
+
+        /**
+         * Drops the "stop presentation" key.
+         */
+        void stopPresentation();
+
+        /**
+         * Drops the pointer move.
+         *
+         * @param dx The horizontal motion.
+         * @param dy The vertical motion.
+         */
+        void movePointer(int dx, int dy);
+};
+
+#endif /* SRC_MAIN_CONNECTOR_NULLKEYSENDER_H_ */
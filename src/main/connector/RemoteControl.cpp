@@ -25,17 +25,46 @@
 
 #include "RemoteControl.h"
 
+#include <QJsonValue>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QElapsedTimer>
 #include <QCoreApplication>
 
+#include <ctype.h>
+#include <limits.h>
+
 #include "../../Version.h"
+#include "../diagnostics/Metrics.h"
+#include "../diagnostics/StallProbe.h"
+#include "../diagnostics/Tracer.h"
+
+// A few updates per second are enough for humans
+const int RemoteControl::statisticsInterval = 500;
 
-RemoteControl::RemoteControl()
+const int RemoteControl::timeSyncInterval = 10000;
+
+RemoteControl::RemoteControl(KeySender* keySender) :
+    keySender(keySender ? keySender : new KeySender()),
+    statisticsTimer(this), currentState(Stopped), unreportedKeys(0)
 {
-    keySender = new KeySender();
-    connect(keySender, SIGNAL(error(QString)),
+    for (int source = 0; source < Metrics::sourceCount; source++)
+    {
+        publishedClients[source] = 0;
+    }
+
+    // Allows to queue the state changes and statistics to other threads
+    qRegisterMetaType<RemoteControl::State>("RemoteControl::State");
+    qRegisterMetaType<QList<ClientStatistics> >("QList<ClientStatistics>");
+
+    connect(&statisticsTimer, SIGNAL(timeout()),
+                        this, SLOT(publishStatistics()));
+
+    this->keySender->setParent(this);
+    connect(this->keySender, SIGNAL(error(QString)),
             this, SLOT(keySenderError(QString)));
+    connect(this->keySender, SIGNAL(scheduled(quint32,quint32)),
+            this, SLOT(scheduleAnswered(quint32,quint32)));
 }
 
 RemoteControl::~RemoteControl()
@@ -43,9 +72,61 @@ RemoteControl::~RemoteControl()
     delete keySender;
 }
 
-void RemoteControl::handleClientConnected(const QString &name)
+RemoteControl::State RemoteControl::state() const
+{
+    return currentState;
+}
+
+void RemoteControl::startServer()
+{
+    if (currentState != Stopped)
+    {
+        return;
+    }
+
+    setState(Starting);
+    if (start())
+    {
+        setState(Running);
+        statisticsTimer.start(statisticsInterval);
+        emit serverReady();
+    }
+    else
+    {
+        stop();
+        setState(Stopped);
+    }
+}
+
+void RemoteControl::stopServer()
+{
+    if (currentState != Stopped)
+    {
+        setState(Stopping);
+        statisticsTimer.stop();
+        keySender->cancelSchedules();
+        stop();
+        setState(Stopped);
+        publishStatistics();
+    }
+
+    emit stopped();
+}
+
+void RemoteControl::setState(State state)
+{
+    if (currentState == state)
+    {
+        return;
+    }
+
+    currentState = state;
+    emit stateChanged(state);
+}
+
+const QString& RemoteControl::versionMessage()
 {
-    write("{ \"type\": \"version\", "
+    static const QString message = QString("{ \"type\": \"version\", "
         "\"data\": '{ "
             "\"minVersion\": \""
                 + QString::number(PRESENTER_PROTOCOL_MIN_VERSION) +
@@ -55,31 +136,163 @@ void RemoteControl::handleClientConnected(const QString &name)
             "\" }'"
         "}\n\n");
 
+    return message;
+}
+
+void RemoteControl::handleClientConnected(const QString &name)
+{
+    write(versionMessage());
+
     emit RemoteControl::clientConnected(name);
 }
 
-void RemoteControl::handleLine(const QString& sender, const QString& line)
+void RemoteControl::handleLine(ClientState& client, const QString& line)
 {
+    TraceSpan span("framing");
+
     if (!line.isEmpty())
     {
-        messagePart = messagePart + line;
+        client.messagePart.append(line);
     }
     else
     {
-        handleMessage(sender, messagePart);
-        messagePart = "";
+        client.messages++;
+        handleMessage(client.name, client.messagePart, &client);
+        client.messagePart.clear();
     }
 }
 
-void RemoteControl::handleMessage(const QString& sender, const QString& message)
+bool RemoteControl::readMotion(QIODevice* device, ClientState& client)
 {
-    emit info(QString("Receive: %1: %2").arg(sender).arg(message));
+    char first = 0;
+    if (device->peek(&first, 1) != 1 || first != motionPrefix)
+    {
+        return false;
+    }
 
-    QJsonDocument document = QJsonDocument::fromJson(message.toUtf8());
+    char line[32];
+    qint64 length = device->readLine(line, sizeof(line));
+    client.bytesReceived += qMax(length, qint64(0));
+
+    // Moves are short, so longer lines are read in pieces and dropped
+    qint64 read = length;
+    while (read > 0 && line[read - 1] != '\n')
+    {
+        read = device->readLine(line, sizeof(line));
+        client.bytesReceived += qMax(read, qint64(0));
+        length = 0;
+    }
+
+    handleMotion(client, line, qMax(length, qint64(0)));
+    return true;
+}
+
+void RemoteControl::handleMotion(ClientState& client, const char* message,
+                                 qint64 length)
+{
+    int dx = 0;
+    int dy = 0;
+    if (!parseMotion(message, length, &dx, &dy))
+    {
+        record(&client, client.name, FlightRecorder::UnknownCommand,
+               FlightRecorder::Ignored);
+        return;
+    }
+
+    client.messages++;
+    keySender->movePointer(dx, dy);
+
+    Metrics* metrics = Metrics::instance();
+    if (metrics)
+    {
+        metrics->countPointerMoves();
+    }
+}
+
+bool RemoteControl::parseMotion(const char* message, qint64 length, int* dx,
+                                int* dy)
+{
+    while (length > 0 && isspace((unsigned char)message[length - 1]))
+    {
+        length--;
+    }
+    if (length == 0 || message[0] != motionPrefix)
+    {
+        return false;
+    }
+
+    // Two signed numbers, separated by a comma
+    int values[2];
+    qint64 position = 1;
+    for (int i = 0; i < 2; i++)
+    {
+        if (i > 0)
+        {
+            if (position >= length || message[position] != ',')
+            {
+                return false;
+            }
+            position++;
+        }
+
+        bool negative = position < length && message[position] == '-';
+        if (negative)
+        {
+            position++;
+        }
+
+        qint64 start = position;
+        int value = 0;
+        while (position < length && isdigit((unsigned char)message[position]))
+        {
+            value = value * 10 + (message[position] - '0');
+            if (value > maxMotion)
+            {
+                return false;
+            }
+            position++;
+        }
+        if (position == start)
+        {
+            return false;
+        }
+
+        values[i] = negative ? -value : value;
+    }
+
+    if (position != length)
+    {
+        return false;
+    }
+
+    *dx = values[0];
+    *dy = values[1];
+    return true;
+}
+
+void RemoteControl::handleMessage(const QString& sender, const QString& message,
+                                  ClientState* client)
+{
+    StallProbe probe("RemoteControl::handleMessage");
+
+    QElapsedTimer latencyTimer;
+    latencyTimer.start();
+
+    QJsonDocument document;
+    {
+        TraceSpan span("decode");
+        document = QJsonDocument::fromJson(message.toUtf8());
+    }
 
     if (document.object()["type"].toString() == tr("command"))
     {
         QString command = document.object()["data"].toString();
+        FlightRecorder::Command recordedCommand =
+                FlightRecorder::command(command);
+        record(client, sender, recordedCommand,
+               recordedCommand == FlightRecorder::UnknownCommand
+                   ? FlightRecorder::Ignored : FlightRecorder::Sent);
+
         if (command == tr("nextSlide"))
         {
             keySender->sendNext();
@@ -97,12 +310,344 @@ void RemoteControl::handleMessage(const QString& sender, const QString& message)
             keySender->stopPresentation();
         }
 
+        // Commands with an id are acknowledged once the key was sent, so
+        // clients can measure the latency
+        QJsonValue id = document.object()["id"];
+        if (client && !id.isUndefined())
+        {
+            QJsonObject ack;
+            ack["type"] = QString("ack");
+            ack["data"] = id;
+            reply(*client, QJsonDocument(ack).toJson(QJsonDocument::Compact)
+                               + "\n\n");
+        }
+
+        qint64 latency = latencyTimer.nsecsElapsed() / 1000;
+        if (client)
+        {
+            client->commands++;
+            client->latency.record(latency);
+        }
+
+        Metrics* metrics = Metrics::instance();
+        if (metrics)
+        {
+            metrics->recordCommandLatency(latency);
+        }
+
         emit keySent(sender, command);
+
+        // The ui only gets a summary, a signal per key would flood it
+        unreportedKeys++;
+        lastKeySender = sender;
+        lastKey = command;
+    }
+    else if (document.object()["type"].toString() == tr("subscribe"))
+    {
+        if (client && !client->viewer
+            && document.object()["data"].toString() == tr("slideState"))
+        {
+            record(client, sender, FlightRecorder::Subscribe,
+                   FlightRecorder::Sent);
+            client->viewer = true;
+            handleSubscribed(*client);
+        }
+        else
+        {
+            record(client, sender, FlightRecorder::Subscribe,
+                   FlightRecorder::Ignored);
+        }
+    }
+    else if (document.object()["type"].toString() == tr("timeSync"))
+    {
+        handleTimeSync(document.object()["data"].toObject(), client);
+    }
+    else if (document.object()["type"].toString() == tr("schedule"))
+    {
+        handleSchedule(sender, document.object()["data"].toObject(), client);
+    }
+    else if (document.object()["type"].toString() == tr("cancel"))
+    {
+        // Only the client that owns a schedule can cancel it
+        QJsonValue id = document.object()["data"];
+        if (client && id.isDouble())
+        {
+            record(client, sender, FlightRecorder::Cancel,
+                   FlightRecorder::Sent);
+            keySender->cancelSchedule(quint32(id.toDouble()), client->id);
+        }
+        else
+        {
+            record(client, sender, FlightRecorder::Cancel,
+                   FlightRecorder::Ignored);
+        }
+    }
+    else
+    {
+        record(client, sender, FlightRecorder::UnknownCommand,
+               FlightRecorder::Ignored);
+    }
+}
+
+void RemoteControl::handleSchedule(const QString& sender,
+                                   const QJsonObject& schedule,
+                                   ClientState* client)
+{
+    KeySender::Command command;
+    switch (FlightRecorder::command(schedule["command"].toString()))
+    {
+        case FlightRecorder::NextSlide:
+            command = KeySender::NextSlide;
+            break;
+        case FlightRecorder::PrevSlide:
+            command = KeySender::PrevSlide;
+            break;
+        case FlightRecorder::StartPresentation:
+            command = KeySender::StartPresentation;
+            break;
+        case FlightRecorder::StopPresentation:
+            command = KeySender::StopPresentation;
+            break;
+        default:
+            record(client, sender, FlightRecorder::Schedule,
+                   FlightRecorder::Ignored);
+            if (client)
+            {
+                replyScheduled(*client, 0);
+            }
+            return;
+    }
+
+    int delay = 0;
+    int interval = 0;
+    if (!toMilliseconds(schedule["delay"], &delay)
+        || !toMilliseconds(schedule["interval"], &interval))
+    {
+        record(client, sender, FlightRecorder::Schedule,
+               FlightRecorder::Ignored);
+        if (client)
+        {
+            replyScheduled(*client, 0);
+        }
+        return;
+    }
+
+    // Answered in scheduleAnswered, on linux once the daemon accepted it
+    keySender->schedule(command, delay, interval, client ? client->id : 0);
+}
+
+void RemoteControl::replyScheduled(ClientState& client, quint32 id)
+{
+    // The id is needed to cancel the schedule, 0 if it was rejected
+    QJsonObject scheduled;
+    scheduled["type"] = QString("scheduled");
+    scheduled["data"] = double(id);
+    reply(client, QJsonDocument(scheduled).toJson(QJsonDocument::Compact)
+                      + "\n\n");
+}
+
+bool RemoteControl::toMilliseconds(const QJsonValue& value,
+                                   int* milliseconds)
+{
+    // A missing value is 0, others must fit into an int before converting
+    if (value.isUndefined())
+    {
+        *milliseconds = 0;
+        return true;
+    }
+
+    if (!value.isDouble() || value.toDouble() < 0
+        || value.toDouble() > INT_MAX)
+    {
+        return false;
+    }
+
+    *milliseconds = int(value.toDouble());
+    return true;
+}
+
+void RemoteControl::removeClient(ClientState* client)
+{
+    if (!client)
+    {
+        return;
+    }
+
+    // Schedules don't outlive their client, its id is not reused
+    keySender->cancelSchedules(client->id);
+    clients.remove(client);
+}
+
+void RemoteControl::handleTimeSync(const QJsonObject& data,
+                                   ClientState* client)
+{
+    qint64 received = ClockSync::now();
+    if (!client)
+    {
+        return;
+    }
+
+    if (!data.contains("t1") || !data.contains("t2"))
+    {
+        client->timeSync = true;
+        sendTimeSync(*client);
+        return;
+    }
+
+    // Only the answer to the pending probe is used, so answers can't be
+    // replayed or made up
+    qint64 probe = qint64(data["t0"].toDouble());
+    qint64 clientReceived = qint64(data["t1"].toDouble());
+    qint64 clientSent = qint64(data["t2"].toDouble());
+    if (probe != client->timeSyncProbe
+        || !client->clockSync.addSample(probe, clientReceived, clientSent,
+                                        received))
+    {
+        return;
+    }
+    client->timeSyncProbe = -1;
+
+    Metrics* metrics = Metrics::instance();
+    if (metrics)
+    {
+        metrics->recordRoundTrip((received - probe)
+                                 - (clientSent - clientReceived));
+    }
+
+    // The client needs the offset to schedule in server time
+    QJsonObject estimate;
+    estimate["offset"] = double(client->clockSync.offset());
+    estimate["roundTrip"] = double(client->clockSync.roundTrip());
+    QJsonObject synced;
+    synced["type"] = QString("timeSynced");
+    synced["data"] = estimate;
+    reply(*client, QJsonDocument(synced).toJson(QJsonDocument::Compact)
+                       + "\n\n");
+}
+
+void RemoteControl::sendTimeSync(ClientState& client)
+{
+    client.timeSyncTime = clients.now();
+    client.timeSyncProbe = ClockSync::now();
+
+    QJsonObject probe;
+    probe["t0"] = double(client.timeSyncProbe);
+    QJsonObject message;
+    message["type"] = QString("timeSync");
+    message["data"] = probe;
+    reply(client, QJsonDocument(message).toJson(QJsonDocument::Compact)
+                      + "\n\n");
+}
+
+void RemoteControl::handleSubscribed(ClientState& client)
+{
+    Q_UNUSED(client);
+}
+
+void RemoteControl::reply(ClientState& client, const QByteArray& message)
+{
+    Q_UNUSED(client);
+    Q_UNUSED(message);
+}
+
+FlightRecorder::Source RemoteControl::source(const ClientState* client) const
+{
+    Q_UNUSED(client);
+
+    return FlightRecorder::UnknownSource;
+}
+
+void RemoteControl::record(const ClientState* client, const QString& sender,
+                           FlightRecorder::Command command,
+                           FlightRecorder::Outcome outcome)
+{
+    FlightRecorder* recorder = FlightRecorder::instance();
+    if (recorder)
+    {
+        recorder->record(source(client), client ? client->id : 0, sender,
+                         command, outcome);
+    }
+
+    Metrics* metrics = Metrics::instance();
+    if (metrics)
+    {
+        if (outcome == FlightRecorder::Failed)
+        {
+            metrics->countInjectionErrors();
+        }
+        else
+        {
+            metrics->countCommand(command, outcome);
+        }
+    }
+}
+
+void RemoteControl::publishStatistics()
+{
+    int connectedClients[Metrics::sourceCount] = {};
+    QList<ClientStatistics> statistics;
+    statistics.reserve(clients.size());
+    for (ClientState* client: clients)
+    {
+        if (client->pending)
+        {
+            continue;
+        }
+
+        // Refresh the clock estimates, unanswered probes are replaced
+        if (client->timeSync
+            && clients.now() - client->timeSyncTime >= timeSyncInterval)
+        {
+            sendTimeSync(*client);
+        }
+
+        FlightRecorder::Source clientSource = source(client);
+        connectedClients[clientSource]++;
+        statistics.append(clients.statistics(*client));
+        statistics.last().connector = FlightRecorder::sourceName(clientSource);
+    }
+
+    // The metrics are shared by all connectors, so only the changes of
+    // this connector are added
+    Metrics* metrics = Metrics::instance();
+    for (int i = 0; i < Metrics::sourceCount; i++)
+    {
+        if (metrics && connectedClients[i] != publishedClients[i])
+        {
+            metrics->addConnectedClients(FlightRecorder::Source(i),
+                                         connectedClients[i]
+                                             - publishedClients[i]);
+            publishedClients[i] = connectedClients[i];
+        }
+    }
+
+    emit statisticsUpdated(statistics);
+
+    if (unreportedKeys > 0)
+    {
+        emit keysSent(unreportedKeys, lastKeySender, lastKey);
+        unreportedKeys = 0;
+    }
+}
+
+void RemoteControl::scheduleAnswered(quint32 owner, quint32 id)
+{
+    // Clients without connection can't be answered
+    ClientState* client = owner ? clients.find(owner) : NULL;
+    record(client, client ? client->name : QString(),
+           FlightRecorder::Schedule,
+           id ? FlightRecorder::Sent : FlightRecorder::Ignored);
+    if (client)
+    {
+        replyScheduled(*client, id);
     }
 }
 
 void RemoteControl::keySenderError(const QString& message)
 {
+    record(NULL, QString(), FlightRecorder::UnknownCommand,
+           FlightRecorder::Failed);
+
     this->stopServer(); // Stop the server if we have errors to avoid confusion
 
     emit error(QString("Key sender error: %1").arg(message));
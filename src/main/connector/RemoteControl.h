@@ -26,10 +26,18 @@
 #ifndef SRC_MAIN_CONNECTOR_REMOTECONTROL_H_
 #define SRC_MAIN_CONNECTOR_REMOTECONTROL_H_
 
+#include <QList>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QTimer>
 #include <QObject>
 #include <QString>
+#include <QIODevice>
 
 #include "KeySender.h"
+#include "ClientRegistry.h"
+#include "../diagnostics/FlightRecorder.h"
+#include "../diagnostics/Metrics.h"
 
 /**
  * Base class for the remote control receiver.
@@ -41,9 +49,26 @@ class RemoteControl: public QObject
 
     public:
         /**
-         * Creates a new remote control.
+         * The lifecycle state of the server.
          */
-        RemoteControl();
+        enum State
+        {
+            Stopped,
+            Starting,
+            Running,
+            Stopping
+        };
+        Q_ENUM(State)
+
+        /**
+         * Creates a new remote control. The key sender becomes a child of
+         * the remote control, so both are moved together to another thread.
+         *
+         * @param keySender The key sender to use. The remote control takes
+         *                  the ownership. If NULL, the key sender of the
+         *                  system will be used.
+         */
+        RemoteControl(KeySender* keySender = NULL);
 
         /**
          * Destroys the remote control.
@@ -51,16 +76,80 @@ class RemoteControl: public QObject
         virtual ~RemoteControl();
 
         /**
-         * Starts a new server.
+         * Returns the current lifecycle state.
+         *
+         * @return The state.
+         */
+        State state() const;
+
+        /**
+         * Returns the version message that is sent to each new client. It
+         * only depends on the protocol versions, so it is created once.
+         *
+         * @return The version message.
+         */
+        static const QString& versionMessage();
+
+        /**
+         * Parses a pointer move message "@<dx>,<dy>", e.g. "@-3,12".
+         * Trailing whitespace is ignored. Doesn't allocate memory, as moves
+         * arrive at the rate of the motion.
+         *
+         * @param message The message, not terminated.
+         * @param length The length of the message.
+         * @param dx Receives the horizontal motion.
+         * @param dy Receives the vertical motion.
+         * @return False if the message is no valid move.
+         */
+        static bool parseMotion(const char* message, qint64 length, int* dx,
+                                int* dy);
+
+        /**
+         * The first character of a pointer move message.
+         */
+        static const char motionPrefix = '@';
+
+        /**
+         * The maximum motion of a single move in each direction.
+         */
+        static const int maxMotion = 4096;
+
+    public slots:
+        /**
+         * Starts a new server. Does nothing if the server is not stopped.
+         * Emits {@link #serverReady} once the server is running. Call it
+         * using a queued connection if the remote control lives in another
+         * thread.
          */
-        virtual void startServer() = 0;
+        void startServer();
 
         /**
-         * Stops the running server.
+         * Stops the running server. Emits {@link #stopped} once done, even if
+         * the server was not running.
          */
-        virtual void stopServer() = 0;
+        void stopServer();
 
     protected:
+        /**
+         * The connected clients. Connectors that handle connections register
+         * them here, so their statistics are published.
+         */
+        ClientRegistry clients;
+
+        /**
+         * Starts the server. Called by {@link #startServer}.
+         *
+         * @return True if the server is ready for connections. If false,
+         *         {@link #stop} is called to release what was started.
+         */
+        virtual bool start() = 0;
+
+        /**
+         * Stops the server and closes all connections. Called by
+         * {@link #stopServer} and must handle a partially started server.
+         */
+        virtual void stop() = 0;
+
         /**
          * Callback method called once a new client connected.
          *
@@ -69,12 +158,90 @@ class RemoteControl: public QObject
         void handleClientConnected(const QString& name);
 
         /**
-         * Callback to handle a complete line read from given sender.
+         * Callback to handle a complete line read from given client.
+         * Lines are collected in the state of the client until the message
+         * is complete.
          *
-         * @param sender The sender that sent the line.
+         * @param client The client that sent the line.
          * @param line The line to handle.
          */
-        void handleLine(const QString& sender, const QString &line);
+        void handleLine(ClientState& client, const QString &line);
+
+        /**
+         * Reads and handles the next line of a client if it is a pointer
+         * move. Call it before reading a line, so moves are not copied.
+         *
+         * @param device The device of the client. Must contain a complete
+         *               line.
+         * @param client The client.
+         * @return True if the line was a move and was read.
+         */
+        bool readMotion(QIODevice* device, ClientState& client);
+
+        /**
+         * Handles a pointer move message, see {@link #parseMotion}. Moves
+         * are not recorded in the flight recorder, there are too many.
+         *
+         * @param client The client that sent the move.
+         * @param message The message, not terminated.
+         * @param length The length of the message.
+         */
+        void handleMotion(ClientState& client, const char* message,
+                          qint64 length);
+
+        /**
+         * Will handle a complete remote protocol message from given sender.
+         *
+         * @param sender The sender that sent the message.
+         * @param message The message to handle.
+         * @param client The state of the client if the message was received
+         *               on a connection, NULL otherwise. Subscriptions and
+         *               acknowledgements are only possible on connections.
+         */
+        void handleMessage(const QString& sender, const QString &message,
+                           ClientState* client = NULL);
+
+        /**
+         * Handles a schedule message. Schedules the command after the delay
+         * and then every interval. The client gets the id of the schedule
+         * once the key sender answered, see {@link #scheduleAnswered}.
+         *
+         * @param sender The sender that sent the message.
+         * @param schedule The data of the message with the command, the
+         *                 delay and the interval in ms.
+         * @param client The state of the client or NULL.
+         */
+        void handleSchedule(const QString& sender, const QJsonObject& schedule,
+                            ClientState* client);
+
+        /**
+         * Handles a time sync message. A message without timestamps starts
+         * the synchronization of the client, an answer to a probe updates
+         * its clock estimate, which is sent back to the client.
+         *
+         * @param data The data of the message.
+         * @param client The state of the client or NULL, only clients on a
+         *               connection can synchronize.
+         */
+        void handleTimeSync(const QJsonObject& data, ClientState* client);
+
+        /**
+         * Called once a client subscribed to the slide state. The default
+         * implementation ignores subscriptions.
+         *
+         * @param client The client that subscribed.
+         */
+        virtual void handleSubscribed(ClientState& client);
+
+        /**
+         * Returns the source that is recorded in the flight recorder for
+         * messages of a given client.
+         *
+         * @param client The client or NULL if the message was not received
+         *               on a connection.
+         * @return The source.
+         */
+        virtual FlightRecorder::Source source(const ClientState* client) const;
 
         /**
          * Write a given message to the connected client.
@@ -83,25 +250,115 @@ class RemoteControl: public QObject
          */
         virtual void write(const QString& message) = 0;
 
+        /**
+         * Sends a message to a single client, e.g. to acknowledge a command.
+         * The default implementation drops the message, for connectors that
+         * can't address single clients.
+         *
+         * @param client The client.
+         * @param message The message to send.
+         */
+        virtual void reply(ClientState& client, const QByteArray& message);
+
+        /**
+         * Removes a disconnected client from {@link #clients} and cancels
+         * its schedules.
+         *
+         * @param client The client, may be NULL.
+         */
+        void removeClient(ClientState* client);
+
     private:
+        /**
+         * The interval in milliseconds in which the client statistics are
+         * published.
+         */
+        static const int statisticsInterval;
+
+        /**
+         * The interval in milliseconds in which the clocks of the clients
+         * are probed.
+         */
+        static const int timeSyncInterval;
+
         /**
          * The key sender.
          */
         KeySender* keySender;
 
         /**
-         * A not completely received message. A message is complete once
-         * two consecutive new line characters are received.
+         * Publishes the client statistics while the server is running.
          */
-        QString messagePart;
+        QTimer statisticsTimer;
 
         /**
-         * Will handle a complete remote protocol message from given sender.
+         * The current lifecycle state.
+         */
+        State currentState;
+
+        /**
+         * The connected clients per source that were added to the metrics.
+         */
+        int publishedClients[Metrics::sourceCount];
+
+        /**
+         * The number of keys sent since the last summary.
+         */
+        int unreportedKeys;
+
+        /**
+         * The client that sent the last key.
+         */
+        QString lastKeySender;
+
+        /**
+         * The last key that has been sent.
+         */
+        QString lastKey;
+
+        /**
+         * Sends a time sync probe with the current server time to a client.
          *
-         * @param sender The sender that sent the message.
-         * @param message The message to handle.
+         * @param client The client.
+         */
+        void sendTimeSync(ClientState& client);
+
+        /**
+         * Changes the lifecycle state and emits {@link #stateChanged}.
+         *
+         * @param state The new state.
          */
-        void handleMessage(const QString& sender, const QString &message);
+        void setState(State state);
+
+        /**
+         * Records a command event in the flight recorder, if one is used.
+         *
+         * @param client The client or NULL if not received on a connection.
+         * @param sender The name of the sender.
+         * @param command The command.
+         * @param outcome The outcome of the command.
+         */
+        void record(const ClientState* client, const QString& sender,
+                    FlightRecorder::Command command,
+                    FlightRecorder::Outcome outcome);
+
+        /**
+         * Sends the answer to a schedule message to a client.
+         *
+         * @param client The client.
+         * @param id The id of the schedule, 0 if it was rejected.
+         */
+        void replyScheduled(ClientState& client, quint32 id);
+
+        /**
+         * Converts a duration of a schedule message.
+         *
+         * @param value The duration in milliseconds, may be undefined.
+         * @param milliseconds Receives the duration, 0 if undefined.
+         * @return False if the value is no number or out of range.
+         */
+        static bool toMilliseconds(const QJsonValue& value,
+                                   int* milliseconds);
 
     signals:
         /**
@@ -123,6 +380,18 @@ class RemoteControl: public QObject
          */
         void serverReady();
 
+        /**
+         * Emitted if the lifecycle state changed.
+         *
+         * @param state The new state.
+         */
+        void stateChanged(RemoteControl::State state);
+
+        /**
+         * Emitted each time {@link #stopServer} completed.
+         */
+        void stopped();
+
         /**
          * Signals that a new client is now connected.
          *
@@ -138,14 +407,41 @@ class RemoteControl: public QObject
         void clientDisconnected();
 
         /**
-         * Signals that a key event has been sent.
+         * Signals that a key event has been sent. Emitted for every key, so
+         * it is meant for receivers that follow the keys, like the slide
+         * state model. Use {@link #keysSent} for logging.
          *
          * @param name The name of the client that sent the key
          * @param key The key that has been sent
          */
         void keySent(const QString &name, const QString &key);
 
+        /**
+         * Summarizes the keys that have been sent since the last summary.
+         * Emitted with the statistics, if keys have been sent.
+         *
+         * @param count The number of keys.
+         * @param name The name of the client that sent the last key.
+         * @param key The last key.
+         */
+        void keysSent(int count, const QString &name, const QString &key);
+
+        /**
+         * Publishes the statistics of the connected clients regularly while
+         * the server is running. An empty list is published once the server
+         * stopped, as all clients were disconnected.
+         *
+         * @param statistics The statistics of all connected clients.
+         */
+        void statisticsUpdated(const QList<ClientStatistics>& statistics);
+
    private slots:
+        /**
+         * Creates a snapshot of the client statistics and publishes it
+         * together with the summary of the sent keys.
+         */
+        void publishStatistics();
+
         /**
          * Handler for errors while using keysender. Will disconnect the
          * server if error is received.
@@ -153,6 +449,15 @@ class RemoteControl: public QObject
          * @param message The error message.
          */
         void keySenderError(const QString &message);
+
+        /**
+         * Replies to a schedule message once the key sender answered it.
+         *
+         * @param owner The id of the client that sent the message, 0 if it
+         *              was not received on a connection.
+         * @param id The id of the schedule, 0 if it was rejected.
+         */
+        void scheduleAnswered(quint32 owner, quint32 id);
 };
 
 #endif /* SRC_MAIN_CONNECTOR_REMOTECONTROL_H_ */
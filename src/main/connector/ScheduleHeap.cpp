@@ -0,0 +1,168 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ScheduleHeap.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ScheduleHeap.h"
+
+#include <utility>
+
+ScheduleHeap::ScheduleHeap() :
+    heap()
+{}
+
+void ScheduleHeap::add(const Schedule& schedule)
+{
+    heap.append(schedule);
+    siftUp(heap.size() - 1);
+}
+
+bool ScheduleHeap::cancel(quint32 id, quintptr owner)
+{
+    // Only a few dozen schedules, so a linear search is fine
+    for (int i = 0; i < heap.size(); i++)
+    {
+        if (heap.at(i).id == id && heap.at(i).owner == owner)
+        {
+            removeAt(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int ScheduleHeap::cancelAll(quintptr owner)
+{
+    int kept = 0;
+    for (int i = 0; i < heap.size(); i++)
+    {
+        if (heap.at(i).owner != owner)
+        {
+            heap[kept++] = heap.at(i);
+        }
+    }
+
+    int removed = heap.size() - kept;
+    heap.resize(kept);
+    reorder();
+
+    return removed;
+}
+
+void ScheduleHeap::clear()
+{
+    heap.clear();
+}
+
+int ScheduleHeap::size() const
+{
+    return heap.size();
+}
+
+qint64 ScheduleHeap::nextDeadline() const
+{
+    return heap.isEmpty() ? -1 : heap.first().deadline;
+}
+
+bool ScheduleHeap::takeDue(qint64 now, Schedule* due)
+{
+    if (heap.isEmpty() || heap.first().deadline > now)
+    {
+        return false;
+    }
+
+    *due = heap.first();
+    if (due->interval <= 0)
+    {
+        removeAt(0);
+        return true;
+    }
+
+    // The next deadline only depends on the first one, not on the time
+    // the schedule actually ran
+    Schedule& next = heap.first();
+    qint64 missed = (now - next.deadline) / next.interval;
+    next.deadline += (missed + 1) * next.interval;
+    siftDown(0);
+
+    return true;
+}
+
+void ScheduleHeap::reorder()
+{
+    for (int index = heap.size() / 2 - 1; index >= 0; index--)
+    {
+        siftDown(index);
+    }
+}
+
+void ScheduleHeap::siftUp(int index)
+{
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (heap.at(parent).deadline <= heap.at(index).deadline)
+        {
+            return;
+        }
+
+        std::swap(heap[parent], heap[index]);
+        index = parent;
+    }
+}
+
+void ScheduleHeap::siftDown(int index)
+{
+    while (true)
+    {
+        int smallest = index;
+        for (int child = 2 * index + 1;
+             child <= 2 * index + 2 && child < heap.size(); child++)
+        {
+            if (heap.at(child).deadline < heap.at(smallest).deadline)
+            {
+                smallest = child;
+            }
+        }
+
+        if (smallest == index)
+        {
+            return;
+        }
+
+        std::swap(heap[smallest], heap[index]);
+        index = smallest;
+    }
+}
+
+void ScheduleHeap::removeAt(int index)
+{
+    heap[index] = heap.last();
+    heap.removeLast();
+    if (index < heap.size())
+    {
+        siftDown(index);
+        siftUp(index);
+    }
+}
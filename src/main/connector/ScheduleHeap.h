@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ScheduleHeap.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_SCHEDULEHEAP_H_
+#define SRC_MAIN_CONNECTOR_SCHEDULEHEAP_H_
+
+#include <QVector>
+
+/**
+ * A scheduled command.
+ */
+struct Schedule
+{
+    /**
+     * The id of the schedule, chosen by the owner of the schedule. Only
+     * unique per owner.
+     */
+    quint32 id;
+
+    /**
+     * The owner of the schedule, e.g. the connection that added it, 0 if
+     * the heap has a single owner.
+     */
+    quintptr owner;
+
+    /**
+     * The command to run, defined by the owner of the heap.
+     */
+    int command;
+
+    /**
+     * The next time to run the command, in microseconds of a monotonic
+     * clock.
+     */
+    qint64 deadline;
+
+    /**
+     * The interval of a periodic command in microseconds, 0 for a command
+     * that runs once.
+     */
+    qint64 interval;
+};
+
+/**
+ * Holds scheduled commands in a binary heap ordered by their deadline, so
+ * any number of schedules needs a single timer that is armed for the
+ * earliest deadline. Periodic schedules advance their absolute deadline by
+ * their interval, so late wakeups don't accumulate drift.
+ */
+class ScheduleHeap
+{
+    public:
+        /**
+         * Creates an empty heap.
+         */
+        ScheduleHeap();
+
+        /**
+         * Adds a schedule.
+         *
+         * @param schedule The schedule. Its id must not be in the heap.
+         */
+        void add(const Schedule& schedule);
+
+        /**
+         * Removes a schedule.
+         *
+         * @param id The id of the schedule.
+         * @param owner The owner of the schedule.
+         * @return False if the owner has no schedule with this id, e.g.
+         *         because it already ran once.
+         */
+        bool cancel(quint32 id, quintptr owner = 0);
+
+        /**
+         * Removes all schedules of an owner.
+         *
+         * @param owner The owner of the schedules.
+         * @return The number of removed schedules.
+         */
+        int cancelAll(quintptr owner);
+
+        /**
+         * Removes all schedules.
+         */
+        void clear();
+
+        /**
+         * Returns the number of schedules.
+         *
+         * @return The number of schedules.
+         */
+        int size() const;
+
+        /**
+         * Returns the earliest deadline.
+         *
+         * @return The deadline or -1 if the heap is empty.
+         */
+        qint64 nextDeadline() const;
+
+        /**
+         * Takes the next schedule that is due. A periodic schedule stays in
+         * the heap with its next deadline. Periods that were missed
+         * completely, e.g. while the system was suspended, are skipped, so
+         * they don't run in a burst.
+         *
+         * @param now The current time.
+         * @param due Receives the due schedule with the deadline it was due
+         *            at.
+         * @return False if no schedule is due.
+         */
+        bool takeDue(qint64 now, Schedule* due);
+
+    private:
+        /**
+         * The schedules, the earliest deadline first.
+         */
+        QVector<Schedule> heap;
+
+        /**
+         * Restores the heap order after schedules were removed from the
+         * middle.
+         */
+        void reorder();
+
+        /**
+         * Moves a schedule towards the root until the heap is ordered.
+         *
+         * @param index The index of the schedule.
+         */
+        void siftUp(int index);
+
+        /**
+         * Moves a schedule towards the leaves until the heap is ordered.
+         *
+         * @param index The index of the schedule.
+         */
+        void siftDown(int index);
+
+        /**
+         * Removes the schedule at an index.
+         *
+         * @param index The index of the schedule.
+         */
+        void removeAt(int index);
+};
+
+#endif /* SRC_MAIN_CONNECTOR_SCHEDULEHEAP_H_ */
@@ -0,0 +1,108 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SlideStateModel.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "SlideStateModel.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+
+SlideStateModel::SlideStateModel(QObject* parent) :
+    QObject(parent), currentSlide(0), presenting(false), currentEvent()
+{
+    update();
+}
+
+int SlideStateModel::slide() const
+{
+    return currentSlide;
+}
+
+bool SlideStateModel::isPresenting() const
+{
+    return presenting;
+}
+
+QByteArray SlideStateModel::event() const
+{
+    return currentEvent;
+}
+
+void SlideStateModel::publish()
+{
+    emit stateChanged(currentEvent);
+}
+
+void SlideStateModel::keySent(const QString& sender, const QString& key)
+{
+    Q_UNUSED(sender);
+
+    if (key == "nextSlide")
+    {
+        currentSlide++;
+    }
+    else if (key == "prevSlide")
+    {
+        if (currentSlide == 0)
+        {
+            return;
+        }
+        currentSlide--;
+    }
+    else if (key == "startPresentation")
+    {
+        presenting = true;
+        currentSlide = 0;
+    }
+    else if (key == "stopPresentation")
+    {
+        if (!presenting)
+        {
+            return;
+        }
+        presenting = false;
+    }
+    else
+    {
+        return;
+    }
+
+    update();
+    emit stateChanged(currentEvent);
+}
+
+void SlideStateModel::update()
+{
+    QJsonObject state;
+    state["slide"] = currentSlide;
+    state["presenting"] = presenting;
+
+    QJsonObject message;
+    message["type"] = QString("slideState");
+    message["data"] = QString::fromUtf8(
+            QJsonDocument(state).toJson(QJsonDocument::Compact));
+
+    currentEvent = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    currentEvent.append("\n\n");
+}
@@ -0,0 +1,117 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SlideStateModel.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_SLIDESTATEMODEL_H_
+#define SRC_MAIN_CONNECTOR_SLIDESTATEMODEL_H_
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * Keeps track of the current slide position, based on the keys that were
+ * sent by the remote controls. Each change is encoded once into an event
+ * message, which can be shared by all viewers that follow the presentation.
+ */
+class SlideStateModel: public QObject
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new model. The presentation is not running and the
+         * first slide is shown.
+         *
+         * @param parent The parent object.
+         */
+        SlideStateModel(QObject* parent = 0);
+
+        /**
+         * Returns the index of the current slide, starting at 0.
+         *
+         * @return The current slide.
+         */
+        int slide() const;
+
+        /**
+         * Returns if the presentation is currently running.
+         *
+         * @return True if the presentation is running.
+         */
+        bool isPresenting() const;
+
+        /**
+         * Returns the encoded event message for the current state.
+         *
+         * @return The encoded message, including the message terminator.
+         */
+        QByteArray event() const;
+
+    public slots:
+        /**
+         * Emits the current state, e.g. for receivers that were connected
+         * after the model was created.
+         */
+        void publish();
+
+        /**
+         * Updates the state for a key that has been sent.
+         *
+         * @param sender The name of the client that sent the key.
+         * @param key The key that has been sent.
+         */
+        void keySent(const QString& sender, const QString& key);
+
+    signals:
+        /**
+         * Emitted once the state changed.
+         *
+         * @param event The encoded event message, shared by all receivers.
+         */
+        void stateChanged(const QByteArray& event);
+
+    private:
+        /**
+         * The index of the current slide.
+         */
+        int currentSlide;
+
+        /**
+         * If the presentation is running.
+         */
+        bool presenting;
+
+        /**
+         * The encoded event of the current state.
+         */
+        QByteArray currentEvent;
+
+        /**
+         * Encodes the current state and notifies the viewers.
+         */
+        void update();
+};
+
+#endif /* SRC_MAIN_CONNECTOR_SLIDESTATEMODEL_H_ */
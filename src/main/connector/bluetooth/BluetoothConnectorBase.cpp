@@ -35,3 +35,15 @@ const QString BluetoothConnectorBase::serviceDescription
     = "A presenter service to remote control presentations from mobile devices";
 const QString BluetoothConnectorBase::serviceProvider
     = "Felix Wohlfrom";
+
+BluetoothConnectorBase::BluetoothConnectorBase(KeySender* keySender) :
+    RemoteControl(keySender)
+{}
+
+FlightRecorder::Source BluetoothConnectorBase::source(
+        const ClientState* client) const
+{
+    Q_UNUSED(client);
+
+    return FlightRecorder::Bluetooth;
+}
@@ -41,6 +41,22 @@ class BluetoothConnectorBase: public RemoteControl
     Q_OBJECT
 
     protected:
+        /**
+         * Creates a new bluetooth connector.
+         *
+         * @param keySender The key sender to use. If NULL, the key sender of
+         *                  the system will be used.
+         */
+        BluetoothConnectorBase(KeySender* keySender);
+
+        /**
+         * Returns the source that is recorded in the flight recorder.
+         *
+         * @param client The client, unused.
+         * @return The bluetooth source.
+         */
+        FlightRecorder::Source source(const ClientState* client) const;
+
         static const QString serviceUuid;
         static const QString serviceName;
         static const QString serviceDescription;
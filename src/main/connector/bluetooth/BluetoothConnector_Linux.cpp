@@ -28,8 +28,11 @@
 #include <qbluetoothlocaldevice.h>
 #include <qbluetoothaddress.h>
 
-BluetoothConnector::BluetoothConnector() :
-    rfcommServer(NULL), serviceInfo(), clientSockets()
+#include "../../diagnostics/StallProbe.h"
+#include "../../diagnostics/Tracer.h"
+
+BluetoothConnector::BluetoothConnector(KeySender* keySender) :
+    BluetoothConnectorBase(keySender), rfcommServer(NULL), serviceInfo()
 {}
 
 BluetoothConnector::~BluetoothConnector()
@@ -37,15 +40,10 @@ BluetoothConnector::~BluetoothConnector()
     stopServer();
 }
 
-void BluetoothConnector::startServer()
+bool BluetoothConnector::start()
 {
     QBluetoothAddress localAdapter = QBluetoothAddress();
 
-    if (rfcommServer)
-    {
-        return;
-    }
-
     rfcommServer =
             new QBluetoothServer(QBluetoothServiceInfo::RfcommProtocol, this);
 
@@ -60,7 +58,7 @@ void BluetoothConnector::startServer()
                 .arg(localAdapter.toString()));
         emit error(tr("Make sure that bluetooth is available on your system "
                 "and enabled."));
-        return;
+        return false;
     }
 
     QBluetoothServiceInfo::Sequence classId;
@@ -98,16 +96,22 @@ void BluetoothConnector::startServer()
     serviceInfo.registerService(localAdapter);
 
     emit info(tr("Server ready and waiting for connections"));
-    emit serverReady();
+    return true;
 }
 
-void BluetoothConnector::stopServer()
+void BluetoothConnector::stop()
 {
     // Unregister service
     serviceInfo.unregisterService();
 
-    // Close sockets
-    qDeleteAll(clientSockets);
+    // Close sockets. Disconnect them first, so closing them does not call
+    // our slots for clients that are already removed.
+    for (ClientState* client: clients)
+    {
+        client->connection->disconnect(this);
+        delete client->connection;
+    }
+    clients.clear();
 
     // Close server
     delete rfcommServer;
@@ -116,6 +120,8 @@ void BluetoothConnector::stopServer()
 
 void BluetoothConnector::clientConnected()
 {
+    StallProbe probe("BluetoothConnector::clientConnected");
+
     QBluetoothSocket *socket = rfcommServer->nextPendingConnection();
     if (!socket)
     {
@@ -124,13 +130,17 @@ void BluetoothConnector::clientConnected()
 
     connect(socket, SIGNAL(readyRead()), this, SLOT(readSocket()));
     connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
-    clientSockets.append(socket);
 
-    handleClientConnected(socket->peerName());
+    // Resolving the peer name is expensive, so only do it once
+    ClientState* client = clients.add(socket, socket->peerName());
+
+    handleClientConnected(client->name);
 }
 
 void BluetoothConnector::clientDisconnected()
 {
+    StallProbe probe("BluetoothConnector::clientDisconnected");
+
     QBluetoothSocket *socket = qobject_cast<QBluetoothSocket *>(sender());
     if (!socket)
     {
@@ -139,33 +149,53 @@ void BluetoothConnector::clientDisconnected()
 
     emit RemoteControl::clientDisconnected();
 
-    clientSockets.removeOne(socket);
+    removeClient(clients.find(socket));
     socket->deleteLater();
 }
 
 void BluetoothConnector::readSocket()
 {
+    StallProbe probe("BluetoothConnector::readSocket");
+
     QBluetoothSocket *socket = qobject_cast<QBluetoothSocket *>(sender());
     if (!socket)
     {
         return;
     }
 
+    ClientState* client = clients.find(socket);
+    if (!client)
+    {
+        return;
+    }
+
+    Tracer::beginTrace();
+    TraceSpan span("socket read");
+
+    client->lastActivity = clients.now();
     while (socket->canReadLine())
     {
-        QByteArray line = socket->readLine().trimmed();
-        handleLine(socket->peerName(),
-                  QString::fromUtf8(line.constData(), line.length()));
+        if (readMotion(socket, *client))
+        {
+            continue;
+        }
+
+        QByteArray line = socket->readLine();
+        client->bytesReceived += line.length();
+        line = line.trimmed();
+        handleLine(*client,
+                   QString::fromUtf8(line.constData(), line.length()));
     }
 }
 
 void BluetoothConnector::write(const QString& message)
 {
-    emit info(QString("Write: %1").arg(message));
-
-    for (QBluetoothSocket* socket: clientSockets)
+    const QByteArray bytes(message.toUtf8());
+    for (ClientState* client: clients)
     {
-        QByteArray messageToSend(message.toUtf8());
+        QBluetoothSocket* socket =
+                static_cast<QBluetoothSocket*>(client->connection);
+        QByteArray messageToSend(bytes);
         int bytesSent = 0;
         while (bytesSent < messageToSend.length())
         {
@@ -173,5 +203,13 @@ void BluetoothConnector::write(const QString& message)
             messageToSend = messageToSend.mid(sent);
             bytesSent += sent;
         }
+        client->bytesSent += bytesSent;
     }
 }
+
+void BluetoothConnector::reply(ClientState& client, const QByteArray& message)
+{
+    QBluetoothSocket* socket =
+            static_cast<QBluetoothSocket*>(client.connection);
+    client.bytesSent += socket->write(message);
+}
@@ -46,8 +46,11 @@ class BluetoothConnector: public BluetoothConnectorBase
     public:
         /**
          * Create a new bluetooth connector.
+         *
+         * @param keySender The key sender to use. If NULL, the key sender of
+         *                  the system will be used.
          */
-        BluetoothConnector();
+        BluetoothConnector(KeySender* keySender = NULL);
 
         /**
          * Deletes the bluetooth connector.
@@ -55,15 +58,18 @@ class BluetoothConnector: public BluetoothConnectorBase
          */
         ~BluetoothConnector();
 
+    protected:
         /**
-         * Starts a new server.
+         * Starts the server.
+         *
+         * @return True if the server is ready for connections.
          */
-        void startServer();
+        bool start();
 
         /**
-         * Stops the running server.
+         * Stops the server and closes all connections.
          */
-        void stopServer();
+        void stop();
 
     private slots:
         /**
@@ -92,17 +98,20 @@ class BluetoothConnector: public BluetoothConnectorBase
          */
         QBluetoothServiceInfo serviceInfo;
 
-        /**
-         * The connected clients.
-         */
-        QList<QBluetoothSocket*> clientSockets;
-
         /**
          * Write a given message to the connected client.
          *
          * @param message The message to write.
          */
         void write(const QString& message);
+
+        /**
+         * Sends a message to a single client.
+         *
+         * @param client The client.
+         * @param message The message to send.
+         */
+        void reply(ClientState& client, const QByteArray& message);
 };
 
 #endif /* SRC_MAIN_CONNECTOR_BLUETOOTH_BLUETOOTHCONNECTOR_LINUX_H_ */
@@ -28,6 +28,9 @@
 #include <QSettings>
 #include <QCoreApplication>
 
+#include "../../diagnostics/StallProbe.h"
+#include "../../diagnostics/Tracer.h"
+
 #include <initguid.h>
 #include <ws2bth.h>
 
@@ -39,9 +42,9 @@ DEFINE_GUID(serviceGuid, 0xbe71c255, 0x8349, 0x4d86, 0xb0, 0x9e,
 // We just need a small buffer since we just receive really short commands
 #define READ_BUFFER_SIZE 20
 
-BluetoothConnector::BluetoothConnector():
-        serverSocket(INVALID_SOCKET), socketInfo(NULL), instanceName(NULL),
-        readerThread(NULL)
+BluetoothConnector::BluetoothConnector(KeySender* keySender):
+        BluetoothConnectorBase(keySender), serverSocket(INVALID_SOCKET),
+        socketInfo(NULL), instanceName(NULL), readerThread(NULL)
 {}
 
 BluetoothConnector::~BluetoothConnector()
@@ -49,14 +52,14 @@ BluetoothConnector::~BluetoothConnector()
     stopServer();
 }
 
-void BluetoothConnector::startServer()
+bool BluetoothConnector::start()
 {
     // Check for Winsock version 2.2.
     WSADATA WSAData = { 0 };
     int status = WSAStartup(MAKEWORD(2, 2), &WSAData);
     if (status != 0) {
         emit error(QString("Unable to initialize Winsock version 2.2\n"));
-        return;
+        return false;
     }
 
     // Read computer name for later exposion in service
@@ -66,7 +69,7 @@ void BluetoothConnector::startServer()
     {
         emit error(QString("Failed to read computer name. %1\n")
                 .arg(getLastWSAError()));
-        return;
+        return false;
     }
 
     // Open a bluetooth socket using RFCOMM protocol
@@ -77,7 +80,7 @@ void BluetoothConnector::startServer()
                 .arg(getLastWSAError()));
         emit error(tr("Make sure that bluetooth is available on your system "
                 "and enabled."));
-        return;
+        return false;
     }
 
     // Setting address family to AF_BTH indicates winsock2 to use bluetooth port
@@ -93,7 +96,7 @@ void BluetoothConnector::startServer()
                 .arg((ULONG64)serverSocket, 16).arg(getLastWSAError()));
         emit error(tr("Make sure that bluetooth is available on your system "
                 "and enabled."));
-        return;
+        return false;
     }
 
     int addrLength = sizeof(SOCKADDR_BTH);
@@ -102,7 +105,7 @@ void BluetoothConnector::startServer()
     {
         emit error(QString("Could not get socket name of socket 0x%1. %2\n")
                 .arg((ULONG64)serverSocket, 16).arg(getLastWSAError()));
-        return;
+        return false;
     }
 
     // Allocate space for our service socket info
@@ -112,7 +115,7 @@ void BluetoothConnector::startServer()
     if (socketInfo == NULL)
     {
         emit error("Unable to allocate memory for CSADDR_INFO\n");
-        return;
+        return false;
     }
 
     // CSADDR_INFO
@@ -138,7 +141,7 @@ void BluetoothConnector::startServer()
     if (FAILED(res))
     {
         emit error(QString("ComputerName specified is too large\n"));
-        return;
+        return false;
     }
     instanceNameSize += sizeof(serviceName) + 1;
 
@@ -148,7 +151,7 @@ void BluetoothConnector::startServer()
     if (instanceName == NULL)
     {
         emit error(QString("Out of memory. %1\n").arg(GetLastError()));
-        return;
+        return false;
     }
 
     StringCbPrintfW(instanceName, instanceNameSize, L"%s %s",
@@ -169,7 +172,7 @@ void BluetoothConnector::startServer()
     {
         emit error(QString("Could not register bluetooth service: %1\n")
                 .arg(getLastWSAError()));
-        return;
+        return false;
     }
 
     // wait for incoming connections
@@ -178,7 +181,7 @@ void BluetoothConnector::startServer()
         emit error(QString("Wait for incoming connections failed on socket "
                 "0x%1. %2\n")
                     .arg((ULONG64)serverSocket, 16).arg(getLastWSAError()));
-        return;
+        return false;
     }
 
     // Start the reader thread
@@ -196,10 +199,10 @@ void BluetoothConnector::startServer()
     readerThread->start();
 
     emit info(tr("Server ready and waiting for connections"));
-    emit serverReady();
+    return true;
 }
 
-void BluetoothConnector::stopServer()
+void BluetoothConnector::stop()
 {
     // Close server socket. Needs to be done before killing reader thread
     // to make sure all blocking calls are closed
@@ -216,6 +219,7 @@ void BluetoothConnector::stopServer()
         delete(readerThread);
         readerThread = NULL;
     }
+    clients.clear();
 
     if (socketInfo != NULL)
     {
@@ -248,8 +252,6 @@ QString BluetoothConnector::getLastWSAError()
 
 void BluetoothConnector::write(const QString& message)
 {
-    emit info(QString("Write: %1").arg(message));
-
     QByteArray bytes = message.toUtf8();
 
     int lengthWritten = 0;
@@ -277,6 +279,12 @@ void BluetoothConnector::write(const QString& message)
             lengthWritten += length;
         }
     }
+
+    ClientState* client = clients.find(readerThread);
+    if (client)
+    {
+        client->bytesSent += lengthWritten;
+    }
 }
 
 void BluetoothConnector::errorThread(const QString &error)
@@ -286,17 +294,49 @@ void BluetoothConnector::errorThread(const QString &error)
 
 void BluetoothConnector::clientConnectedThread(const QString &name)
 {
+    StallProbe probe("BluetoothConnector::clientConnectedThread");
+
+    clients.add(readerThread, name);
+
     handleClientConnected(name);
 }
 
 void BluetoothConnector::clientDisconnectedThread()
 {
+    StallProbe probe("BluetoothConnector::clientDisconnectedThread");
+
+    removeClient(clients.find(readerThread));
+
     emit RemoteControl::clientDisconnected();
 }
 
 void BluetoothConnector::lineReceived(const QString &name, const QString &line)
 {
-    handleLine(name, line);
+    StallProbe probe("BluetoothConnector::lineReceived");
+
+    // The reader thread read the line, the span covers handling it
+    Tracer::beginTrace();
+    TraceSpan span("socket read");
+
+    ClientState* client = clients.find(readerThread);
+    if (!client)
+    {
+        client = clients.add(readerThread, name);
+    }
+
+    client->lastActivity = clients.now();
+    client->bytesReceived += line.length() + 1;
+
+    // The reader thread already copied the line, but moves still skip the
+    // message decoding
+    if (line.startsWith(QChar(motionPrefix)))
+    {
+        QByteArray motion = line.toLatin1();
+        handleMotion(*client, motion.constData(), motion.length());
+        return;
+    }
+
+    handleLine(*client, line);
 }
 
 BluetoothReaderThread::BluetoothReaderThread(const SOCKET serverSocket) :
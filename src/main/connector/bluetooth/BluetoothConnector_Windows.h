@@ -126,8 +126,11 @@ class BluetoothConnector: public BluetoothConnectorBase
     public:
         /**
          * Creates a new bluetooth connector server.
+         *
+         * @param keySender The key sender to use. If NULL, the key sender of
+         *                  the system will be used.
          */
-        BluetoothConnector();
+        BluetoothConnector(KeySender* keySender = NULL);
 
         /**
          * Deletes the bluetooth connector.
@@ -136,22 +139,25 @@ class BluetoothConnector: public BluetoothConnectorBase
         ~BluetoothConnector();
 
         /**
-         * Starts a new server.
+         * Reads the error returned by WSAGetLastError() and returns the
+         * message string for the error code.
+         *
+         * @return The message string from WSAGetLastError()
          */
-        void startServer();
+        static QString getLastWSAError();
 
+    protected:
         /**
-         * Stops the running server.
+         * Starts the server.
+         *
+         * @return True if the server is ready for connections.
          */
-        void stopServer();
+        bool start();
 
         /**
-         * Reads the error returned by WSAGetLastError() and returns the
-         * message string for the error code.
-         *
-         * @return The message string from WSAGetLastError()
+         * Stops the server and closes all connections.
          */
-        static QString getLastWSAError();
+        void stop();
 
     private:
         /**
@@ -27,7 +27,28 @@
 
 #ifdef _WIN32
     #include <windows.h>
+#endif // _WIN32
+
+/**
+ * The number of key events that could not be injected.
+ */
+static volatile long send_errors = 0;
+
+/**
+ * Counts a key event that could not be injected. On Windows, the key
+ * senders of the connectors inject from their own threads, so the counter
+ * is incremented atomically.
+ */
+static void count_send_error(void)
+{
+    #ifdef _WIN32
+        InterlockedIncrement(&send_errors);
+    #else
+        __sync_fetch_and_add(&send_errors, 1);
+    #endif // _WIN32
+}
 
+#ifdef _WIN32
     /**
      * Will send a given key to the system
      *
@@ -48,11 +69,17 @@
         // Press the given key
         ip.ki.wVk = key;
         ip.ki.dwFlags = 0; // 0 for key press
-        SendInput(1, &ip, sizeof(INPUT));
+        if (SendInput(1, &ip, sizeof(INPUT)) != 1)
+        {
+            count_send_error();
+        }
 
         // Release the given key
         ip.ki.dwFlags = KEYEVENTF_KEYUP; // KEYEVENTF_KEYUP for key release
-        SendInput(1, &ip, sizeof(INPUT));
+        if (SendInput(1, &ip, sizeof(INPUT)) != 1)
+        {
+            count_send_error();
+        }
     }
 #endif // _WIN32
 
@@ -73,38 +100,118 @@
     int fdo;
 
     /**
-     * Will write a given event to a given device.
+     * If the events are written to the null device instead of uinput.
+     */
+    static int null_device = 0;
+
+    /**
+     * The events of a key press and release. Allocated once, so sending a
+     * key does not allocate memory or touch new pages.
+     */
+    static struct input_event key_events[4];
+
+    /**
+     * The file descriptor of the pointer device.
+     */
+    static int fdp = -1;
+
+    /**
+     * The events of a pointer motion, allocated once like the key events.
+     */
+    static struct input_event pointer_events[3];
+
+    /**
+     * Will set a given event.
      *
-     * @param fd The file descriptor of the device to write to
+     * @param ie The event to set
      * @param type The event type to send
      * @param code The event code to use
      * @param val The value to send
      */
-    void send_event(int fd, int type, int code, int val)
+    void set_event(struct input_event* ie, int type, int code, int val)
     {
-        struct input_event ie;
-
-        ie.type = type;
-        ie.code = code;
-        ie.value = val;
+        ie->type = type;
+        ie->code = code;
+        ie->value = val;
 
-        ie.time.tv_sec = 0;
-        ie.time.tv_usec = 0;
-
-        write(fd, &ie, sizeof(ie));
+        ie->time.tv_sec = 0;
+        ie->time.tv_usec = 0;
     }
 
     /**
-     * Will send a given key to the system
+     * Will send a given key to the system. Press, release and the
+     * synchronization events are written at once.
      *
      * @param key The key id to emit
      */
     void send_key(int key)
     {
-        send_event(fdo, EV_KEY, key, 1);
-        send_event(fdo, EV_SYN, SYN_REPORT, 0);
-        send_event(fdo, EV_KEY, key, 0);
-        send_event(fdo, EV_SYN, SYN_REPORT, 0);
+        set_event(&key_events[0], EV_KEY, key, 1);
+        set_event(&key_events[1], EV_SYN, SYN_REPORT, 0);
+        set_event(&key_events[2], EV_KEY, key, 0);
+        set_event(&key_events[3], EV_SYN, SYN_REPORT, 0);
+
+        if (write(fdo, key_events, sizeof(key_events)) < 0)
+        {
+            count_send_error();
+            perror("error: write key events");
+        }
+    }
+
+    /**
+     * Will create the pointer device. It is separate from the keyboard, so
+     * the desktop does not mistake the keyboard for a mouse.
+     *
+     * @param filename The uinput device file to use
+     */
+    static void init_pointer(const char* filename)
+    {
+        fdp = open(filename, O_WRONLY | O_NONBLOCK);
+        struct uinput_user_dev uidev;
+
+        if (fdp < 0)
+        {
+            die("error: open pointer device");
+        }
+
+        if (ioctl(fdp, UI_SET_EVBIT, EV_REL) < 0)
+        {
+            die("error: ioctl: EV_REL");
+        }
+        if (ioctl(fdp, UI_SET_RELBIT, REL_X) < 0)
+        {
+            die("error: ioctl: REL_X");
+        }
+        if (ioctl(fdp, UI_SET_RELBIT, REL_Y) < 0)
+        {
+            die("error: ioctl: REL_Y");
+        }
+
+        // Without a button, the device is not recognized as a mouse
+        if (ioctl(fdp, UI_SET_EVBIT, EV_KEY) < 0)
+        {
+            die("error: ioctl: EV_KEY");
+        }
+        if (ioctl(fdp, UI_SET_KEYBIT, BTN_LEFT) < 0)
+        {
+            die("error: ioctl: BTN_LEFT");
+        }
+        memset(&uidev, 0, sizeof(uidev));
+        snprintf(uidev.name, UINPUT_MAX_NAME_SIZE,
+                "presenter_server_pointer");
+        uidev.id.bustype = BUS_USB;
+        uidev.id.vendor  = 0x1;
+        uidev.id.product = 0x2;
+        uidev.id.version = 1;
+
+        if (write(fdp, &uidev, sizeof(uidev)) < 0)
+        {
+            die("error: ioctl: write");
+        }
+        if (ioctl(fdp, UI_DEV_CREATE) < 0)
+        {
+            die("error: ioctl: UI_DEV_CREATE");
+        }
     }
 
     void init_keysender()
@@ -121,9 +228,8 @@
 
         if (fdo < 0)
         {
-            char* msg = (char*) calloc(60,sizeof(char));
-            snprintf(msg, strlen(msg) * sizeof(char), "%s%s",
-                    "error: open on", filename);
+            char msg[60];
+            snprintf(msg, sizeof(msg), "error: open on %s", filename);
             die(msg);
         }
 
@@ -155,10 +261,39 @@
         {
             die("error: ioctl: UI_DEV_CREATE");
         }
+
+        init_pointer(filename);
+    }
+
+    void init_null_keysender()
+    {
+        fdo = open("/dev/null", O_WRONLY);
+        if (fdo < 0)
+        {
+            die("error: open on /dev/null");
+        }
+        fdp = fdo;
+
+        null_device = 1;
     }
 
     void destroy_keysender()
     {
+        if (null_device)
+        {
+            close(fdo);
+            fdp = -1;
+            null_device = 0;
+            return;
+        }
+
+        if (ioctl(fdp, UI_DEV_DESTROY) < 0)
+        {
+            die("error: ioctl - UI_DEV_DESTROY");
+        }
+        close(fdp);
+        fdp = -1;
+
         if (ioctl(fdo, UI_DEV_DESTROY) < 0)
         {
             die("error: ioctl - UI_DEV_DESTROY");
@@ -168,6 +303,11 @@
     }
 #endif // __linux__
 
+unsigned long get_send_errors()
+{
+    return (unsigned long) send_errors;
+}
+
 void send_next()
 {
     #ifdef _WIN32
@@ -211,3 +351,48 @@ void send_stop_presentation()
         send_key(KEY_ESC);
     #endif // __linux__
 }
+
+void send_pointer_motion(int dx, int dy)
+{
+    #ifdef _WIN32
+        // Relative moves are subject to the pointer acceleration, like the
+        // moves of a real mouse
+        INPUT ip;
+        ip.type = INPUT_MOUSE;
+        ip.mi.dx = dx;
+        ip.mi.dy = dy;
+        ip.mi.mouseData = 0;
+        ip.mi.dwFlags = MOUSEEVENTF_MOVE;
+        ip.mi.time = 0;
+        ip.mi.dwExtraInfo = 0;
+        if (SendInput(1, &ip, sizeof(INPUT)) != 1)
+        {
+            count_send_error();
+        }
+    #endif // _WIN32
+
+    #ifdef __linux__
+        // Both axes and the synchronization are written at once
+        size_t count = 0;
+        if (dx != 0)
+        {
+            set_event(&pointer_events[count++], EV_REL, REL_X, dx);
+        }
+        if (dy != 0)
+        {
+            set_event(&pointer_events[count++], EV_REL, REL_Y, dy);
+        }
+        if (count == 0)
+        {
+            return;
+        }
+        set_event(&pointer_events[count++], EV_SYN, SYN_REPORT, 0);
+
+        if (write(fdp, pointer_events, count * sizeof(struct input_event))
+            < 0)
+        {
+            count_send_error();
+            perror("error: write pointer events");
+        }
+    #endif // __linux__
+}
@@ -32,12 +32,25 @@
       */
     void init_keysender();
 
+    /**
+     * Will initialize our key sender without injecting events. The events
+     * are written to the null device, e.g. for tests and measurements.
+     */
+    void init_null_keysender();
+
     /**
      * Will destroy the key sender.
      */
     void destroy_keysender();
 #endif // __linux__
 
+/**
+ * Returns the number of key events that could not be injected.
+ *
+ * @return The number of failed events.
+ */
+unsigned long get_send_errors();
+
 /**
  * Will send the "next" key to the system.
  */
@@ -57,4 +70,12 @@ void send_start_presentation();
  * Will send the "stop presentation" key to the system.
  */
 void send_stop_presentation();
+
+/**
+ * Will move the pointer of the system relative to its position.
+ *
+ * @param dx The horizontal motion in pixels
+ * @param dy The vertical motion in pixels
+ */
+void send_pointer_motion(int dx, int dy);
 #endif /* SRC_MAIN_CONNECTOR_KEY_SENDER_H_ */
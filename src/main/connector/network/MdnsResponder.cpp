@@ -0,0 +1,573 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * MdnsResponder.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "MdnsResponder.h"
+
+#include "Version.h"
+
+const quint16 MdnsResponder::standardPort = 5353;
+const char* const MdnsResponder::serviceType = "_presenter._tcp.local";
+
+namespace
+{
+    // The multicast groups of mdns
+    const QHostAddress groupIPv4(QString("224.0.0.251"));
+    const QHostAddress groupIPv6(QString("ff02::fb"));
+
+    // The name to enumerate all services
+    const char* const servicesName = "_services._dns-sd._udp.local";
+
+    // Record types and classes
+    const quint16 typeA = 1;
+    const quint16 typePtr = 12;
+    const quint16 typeTxt = 16;
+    const quint16 typeAaaa = 28;
+    const quint16 typeSrv = 33;
+    const quint16 typeAny = 255;
+    const quint16 classIn = 1;
+    const quint16 cacheFlush = 0x8000;
+    const quint16 unicastResponse = 0x8000;
+
+    // Recommended ttls from RFC 6762, section 10
+    const quint32 hostTtl = 120;
+    const quint32 otherTtl = 4500;
+
+    // The maximum ttl of legacy unicast answers, RFC 6762, section 6.7
+    const quint32 legacyTtl = 10;
+
+    /**
+     * Converts an ascii character to lower case. Dns names are compared
+     * case insensitive for ascii characters only.
+     */
+    inline char toLowerAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+    }
+
+    QByteArray toLowerAscii(const QByteArray& name)
+    {
+        QByteArray lower(name);
+        for (int i = 0; i < lower.size(); i++)
+        {
+            lower[i] = toLowerAscii(name.at(i));
+        }
+        return lower;
+    }
+
+    void appendUInt16(QByteArray& packet, quint16 value)
+    {
+        packet.append(char(value >> 8));
+        packet.append(char(value & 0xff));
+    }
+
+    void appendUInt32(QByteArray& packet, quint32 value)
+    {
+        appendUInt16(packet, quint16(value >> 16));
+        appendUInt16(packet, quint16(value & 0xffff));
+    }
+
+    /**
+     * Appends an uncompressed name. The first label is passed separately,
+     * since service instance labels may contain dots.
+     */
+    void appendName(QByteArray& packet, const QByteArray& firstLabel,
+                    const QByteArray& domain)
+    {
+        if (!firstLabel.isEmpty())
+        {
+            packet.append(char(firstLabel.size()));
+            packet.append(firstLabel);
+        }
+        for (const QByteArray& label: domain.split('.'))
+        {
+            if (!label.isEmpty())
+            {
+                packet.append(char(label.size()));
+                packet.append(label);
+            }
+        }
+        packet.append('\0');
+    }
+
+    void appendRecordHeader(QByteArray& packet, quint16 type,
+                            quint16 recordClass, quint32 ttl)
+    {
+        appendUInt16(packet, type);
+        appendUInt16(packet, recordClass);
+        appendUInt32(packet, ttl);
+    }
+
+    void appendData(QByteArray& packet, const QByteArray& data)
+    {
+        appendUInt16(packet, quint16(data.size()));
+        packet.append(data);
+    }
+
+    /**
+     * Reads a possibly compressed name into a lower case dotted buffer.
+     *
+     * @return The offset behind the name or -1 if the name is malformed.
+     */
+    int readName(const uchar* data, int size, int offset,
+                 char* name, int nameSize)
+    {
+        int length = 0;
+        int end = -1;
+        int jumps = 0;
+
+        while (true)
+        {
+            if (offset >= size)
+            {
+                return -1;
+            }
+
+            uchar labelLength = data[offset];
+            if ((labelLength & 0xc0) == 0xc0)
+            {
+                // Compression pointer. Limit the jumps to avoid loops.
+                if (offset + 1 >= size || ++jumps > 16)
+                {
+                    return -1;
+                }
+                if (end < 0)
+                {
+                    end = offset + 2;
+                }
+                offset = ((labelLength & 0x3f) << 8) | data[offset + 1];
+                continue;
+            }
+            if (labelLength & 0xc0)
+            {
+                return -1;
+            }
+
+            offset++;
+            if (labelLength == 0)
+            {
+                break;
+            }
+            if (offset + labelLength > size
+                || length + labelLength + 2 > nameSize)
+            {
+                return -1;
+            }
+            if (length > 0)
+            {
+                name[length++] = '.';
+            }
+            for (int i = 0; i < labelLength; i++)
+            {
+                name[length++] = toLowerAscii(char(data[offset + i]));
+            }
+            offset += labelLength;
+        }
+
+        name[length] = '\0';
+        return end < 0 ? offset : end;
+    }
+}
+
+MdnsResponder::MdnsResponder(const QString& hostName, quint16 servicePort,
+                             quint16 port, QObject* parent) :
+    QObject(parent), port(port), servicePort(servicePort),
+    socketIPv4(NULL), socketIPv6(NULL)
+{
+    // Only the first label of the host name is unique on the local link
+    QByteArray host = hostName.toUtf8().split('.').first().left(63);
+    if (host.isEmpty())
+    {
+        host = "presenter";
+    }
+
+    this->hostName = toLowerAscii(host) + ".local";
+    instanceLabel = QString("Presenter on %1").arg(QString::fromUtf8(host))
+            .toUtf8().left(63);
+    instanceName = toLowerAscii(instanceLabel) + "." + serviceType;
+
+    response = encodeResponse(1);
+    legacyResponse = encodeResponse(1, true);
+}
+
+MdnsResponder::~MdnsResponder()
+{
+    stop();
+}
+
+bool MdnsResponder::start()
+{
+    if (socketIPv4 || socketIPv6)
+    {
+        return true;
+    }
+
+    socketIPv4 = openSocket(QHostAddress::AnyIPv4);
+    socketIPv6 = openSocket(QHostAddress::AnyIPv6);
+
+    return socketIPv4 || socketIPv6;
+}
+
+void MdnsResponder::stop()
+{
+    if (socketIPv4 || socketIPv6)
+    {
+        // Tell the caches to forget about us
+        sendMulticast(encodeResponse(0));
+    }
+
+    delete socketIPv4;
+    socketIPv4 = NULL;
+    delete socketIPv6;
+    socketIPv6 = NULL;
+}
+
+QUdpSocket* MdnsResponder::openSocket(const QHostAddress& bindAddress)
+{
+    QUdpSocket* socket = new QUdpSocket(this);
+
+    // Other responders, e.g. avahi, might use the port as well
+    if (!socket->bind(bindAddress, port,
+                      QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+    {
+        lastError = socket->errorString();
+        delete socket;
+        return NULL;
+    }
+
+    socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 255);
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readQuery()));
+
+    return socket;
+}
+
+void MdnsResponder::setInterfaces(const QList<QNetworkInterface>& interfaces)
+{
+    QList<QHostAddress> newAddresses;
+
+    for (const QNetworkInterface& networkInterface: interfaces)
+    {
+        bool hasIPv4 = false;
+        bool hasIPv6 = false;
+        for (const QNetworkAddressEntry& entry: networkInterface.addressEntries())
+        {
+            QHostAddress address = entry.ip();
+            if (address.isLoopback())
+            {
+                continue;
+            }
+
+            if (address.protocol() == QAbstractSocket::IPv4Protocol)
+            {
+                hasIPv4 = true;
+            }
+            else if (address.protocol() == QAbstractSocket::IPv6Protocol)
+            {
+                hasIPv6 = true;
+
+                // The scope is not part of the published record
+                address.setScopeId(QString());
+            }
+            newAddresses.append(address);
+        }
+
+        // Joining twice just fails, so no need to track the joined groups
+        if (hasIPv4 && socketIPv4)
+        {
+            socketIPv4->joinMulticastGroup(groupIPv4, networkInterface);
+        }
+        if (hasIPv6 && socketIPv6)
+        {
+            socketIPv6->joinMulticastGroup(groupIPv6, networkInterface);
+        }
+    }
+
+    if (newAddresses != addresses)
+    {
+        addresses = newAddresses;
+        response = encodeResponse(1);
+        legacyResponse = encodeResponse(1, true);
+        sendMulticast(response);
+    }
+}
+
+const QByteArray& MdnsResponder::responsePacket() const
+{
+    return response;
+}
+
+quint16 MdnsResponder::localPort() const
+{
+    return socketIPv4 ? socketIPv4->localPort() : 0;
+}
+
+QString MdnsResponder::errorString() const
+{
+    return lastError;
+}
+
+QByteArray MdnsResponder::encodeResponse(quint32 ttlScale,
+                                         bool legacyUnicast) const
+{
+    QByteArray packet;
+    packet.reserve(512);
+
+    // Legacy resolvers are no mdns caches, so they must not keep the
+    // records for long and don't know the cache flush bit
+    quint32 shortTtl = hostTtl * ttlScale;
+    quint32 longTtl = otherTtl * ttlScale;
+    quint16 flush = cacheFlush;
+    if (legacyUnicast)
+    {
+        shortTtl = qMin(shortTtl, legacyTtl);
+        longTtl = qMin(longTtl, legacyTtl);
+        flush = 0;
+    }
+
+    // Header: id 0, authoritative response, no questions
+    appendUInt16(packet, 0);
+    appendUInt16(packet, 0x8400);
+    appendUInt16(packet, 0);
+    appendUInt16(packet, quint16(4 + addresses.size()));
+    appendUInt16(packet, 0);
+    appendUInt16(packet, 0);
+
+    // Service type enumeration
+    appendName(packet, QByteArray(), servicesName);
+    appendRecordHeader(packet, typePtr, classIn, longTtl);
+    QByteArray data;
+    appendName(data, QByteArray(), serviceType);
+    appendData(packet, data);
+
+    // Our instance of the service type
+    appendName(packet, QByteArray(), serviceType);
+    appendRecordHeader(packet, typePtr, classIn, longTtl);
+    data.clear();
+    appendName(data, instanceLabel, serviceType);
+    appendData(packet, data);
+
+    // Where to find the instance
+    appendName(packet, instanceLabel, serviceType);
+    appendRecordHeader(packet, typeSrv, classIn | flush, shortTtl);
+    data.clear();
+    appendUInt16(data, 0); // priority
+    appendUInt16(data, 0); // weight
+    appendUInt16(data, servicePort);
+    appendName(data, QByteArray(), hostName);
+    appendData(packet, data);
+
+    // Additional information about the instance
+    appendName(packet, instanceLabel, serviceType);
+    appendRecordHeader(packet, typeTxt, classIn | flush, longTtl);
+    data.clear();
+    QList<QByteArray> entries;
+    entries << "txtvers=1"
+            << "minVersion=" + QByteArray::number(PRESENTER_PROTOCOL_MIN_VERSION)
+            << "maxVersion=" + QByteArray::number(PRESENTER_PROTOCOL_MAX_VERSION);
+    for (const QByteArray& entry: entries)
+    {
+        data.append(char(entry.size()));
+        data.append(entry);
+    }
+    appendData(packet, data);
+
+    // The addresses of our host
+    for (const QHostAddress& address: addresses)
+    {
+        appendName(packet, QByteArray(), hostName);
+        data.clear();
+        if (address.protocol() == QAbstractSocket::IPv4Protocol)
+        {
+            appendRecordHeader(packet, typeA, classIn | flush, shortTtl);
+            appendUInt32(data, address.toIPv4Address());
+        }
+        else
+        {
+            appendRecordHeader(packet, typeAaaa, classIn | flush, shortTtl);
+            Q_IPV6ADDR ipv6 = address.toIPv6Address();
+            data.append(reinterpret_cast<const char*>(ipv6.c), 16);
+        }
+        appendData(packet, data);
+    }
+
+    return packet;
+}
+
+bool MdnsResponder::matchesQuery(const char* data, int size,
+                                 bool* unicastRequested) const
+{
+    const uchar* packet = reinterpret_cast<const uchar*>(data);
+    if (size < 12)
+    {
+        return false;
+    }
+
+    // Ignore responses, also our own ones
+    quint16 flags = quint16((packet[2] << 8) | packet[3]);
+    if (flags & 0x8000)
+    {
+        return false;
+    }
+
+    int questions = (packet[4] << 8) | packet[5];
+    int offset = 12;
+    bool matches = false;
+    char name[256];
+
+    for (int i = 0; i < questions; i++)
+    {
+        offset = readName(packet, size, offset, name, sizeof(name));
+        if (offset < 0 || offset + 4 > size)
+        {
+            return matches;
+        }
+
+        quint16 type = quint16((packet[offset] << 8) | packet[offset + 1]);
+        quint16 questionClass =
+                quint16((packet[offset + 2] << 8) | packet[offset + 3]);
+        offset += 4;
+
+        bool knownType = type == typePtr || type == typeSrv || type == typeTxt
+                || type == typeA || type == typeAaaa || type == typeAny;
+        bool knownName = qstrcmp(name, serviceType) == 0
+                || qstrcmp(name, servicesName) == 0
+                || qstrcmp(name, instanceName.constData()) == 0
+                || qstrcmp(name, hostName.constData()) == 0;
+
+        if (knownType && knownName)
+        {
+            matches = true;
+            if (questionClass & unicastResponse)
+            {
+                *unicastRequested = true;
+            }
+        }
+    }
+
+    return matches;
+}
+
+QByteArray MdnsResponder::legacyAnswer(const char* query, int size) const
+{
+    const uchar* packet = reinterpret_cast<const uchar*>(query);
+    int questions = (packet[4] << 8) | packet[5];
+    int end = 12;
+    char name[256];
+
+    for (int i = 0; i < questions; i++)
+    {
+        end = readName(packet, size, end, name, sizeof(name));
+        if (end < 0 || end + 4 > size)
+        {
+            return QByteArray();
+        }
+        end += 4;
+    }
+
+    // Names in the questions can only point to prior names, so they are
+    // copied as they are. Our records follow uncompressed.
+    QByteArray answer;
+    answer.reserve(legacyResponse.size() + end);
+    answer.append(query, 2);
+    appendUInt16(answer, 0x8400);
+    appendUInt16(answer, quint16(questions));
+    answer.append(legacyResponse.constData() + 6, 6);
+    answer.append(query + 12, end - 12);
+    answer.append(legacyResponse.constData() + 12, legacyResponse.size() - 12);
+
+    return answer;
+}
+
+void MdnsResponder::readQuery()
+{
+    QUdpSocket* socket = qobject_cast<QUdpSocket*>(sender());
+    if (!socket)
+    {
+        return;
+    }
+
+    while (socket->hasPendingDatagrams())
+    {
+        QHostAddress peerAddress;
+        quint16 peerPort = 0;
+        qint64 size = socket->readDatagram(receiveBuffer, sizeof(receiveBuffer),
+                                           &peerAddress, &peerPort);
+
+        bool unicastRequested = false;
+        if (!matchesQuery(receiveBuffer, int(size), &unicastRequested))
+        {
+            continue;
+        }
+
+        if (peerPort != standardPort)
+        {
+            // Legacy unicast query, e.g. from a simple resolver
+            QByteArray answer = legacyAnswer(receiveBuffer, int(size));
+            if (!answer.isEmpty())
+            {
+                socket->writeDatagram(answer, peerAddress, peerPort);
+            }
+        }
+        else if (unicastRequested)
+        {
+            socket->writeDatagram(response, peerAddress, peerPort);
+        }
+        else
+        {
+            // RFC 6762 allows the same records only once per second. The
+            // answer goes to the group of the family the query came from.
+            QElapsedTimer& lastMulticast = socket == socketIPv4
+                    ? lastMulticastIPv4 : lastMulticastIPv6;
+            if (!lastMulticast.isValid() || lastMulticast.elapsed() >= 1000)
+            {
+                sendMulticast(response, socket);
+            }
+        }
+    }
+}
+
+void MdnsResponder::sendMulticast(const QByteArray& packet)
+{
+    sendMulticast(packet, socketIPv4);
+    sendMulticast(packet, socketIPv6);
+}
+
+void MdnsResponder::sendMulticast(const QByteArray& packet, QUdpSocket* socket)
+{
+    if (!socket)
+    {
+        return;
+    }
+
+    if (socket == socketIPv4)
+    {
+        socket->writeDatagram(packet, groupIPv4, standardPort);
+        lastMulticastIPv4.start();
+    }
+    else
+    {
+        socket->writeDatagram(packet, groupIPv6, standardPort);
+        lastMulticastIPv6.start();
+    }
+}
@@ -0,0 +1,249 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * MdnsResponder.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_NETWORK_MDNSRESPONDER_H_
+#define SRC_MAIN_CONNECTOR_NETWORK_MDNSRESPONDER_H_
+
+#include <QObject>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+#include <QNetworkInterface>
+
+/**
+ * A minimal multicast dns responder that publishes our server as DNS-SD
+ * service of type "_presenter._tcp". All records are encoded once into a
+ * response packet, so answering a query is just a single send.
+ */
+class MdnsResponder: public QObject
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new responder. Call {@link #start} to answer queries.
+         *
+         * @param hostName The name of our host, without ".local".
+         * @param servicePort The port of the published service.
+         * @param port The port to listen for queries. Defaults to the
+         *             standard mdns port, but can be changed for tests.
+         * @param parent The parent object.
+         */
+        MdnsResponder(const QString& hostName, quint16 servicePort,
+                      quint16 port = standardPort, QObject* parent = 0);
+
+        /**
+         * Stops the responder.
+         */
+        virtual ~MdnsResponder();
+
+        /**
+         * Binds the sockets and starts answering queries.
+         *
+         * @return False if neither IPv4 nor IPv6 sockets could be bound.
+         */
+        bool start();
+
+        /**
+         * Sends a goodbye packet and stops answering queries.
+         */
+        void stop();
+
+        /**
+         * Joins the multicast groups on the given interfaces and publishes
+         * their addresses. Announces the service if the records changed.
+         *
+         * @param interfaces The multicast capable interfaces.
+         */
+        void setInterfaces(const QList<QNetworkInterface>& interfaces);
+
+        /**
+         * Returns the cached response packet.
+         *
+         * @return The encoded response.
+         */
+        const QByteArray& responsePacket() const;
+
+        /**
+         * Returns the port the IPv4 socket is bound to.
+         *
+         * @return The bound port or 0 if not bound.
+         */
+        quint16 localPort() const;
+
+        /**
+         * Returns a description of the last error.
+         *
+         * @return The error description.
+         */
+        QString errorString() const;
+
+        /**
+         * The standard mdns port.
+         */
+        static const quint16 standardPort;
+
+        /**
+         * The name of our DNS-SD service type.
+         */
+        static const char* const serviceType;
+
+    private slots:
+        /**
+         * Called if a datagram was received. Answers queries for our records.
+         */
+        void readQuery();
+
+    private:
+        /**
+         * The port to listen for queries.
+         */
+        quint16 port;
+
+        /**
+         * The port of the published service.
+         */
+        quint16 servicePort;
+
+        /**
+         * The fully qualified lower case host name, e.g. "host.local".
+         */
+        QByteArray hostName;
+
+        /**
+         * The fully qualified lower case service instance name.
+         */
+        QByteArray instanceName;
+
+        /**
+         * The instance label as it is published.
+         */
+        QByteArray instanceLabel;
+
+        /**
+         * The addresses that are currently published.
+         */
+        QList<QHostAddress> addresses;
+
+        /**
+         * The cached response packet.
+         */
+        QByteArray response;
+
+        /**
+         * The cached response for legacy unicast queries. The id and the
+         * question of each query are filled in when answering.
+         */
+        QByteArray legacyResponse;
+
+        /**
+         * The socket for IPv4 queries. NULL if not available.
+         */
+        QUdpSocket* socketIPv4;
+
+        /**
+         * The socket for IPv6 queries. NULL if not available.
+         */
+        QUdpSocket* socketIPv6;
+
+        /**
+         * Time since our last IPv4 multicast response, for rate limiting.
+         */
+        QElapsedTimer lastMulticastIPv4;
+
+        /**
+         * Time since our last IPv6 multicast response, for rate limiting.
+         */
+        QElapsedTimer lastMulticastIPv6;
+
+        /**
+         * The last error.
+         */
+        QString lastError;
+
+        /**
+         * Receive buffer, sized for the largest mdns packet.
+         */
+        char receiveBuffer[9000];
+
+        /**
+         * Creates a socket for the given protocol.
+         *
+         * @param bindAddress The any address of the protocol.
+         * @return The socket or NULL if it could not be bound.
+         */
+        QUdpSocket* openSocket(const QHostAddress& bindAddress);
+
+        /**
+         * Encodes all our records into a packet.
+         *
+         * @param ttlScale 1 for a normal response, 0 for goodbye packets.
+         * @param legacyUnicast If the records are for a legacy unicast
+         *                      response, so they get short ttls and no
+         *                      cache flush bit.
+         * @return The encoded packet.
+         */
+        QByteArray encodeResponse(quint32 ttlScale,
+                                  bool legacyUnicast = false) const;
+
+        /**
+         * Creates the answer to a legacy unicast query. It repeats the id
+         * and the questions of the query, see RFC 6762, section 6.7.
+         *
+         * @param query The received query. Must be a matching query.
+         * @param size The size of the query.
+         * @return The answer or an empty array if the query is malformed.
+         */
+        QByteArray legacyAnswer(const char* query, int size) const;
+
+        /**
+         * Checks if a query asks for one of our records.
+         *
+         * @param data The received packet.
+         * @param size The size of the packet.
+         * @param unicastRequested Set to true if a unicast answer was
+         *                         requested.
+         * @return True if we should answer.
+         */
+        bool matchesQuery(const char* data, int size,
+                          bool* unicastRequested) const;
+
+        /**
+         * Sends a packet to the multicast groups.
+         *
+         * @param packet The packet to send.
+         */
+        void sendMulticast(const QByteArray& packet);
+
+        /**
+         * Sends a packet to the multicast group of a socket.
+         *
+         * @param packet The packet to send.
+         * @param socket The socket of the IPv4 or IPv6 group. Nothing is
+         *               sent if NULL.
+         */
+        void sendMulticast(const QByteArray& packet, QUdpSocket* socket);
+};
+
+#endif /* SRC_MAIN_CONNECTOR_NETWORK_MDNSRESPONDER_H_ */
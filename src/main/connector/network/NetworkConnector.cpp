@@ -26,18 +26,49 @@
 #include <QHostInfo>
 #include <QNetworkInterface>
 #include "NetworkConnector.h"
+#include "../../diagnostics/StallProbe.h"
+#include "../../diagnostics/Tracer.h"
 
 // Randomly selected port for broadcasting
 const int NetworkConnector::broadcastPort = 43154;
 
-NetworkConnector::NetworkConnector() :
-    broadcastSocket(NULL), keyCommandServer(NULL), clientSockets()
+// The tcp server listens next to the broadcast port
+const int NetworkConnector::defaultCommandPort = broadcastPort + 1;
+
+// The command datagrams are received next to the tcp server
+const int NetworkConnector::commandDatagramPort = broadcastPort + 2;
+
+// Administratively scoped group, derived from our port
+const char* const NetworkConnector::multicastGroupIPv4 = "239.255.43.154";
+
+// Link-local group, derived from our service uuid
+const char* const NetworkConnector::multicastGroupIPv6 = "ff02::be71:c255";
+
+// Refresh the interfaces once per minute
+const int NetworkConnector::interfaceRefreshInterval = 12;
+
+// Forget datagram clients after a minute of silence
+const int NetworkConnector::datagramPeerTimeout = 60000;
+
+// Way more than the devices of an audience, but limits the memory
+const int NetworkConnector::maxDatagramPeers = 256;
+
+NetworkConnector::NetworkConnector(KeySender* keySender) :
+    RemoteControl(keySender), announcementCount(0), broadcastTimer(this),
+    broadcastSocket(NULL),
+    discoverySocketIPv4(NULL), discoverySocketIPv6(NULL),
+    groupIPv4(QString(multicastGroupIPv4)),
+    groupIPv6(QString(multicastGroupIPv6)), mdnsResponder(NULL),
+    keyCommandServer(NULL), listenPort(defaultCommandPort),
+    discoveryEnabled(true), datagramCommandsEnabled(false),
+    commandSocket(NULL)
 {
     connect(&broadcastTimer, SIGNAL(timeout()),
                        this, SLOT(broadcastServerAvailablility()));
 
     // TODO This is the same as the bluetooth service uuid => Unify this
-    broadcastMessage = QString("be71c255-8349-4d86-b09e-7983c035a191\n")
+    probeMessage = QByteArray("be71c255-8349-4d86-b09e-7983c035a191");
+    broadcastMessage = QString::fromUtf8(probeMessage).append("\n")
             .append(QHostInfo::localHostName()).toUtf8();
 }
 
@@ -46,62 +77,417 @@ NetworkConnector::~NetworkConnector()
     stopServer();
 }
 
-void NetworkConnector::startServer()
+bool NetworkConnector::start()
 {
     keyCommandServer = new QTcpServer(this);
     connect(keyCommandServer, SIGNAL(newConnection()),
                         this, SLOT(clientConnected()));
-    if (!keyCommandServer->listen(QHostAddress::Any, broadcastPort + 1))
+
+    // QHostAddress::Any listens on IPv4 and IPv6 if the system supports it
+    if (!keyCommandServer->listen(QHostAddress::Any, listenPort))
     {
         emit error(tr("Did not start server. %1.")
                    .arg(keyCommandServer->errorString()));
-        return;
+        return false;
+    }
+
+    if (discoveryEnabled)
+    {
+        broadcastSocket = new QUdpSocket(this);
+        discoverySocketIPv4 = openDiscoverySocket(QHostAddress::AnyIPv4,
+                                                  groupIPv4);
+        discoverySocketIPv6 = openDiscoverySocket(QHostAddress::AnyIPv6,
+                                                  groupIPv6);
+
+        mdnsResponder = new MdnsResponder(QHostInfo::localHostName(),
+                                          keyCommandServer->serverPort(),
+                                          MdnsResponder::standardPort, this);
+        if (!mdnsResponder->start())
+        {
+            emit info(tr("Service publishing via mdns not available. %1")
+                      .arg(mdnsResponder->errorString()));
+        }
     }
 
-    broadcastSocket = new QUdpSocket(this);
-    broadcastTimer.start(5000); // Emit the message every 5 seconds
+    if (datagramCommandsEnabled)
+    {
+        commandSocket = new QUdpSocket(this);
+        if (commandSocket->bind(QHostAddress::Any, commandDatagramPort))
+        {
+            connect(commandSocket, SIGNAL(readyRead()),
+                              this, SLOT(readCommandDatagram()));
+            datagramClock.start();
+        }
+        else
+        {
+            emit info(tr("Datagram commands not available. %1")
+                      .arg(commandSocket->errorString()));
+            delete commandSocket;
+            commandSocket = NULL;
+        }
+    }
+
+    if (discoveryEnabled)
+    {
+        announcementCount = 0;
+        broadcastServerAvailablility();
+        broadcastTimer.start(5000); // Emit the message every 5 seconds
+    }
 
-    emit serverReady();
+    return true;
 }
 
-void NetworkConnector::stopServer()
+void NetworkConnector::stop()
 {
     broadcastTimer.stop();
 
-    // Close sockets
-    qDeleteAll(clientSockets);
+    // Release the port, so the server can be started again right away
+    delete keyCommandServer;
+    keyCommandServer = NULL;
+
+    // Close sockets. Disconnect them first, so closing them does not call
+    // our slots for clients that are already removed.
+    for (ClientState* client: clients)
+    {
+        client->connection->disconnect(this);
+        delete client->connection;
+    }
+    clients.clear();
 
-    broadcastSocket->close();
     delete broadcastSocket;
     broadcastSocket = NULL;
+    delete discoverySocketIPv4;
+    discoverySocketIPv4 = NULL;
+    delete discoverySocketIPv6;
+    discoverySocketIPv6 = NULL;
+
+    // Sends the goodbye packet
+    delete mdnsResponder;
+    mdnsResponder = NULL;
+
+    delete commandSocket;
+    commandSocket = NULL;
+    datagramPeers.clear();
 }
 
-void NetworkConnector::broadcastServerAvailablility()
+void NetworkConnector::setDiscoveryEnabled(bool enabled)
+{
+    discoveryEnabled = enabled;
+}
+
+void NetworkConnector::setDatagramCommandsEnabled(bool enabled)
+{
+    datagramCommandsEnabled = enabled;
+}
+
+void NetworkConnector::setCommandPort(quint16 port)
+{
+    listenPort = port;
+}
+
+quint16 NetworkConnector::commandPort() const
 {
+    return keyCommandServer ? keyCommandServer->serverPort() : 0;
+}
+
+QUdpSocket* NetworkConnector::openDiscoverySocket(
+        const QHostAddress& bindAddress, const QHostAddress& group)
+{
+    QUdpSocket* socket = new QUdpSocket(this);
+    if (!socket->bind(bindAddress, broadcastPort,
+                      QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+    {
+        emit info(tr("Discovery via %1 not available. %2")
+                  .arg(group.toString(), socket->errorString()));
+        delete socket;
+        return NULL;
+    }
+
+    // Keep the announcements on the local link and don't receive them again
+    socket->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+    socket->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 0);
+
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readProbe()));
+
+    return socket;
+}
+
+void NetworkConnector::refreshInterfaces()
+{
+    broadcastAddresses.clear();
+    localNetworks.clear();
+    multicastInterfacesIPv4.clear();
+    multicastInterfacesIPv6.clear();
+    QList<QNetworkInterface> multicastInterfaces;
+
     // We can't emit on internet broadcast address 255.255.255.255 (filtered by most routers),
     // so instead, we need to use the broadcast address(es) of our available interfaces
     QList<QNetworkInterface> interfaces = QNetworkInterface::allInterfaces();
-    for (QNetworkInterface interface: interfaces)
+    for (const QNetworkInterface& networkInterface: interfaces)
     {
-        QList<QNetworkAddressEntry> addressEntries = interface.addressEntries();
-        for(QNetworkAddressEntry address: addressEntries)
+        QNetworkInterface::InterfaceFlags flags = networkInterface.flags();
+        if (!(flags & QNetworkInterface::IsUp)
+            || !(flags & QNetworkInterface::IsRunning)
+            || (flags & QNetworkInterface::IsLoopBack))
         {
-            if(!address.ip().isLoopback()
-                && address.ip().protocol() == QAbstractSocket::IPv4Protocol)
+            continue;
+        }
+
+        bool hasIPv4 = false;
+        bool hasIPv6 = false;
+        QList<QNetworkAddressEntry> addressEntries = networkInterface.addressEntries();
+        for (const QNetworkAddressEntry& address: addressEntries)
+        {
+            localNetworks.append(address);
+            if (address.ip().protocol() == QAbstractSocket::IPv4Protocol)
             {
-                broadcastSocket->writeDatagram(broadcastMessage, address.broadcast(), broadcastPort);
+                hasIPv4 = true;
+                if (!address.broadcast().isNull())
+                {
+                    broadcastAddresses.append(address.broadcast());
+                }
             }
+            else if (address.ip().protocol() == QAbstractSocket::IPv6Protocol)
+            {
+                hasIPv6 = true;
+            }
+        }
+
+        if (!(flags & QNetworkInterface::CanMulticast))
+        {
+            continue;
+        }
+        multicastInterfaces.append(networkInterface);
+
+        // Joining a group twice on the same interface just fails, so we don't
+        // need to track on which interfaces we already joined
+        if (hasIPv4 && discoverySocketIPv4)
+        {
+            discoverySocketIPv4->joinMulticastGroup(groupIPv4, networkInterface);
+            multicastInterfacesIPv4.append(networkInterface);
+        }
+        if (hasIPv6 && discoverySocketIPv6)
+        {
+            discoverySocketIPv6->joinMulticastGroup(groupIPv6, networkInterface);
+            multicastInterfacesIPv6.append(networkInterface);
         }
     }
+
+    if (mdnsResponder)
+    {
+        mdnsResponder->setInterfaces(multicastInterfaces);
+    }
 }
 
-void NetworkConnector::write(const QString& message)
+void NetworkConnector::broadcastServerAvailablility()
+{
+    StallProbe probe("NetworkConnector::broadcastServerAvailablility");
+
+    // Reading the interfaces is expensive compared to sending a datagram,
+    // so we just do it from time to time
+    if (announcementCount++ % interfaceRefreshInterval == 0)
+    {
+        refreshInterfaces();
+        pruneDatagramPeers();
+    }
+
+    int sent = 0;
+    for (const QHostAddress& address: broadcastAddresses)
+    {
+        if (broadcastSocket->writeDatagram(broadcastMessage, address,
+                                           broadcastPort) >= 0)
+        {
+            sent++;
+        }
+    }
+
+    for (const QNetworkInterface& networkInterface: multicastInterfacesIPv4)
+    {
+        discoverySocketIPv4->setMulticastInterface(networkInterface);
+        if (discoverySocketIPv4->writeDatagram(broadcastMessage, groupIPv4,
+                                               broadcastPort) >= 0)
+        {
+            sent++;
+        }
+    }
+
+    for (const QNetworkInterface& networkInterface: multicastInterfacesIPv6)
+    {
+        // The scope selects the interface for link-local addresses
+        QHostAddress group(groupIPv6);
+        group.setScopeId(networkInterface.name());
+        if (discoverySocketIPv6->writeDatagram(broadcastMessage, group,
+                                               broadcastPort) >= 0)
+        {
+            sent++;
+        }
+    }
+
+    Metrics* metrics = Metrics::instance();
+    if (metrics)
+    {
+        metrics->countBeacons(sent);
+    }
+}
+
+void NetworkConnector::readProbe()
+{
+    QUdpSocket *socket = qobject_cast<QUdpSocket*>(sender());
+    if (!socket)
+    {
+        return;
+    }
+
+    // Probes are small, so anything bigger can be dropped unread
+    char buffer[64];
+    while (socket->hasPendingDatagrams())
+    {
+        QHostAddress peerAddress;
+        quint16 peerPort = 0;
+        qint64 size = socket->readDatagram(buffer, sizeof(buffer),
+                                           &peerAddress, &peerPort);
+
+        // Our own broadcasts end up here as well, they won't match
+        QByteArray datagram = QByteArray::fromRawData(buffer, int(qMax(size, qint64(0))));
+        // The sender address is not verified, so answers are only sent to
+        // the local link. Otherwise anyone could make us send our answer
+        // to a spoofed address somewhere else.
+        if (datagram.trimmed() == probeMessage && isOnLink(peerAddress))
+        {
+            socket->writeDatagram(broadcastMessage, peerAddress, peerPort);
+        }
+    }
+}
+
+bool NetworkConnector::isOnLink(const QHostAddress& address) const
+{
+    if (address.isLoopback()
+        || address.isInSubnet(QHostAddress(QString("fe80::")), 10))
+    {
+        return true;
+    }
+
+    for (const QNetworkAddressEntry& network: localNetworks)
+    {
+        if (address.isInSubnet(network.ip(), network.prefixLength()))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NetworkConnector::pruneDatagramPeers()
 {
-    emit info(QString("Write: %1").arg(message));
+    qint64 now = datagramClock.isValid() ? datagramClock.elapsed() : 0;
+
+    QHash<QString, DatagramPeer>::iterator peer = datagramPeers.begin();
+    while (peer != datagramPeers.end())
+    {
+        if (now - peer->lastActivity > datagramPeerTimeout)
+        {
+            peer = datagramPeers.erase(peer);
+        }
+        else
+        {
+            ++peer;
+        }
+    }
+}
+
+void NetworkConnector::readCommandDatagram()
+{
+    // Commands are short, so anything that does not fit is truncated
+    char buffer[512];
+    while (commandSocket->hasPendingDatagrams())
+    {
+        Tracer::beginTrace();
+        TraceSpan span("socket read");
 
-    for (QTcpSocket* socket: clientSockets)
+        QHostAddress peerAddress;
+        quint16 peerPort = 0;
+        qint64 size = commandSocket->readDatagram(buffer, sizeof(buffer),
+                                                  &peerAddress, &peerPort);
+        if (size <= 0)
+        {
+            continue;
+        }
+
+        // The first line is the session and the sequence number, the rest
+        // the message
+        QByteArray datagram = QByteArray::fromRawData(buffer, int(size));
+        int lineEnd = datagram.indexOf('\n');
+        QList<QByteArray> header = datagram.left(qMax(lineEnd, 0))
+                .simplified().split(' ');
+        bool isSession = false;
+        bool isSequence = false;
+        quint32 session = header.first().toUInt(&isSession);
+        quint32 sequence = header.last().toUInt(&isSequence);
+        if (lineEnd < 0 || header.size() != 2 || !isSession || !isSequence)
+        {
+            continue;
+        }
+
+        QString peerName = peerAddress.toString();
+        QString peerKey = QString("%1:%2").arg(peerName).arg(peerPort);
+        qint64 now = datagramClock.elapsed();
+        QHash<QString, DatagramPeer>::iterator peer =
+                datagramPeers.find(peerKey);
+        if (peer == datagramPeers.end())
+        {
+            if (datagramPeers.size() >= maxDatagramPeers)
+            {
+                pruneDatagramPeers();
+            }
+            if (datagramPeers.size() >= maxDatagramPeers)
+            {
+                continue;
+            }
+
+            peer = datagramPeers.insert(peerKey, DatagramPeer());
+            peer->session = session;
+        }
+        else if (peer->session != session)
+        {
+            // The client restarted, so its sequence numbers start over
+            peer->window.reset();
+            peer->session = session;
+        }
+        peer->lastActivity = now;
+        bool isNew = peer->window.accept(sequence);
+
+        // Acknowledge duplicates as well, the previous ack might be lost.
+        // The mask tells the client which of the recent datagrams arrived.
+        QByteArray ack = QByteArray("ack ")
+                + QByteArray::number(sequence) + " "
+                + QByteArray::number(peer->window.highest()) + " "
+                + QByteArray::number(peer->window.received(), 16) + "\n";
+        commandSocket->writeDatagram(ack, peerAddress, peerPort);
+
+        if (isNew)
+        {
+            QByteArray message = datagram.mid(lineEnd + 1).trimmed();
+            handleMessage(peerName, QString::fromUtf8(message.constData(),
+                                                      message.length()));
+        }
+        else if (FlightRecorder::instance())
+        {
+            FlightRecorder::instance()->record(
+                    FlightRecorder::NetworkDatagram, 0, peerName,
+                    FlightRecorder::UnknownCommand,
+                    FlightRecorder::Duplicate);
+        }
+    }
+}
+
+void NetworkConnector::write(const QString& message)
+{
+    const QByteArray bytes(message.toUtf8());
+    for (ClientState* client: clients)
     {
-        QByteArray messageToSend(message.toUtf8());
+        QTcpSocket* socket = static_cast<QTcpSocket*>(client->connection);
+        QByteArray messageToSend(bytes);
         int bytesSent = 0;
         while (bytesSent < messageToSend.length())
         {
@@ -109,6 +495,75 @@ void NetworkConnector::write(const QString& message)
             messageToSend = messageToSend.mid(sent);
             bytesSent += sent;
         }
+        client->bytesSent += bytesSent;
+    }
+}
+
+void NetworkConnector::reply(ClientState& client, const QByteArray& message)
+{
+    QTcpSocket* socket = static_cast<QTcpSocket*>(client.connection);
+    client.bytesSent += socket->write(message);
+}
+
+void NetworkConnector::publishSlideState(const QByteArray& event)
+{
+    slideState = event;
+
+    for (ClientState* client: clients)
+    {
+        if (client->viewer)
+        {
+            sendSlideState(*client, slideState);
+        }
+    }
+}
+
+void NetworkConnector::handleSubscribed(ClientState& client)
+{
+    connect(client.connection, SIGNAL(bytesWritten(qint64)),
+            this, SLOT(viewerBytesWritten()));
+
+    if (!slideState.isEmpty())
+    {
+        sendSlideState(client, slideState);
+    }
+}
+
+FlightRecorder::Source NetworkConnector::source(
+        const ClientState* client) const
+{
+    return client ? FlightRecorder::Network : FlightRecorder::NetworkDatagram;
+}
+
+void NetworkConnector::sendSlideState(ClientState& client,
+                                      const QByteArray& event)
+{
+    QTcpSocket* socket = static_cast<QTcpSocket*>(client.connection);
+
+    // Slow viewers just get the latest state, the event is shared
+    if (socket->bytesToWrite() > 0)
+    {
+        client.pendingState = event;
+        return;
+    }
+
+    client.pendingState.clear();
+    client.bytesSent += socket->write(event);
+}
+
+void NetworkConnector::viewerBytesWritten()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket)
+    {
+        return;
+    }
+
+    ClientState* client = clients.find(socket);
+    if (client && !client->pendingState.isEmpty())
+    {
+        QByteArray event = client->pendingState;
+        sendSlideState(*client, event);
     }
 }
 
@@ -122,9 +577,16 @@ void NetworkConnector::clientConnected()
 
     connect(socket, SIGNAL(readyRead()), this, SLOT(readSocket()));
     connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
-    clientSockets.append(socket);
 
-    handleClientConnected(socket->peerName());
+    // Incoming connections have no peer name, use the address instead
+    QString name = socket->peerName();
+    if (name.isEmpty())
+    {
+        name = socket->peerAddress().toString();
+    }
+    clients.add(socket, name);
+
+    handleClientConnected(name);
 }
 
 void NetworkConnector::clientDisconnected()
@@ -137,7 +599,7 @@ void NetworkConnector::clientDisconnected()
 
     emit RemoteControl::clientDisconnected();
 
-    clientSockets.removeOne(socket);
+    removeClient(clients.find(socket));
     socket->deleteLater();
 }
 
@@ -149,10 +611,28 @@ void NetworkConnector::readSocket()
         return;
     }
 
+    ClientState* client = clients.find(socket);
+    if (!client)
+    {
+        return;
+    }
+
+    // A tap of a client usually arrives in a single read
+    Tracer::beginTrace();
+    TraceSpan span("socket read");
+
+    client->lastActivity = clients.now();
     while (socket->canReadLine())
     {
-        QByteArray line = socket->readLine().trimmed();
-        handleLine(socket->peerName(),
-                  QString::fromUtf8(line.constData(), line.length()));
+        if (readMotion(socket, *client))
+        {
+            continue;
+        }
+
+        QByteArray line = socket->readLine();
+        client->bytesReceived += line.length();
+        line = line.trimmed();
+        handleLine(*client,
+                   QString::fromUtf8(line.constData(), line.length()));
     }
 }
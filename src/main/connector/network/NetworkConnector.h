@@ -27,16 +27,32 @@
 #define SRC_MAIN_CONNECTOR_NETWORKCONNECTOR_H_
 
 #include "../RemoteControl.h"
+#include "MdnsResponder.h"
+#include "SequenceWindow.h"
 
+#include <QHash>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QUdpSocket>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QNetworkInterface>
 
 /**
  * A remote control class to control the presentation via network.
  * It broadcasts regularly a message that can be received from the
  * clients and can be used to automatically connect to our server.
+ * The same message is announced to link-local multicast groups for IPv4 and
+ * IPv6 and sent as answer to probes, so clients can find the server also on
+ * networks that filter broadcasts or that are IPv6 only. Additionally the
+ * server is published as DNS-SD service, so standard tools can find it.
+ *
+ * Besides the tcp server, commands can be sent as datagrams if enabled. Each
+ * datagram starts with a line "<session> <sequence>" followed by a protocol
+ * message. The session is a random number a client chooses on start, the
+ * sequence numbers count up within a session. Clients send each datagram
+ * several times, the server drops the duplicates and acknowledges the
+ * received sequence numbers.
  */
 class NetworkConnector: public RemoteControl
 {
@@ -45,8 +61,11 @@ class NetworkConnector: public RemoteControl
 public:
     /**
      * Creates a new network connector.
+     *
+     * @param keySender The key sender to use. If NULL, the key sender of the
+     *                  system will be used.
      */
-    NetworkConnector();
+    NetworkConnector(KeySender* keySender = NULL);
 
     /**
      * Cleans up the network connector.
@@ -54,27 +73,144 @@ public:
     ~NetworkConnector();
 
     /**
-     * Starts a new server.
+     * Enables or disables the announcements, the answers to probes and the
+     * service publishing via mdns. Enabled by default. Tests disable it, so
+     * they don't bind the well known ports or send to the network. Takes
+     * effect on the next start of the server.
+     *
+     * @param enabled If clients should be able to discover the server.
+     */
+    void setDiscoveryEnabled(bool enabled);
+
+    /**
+     * Enables or disables the datagram command channel. Disabled by
+     * default, since datagrams are accepted from any sender without a
+     * connection. Takes effect on the next start of the server.
+     *
+     * @param enabled If datagram commands should be accepted.
+     */
+    void setDatagramCommandsEnabled(bool enabled);
+
+    /**
+     * Sets the port of the tcp server. Takes effect on the next start of the
+     * server.
+     *
+     * @param port The port, 0 to choose a free port, e.g. for tests.
      */
-    void startServer();
+    void setCommandPort(quint16 port);
 
     /**
-     * Stops the running server.
+     * Returns the port the tcp server is listening on.
+     *
+     * @return The port, 0 if the server is not running.
      */
-    void stopServer();
+    quint16 commandPort() const;
+
+    /**
+     * The default network port of the tcp server.
+     */
+    static const int defaultCommandPort;
 
     /**
      * The network port on which broadcast messages will be sent.
      */
     static const int broadcastPort;
 
+    /**
+     * The network port on which command datagrams are received.
+     */
+    static const int commandDatagramPort;
+
+    /**
+     * The IPv4 multicast group for announcements and probes. Announcements
+     * are sent with a ttl of 1, so they stay on the local link.
+     */
+    static const char* const multicastGroupIPv4;
+
+    /**
+     * The link-local IPv6 multicast group for announcements and probes.
+     */
+    static const char* const multicastGroupIPv6;
+
+protected:
+    /**
+     * Starts the server.
+     *
+     * @return True if the server is ready for connections.
+     */
+    bool start();
+
+    /**
+     * Stops the server and closes all connections.
+     */
+    void stop();
+
+public slots:
+    /**
+     * Sends a new slide state to all viewers. Viewers that did not read
+     * the previous state yet only get the latest state once they did.
+     *
+     * @param event The encoded state event, see {@link SlideStateModel}.
+     */
+    void publishSlideState(const QByteArray& event);
+
 private:
+    /**
+     * The number of announcements after which the list of network interfaces
+     * will be refreshed.
+     */
+    static const int interfaceRefreshInterval;
+
+    /**
+     * Time in milliseconds after which the state of an inactive datagram
+     * client is dropped.
+     */
+    static const int datagramPeerTimeout;
+
+    /**
+     * The maximum number of datagram clients whose state is kept.
+     * Datagrams of further clients are dropped.
+     */
+    static const int maxDatagramPeers;
+
+    /**
+     * The state of a client that sends command datagrams.
+     */
+    struct DatagramPeer
+    {
+        /**
+         * The sequence numbers received from the client.
+         */
+        SequenceWindow window;
+
+        /**
+         * The session of the received sequence numbers. The window starts
+         * over if the client starts a new session.
+         */
+        quint32 session;
+
+        /**
+         * Time of the last received datagram, see {@link #datagramClock}.
+         */
+        qint64 lastActivity;
+    };
+
     /**
      * Stores the message to be broadcasted to make the clients
      * aware of our server.
      */
     QByteArray broadcastMessage;
 
+    /**
+     * The message a client sends to probe for available servers.
+     */
+    QByteArray probeMessage;
+
+    /**
+     * The number of announcements sent since the server was started.
+     */
+    int announcementCount;
+
     /**
      * Broadcast timer to send the messages regularly.
      */
@@ -85,15 +221,94 @@ private:
      */
     QUdpSocket* broadcastSocket;
 
+    /**
+     * Udp socket bound to the broadcast port that joined the IPv4 multicast
+     * group. Used to send multicast announcements and to answer probes.
+     * NULL if IPv4 discovery is not available.
+     */
+    QUdpSocket* discoverySocketIPv4;
+
+    /**
+     * Udp socket bound to the broadcast port that joined the IPv6 multicast
+     * group. NULL if IPv6 discovery is not available.
+     */
+    QUdpSocket* discoverySocketIPv6;
+
+    /**
+     * The parsed IPv4 multicast group address.
+     */
+    QHostAddress groupIPv4;
+
+    /**
+     * The parsed IPv6 multicast group address.
+     */
+    QHostAddress groupIPv6;
+
+    /**
+     * The cached broadcast addresses of our IPv4 interfaces.
+     */
+    QList<QHostAddress> broadcastAddresses;
+
+    /**
+     * The cached addresses and prefixes of our interfaces. Probes are only
+     * answered if they were sent from one of these networks.
+     */
+    QList<QNetworkAddressEntry> localNetworks;
+
+    /**
+     * The cached multicast capable interfaces that have an IPv4 address.
+     */
+    QList<QNetworkInterface> multicastInterfacesIPv4;
+
+    /**
+     * The cached multicast capable interfaces that have an IPv6 address.
+     */
+    QList<QNetworkInterface> multicastInterfacesIPv6;
+
+    /**
+     * Publishes our server via mdns. NULL if the server is not running.
+     */
+    MdnsResponder* mdnsResponder;
+
     /**
      * The tcp server for key command transmission.
      */
     QTcpServer* keyCommandServer;
 
     /**
-     * The connected clients.
+     * The port the tcp server listens on, 0 for a free port.
+     */
+    quint16 listenPort;
+
+    /**
+     * If the server should announce itself and answer probes.
+     */
+    bool discoveryEnabled;
+
+    /**
+     * If command datagrams should be accepted.
      */
-    QList<QTcpSocket*> clientSockets;
+    bool datagramCommandsEnabled;
+
+    /**
+     * The udp socket to receive command datagrams. NULL if not enabled.
+     */
+    QUdpSocket* commandSocket;
+
+    /**
+     * The clients that sent command datagrams, by address and port.
+     */
+    QHash<QString, DatagramPeer> datagramPeers;
+
+    /**
+     * Monotonic clock for the activity of datagram clients.
+     */
+    QElapsedTimer datagramClock;
+
+    /**
+     * The latest slide state event. Empty if no state was published yet.
+     */
+    QByteArray slideState;
 
     /**
      * Write a given message to the connected client.
@@ -102,12 +317,89 @@ private:
      */
     void write(const QString& message);
 
+    /**
+     * Sends a message to a single client.
+     *
+     * @param client The client.
+     * @param message The message to send.
+     */
+    void reply(ClientState& client, const QByteArray& message);
+
+    /**
+     * Sends the current slide state to a subscribed client.
+     *
+     * @param client The client that subscribed.
+     */
+    void handleSubscribed(ClientState& client);
+
+    /**
+     * Returns the source that is recorded in the flight recorder.
+     *
+     * @param client The client or NULL for command datagrams.
+     * @return The network source for connections, the datagram source
+     *         otherwise.
+     */
+    FlightRecorder::Source source(const ClientState* client) const;
+
+    /**
+     * Sends the latest slide state to a viewer if its socket is drained.
+     * Otherwise, the state is kept until the viewer read the previous one.
+     *
+     * @param client The viewer.
+     * @param event The state to send.
+     */
+    void sendSlideState(ClientState& client, const QByteArray& event);
+
+    /**
+     * Creates a discovery socket for the given protocol and joins the
+     * given multicast group.
+     *
+     * @param bindAddress The any address of the protocol to bind to.
+     * @param group The multicast group to join.
+     * @return The socket or NULL if the protocol is not available.
+     */
+    QUdpSocket* openDiscoverySocket(const QHostAddress& bindAddress,
+                                    const QHostAddress& group);
+
+    /**
+     * Reads the available network interfaces and updates the cached
+     * broadcast addresses and multicast interfaces. Joins the multicast
+     * groups on newly available interfaces.
+     */
+    void refreshInterfaces();
+
+    /**
+     * Checks if an address is on the local link, i.e. a loopback or
+     * link-local address or an address of one of our networks.
+     *
+     * @param address The address to check.
+     * @return True if the address is on the local link.
+     */
+    bool isOnLink(const QHostAddress& address) const;
+
+    /**
+     * Drops the state of datagram clients that were inactive for too long.
+     */
+    void pruneDatagramPeers();
+
 private slots:
     /**
      * Method to emit the presenter broadcast message.
      */
     void broadcastServerAvailablility();
 
+    /**
+     * Called if a datagram was received on a discovery socket. Answers
+     * probes from clients on the local link with our announcement message.
+     */
+    void readProbe();
+
+    /**
+     * Called if a command datagram was received. Acknowledges the datagram
+     * and handles the contained message if it is no duplicate.
+     */
+    void readCommandDatagram();
+
     /**
      * Called if a new client connected.
      */
@@ -122,6 +414,11 @@ private slots:
      * Called if new data is available to read.
      */
     virtual void readSocket();
+
+    /**
+     * Called if a viewer read data. Sends the pending slide state.
+     */
+    void viewerBytesWritten();
 };
 
 #endif /* SRC_MAIN_CONNECTOR_NETWORKCONNECTOR_H_ */
@@ -0,0 +1,86 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SequenceWindow.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "SequenceWindow.h"
+
+SequenceWindow::SequenceWindow() :
+    initialized(false), highestSequence(0), receivedMask(0)
+{}
+
+bool SequenceWindow::accept(quint32 sequence)
+{
+    // Unsigned differences, so wrap arounds are well defined. A sequence
+    // number is newer if it is less than half of the number space ahead.
+    quint32 distance = sequence - highestSequence;
+    if (initialized && distance != 0 && distance < 0x80000000u)
+    {
+        // Newer than everything seen so far, move the window
+        receivedMask = distance < quint32(size)
+                ? (receivedMask << distance) | 1 : 1;
+        highestSequence = sequence;
+        return true;
+    }
+
+    if (!initialized)
+    {
+        initialized = true;
+        highestSequence = sequence;
+        receivedMask = 1;
+        return true;
+    }
+
+    // Behind the window we don't know if it was received already
+    quint32 age = highestSequence - sequence;
+    if (age >= quint32(size))
+    {
+        return false;
+    }
+
+    quint64 bit = Q_UINT64_C(1) << age;
+    if (receivedMask & bit)
+    {
+        return false;
+    }
+
+    receivedMask |= bit;
+    return true;
+}
+
+void SequenceWindow::reset()
+{
+    initialized = false;
+    highestSequence = 0;
+    receivedMask = 0;
+}
+
+quint32 SequenceWindow::highest() const
+{
+    return highestSequence;
+}
+
+quint64 SequenceWindow::received() const
+{
+    return receivedMask;
+}
@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SequenceWindow.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_NETWORK_SEQUENCEWINDOW_H_
+#define SRC_MAIN_CONNECTOR_NETWORK_SEQUENCEWINDOW_H_
+
+#include <QtGlobal>
+
+/**
+ * A sliding window over sequence numbers to detect duplicated datagrams.
+ * Stores which of the last 64 sequence numbers were already received.
+ * Wrap arounds of the sequence number are handled by serial number
+ * arithmetic. Sequence numbers behind the window can't be told apart from
+ * duplicates, so they are rejected. A sender that starts over must be
+ * detected by other means and the window be reset.
+ */
+class SequenceWindow
+{
+    public:
+        /**
+         * Creates an empty window.
+         */
+        SequenceWindow();
+
+        /**
+         * Checks if a sequence number is new and marks it as received.
+         *
+         * @param sequence The received sequence number.
+         * @return True if the sequence number was not received before and
+         *         is not behind the window.
+         */
+        bool accept(quint32 sequence);
+
+        /**
+         * Forgets all received sequence numbers, so the next one is
+         * accepted in any case.
+         */
+        void reset();
+
+        /**
+         * Returns the highest received sequence number.
+         *
+         * @return The highest sequence number.
+         */
+        quint32 highest() const;
+
+        /**
+         * Returns the received sequence numbers relative to the highest one.
+         * Bit n is set if sequence number highest - n was received.
+         *
+         * @return The bit mask of received sequence numbers.
+         */
+        quint64 received() const;
+
+        /**
+         * The number of sequence numbers tracked by the window.
+         */
+        static const int size = 64;
+
+    private:
+        /**
+         * If a sequence number was received yet.
+         */
+        bool initialized;
+
+        /**
+         * The highest received sequence number.
+         */
+        quint32 highestSequence;
+
+        /**
+         * The received sequence numbers relative to the highest one.
+         */
+        quint64 receivedMask;
+};
+
+#endif /* SRC_MAIN_CONNECTOR_NETWORK_SEQUENCEWINDOW_H_ */
@@ -0,0 +1,593 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * WebSocketConnector.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "WebSocketConnector.h"
+
+#include <QCryptographicHash>
+
+#include "../../diagnostics/Tracer.h"
+
+// Next to the ports of the network connector
+const int WebSocketConnector::webSocketPort = 43157;
+
+// Browsers send the request right after connecting
+const int WebSocketConnector::handshakeTimeout = 5000;
+
+namespace
+{
+    // The websocket opcodes
+    const int opcodeContinuation = 0x0;
+    const int opcodeText = 0x1;
+    const int opcodeBinary = 0x2;
+    const int opcodeClose = 0x8;
+    const int opcodePing = 0x9;
+    const int opcodePong = 0xa;
+
+    // The websocket close codes
+    const quint16 closeNormal = 1000;
+    const quint16 closeProtocolError = 1002;
+    const quint16 closeTooBig = 1009;
+
+    // Defined by RFC 6455 to calculate the handshake response
+    const char* const handshakeGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    // A minimal remote control for browsers
+    const char* const remotePage = R"html(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<meta name="viewport" content="width=device-width, initial-scale=1">
+<title>Presenter</title>
+<style>
+body { margin: 0; height: 100vh; display: flex; flex-direction: column;
+       font-family: sans-serif; }
+div { display: flex; }
+button { flex: 1; margin: 4px; font-size: 2em; }
+</style>
+</head>
+<body>
+<button id="nextSlide" style="flex: 3">&rarr;</button>
+<button id="prevSlide">&larr;</button>
+<div>
+<button id="startPresentation">Start</button>
+<button id="stopPresentation">Stop</button>
+</div>
+<script>
+var socket = new WebSocket("ws://" + location.host + "/");
+var buttons = document.getElementsByTagName("button");
+for (var i = 0; i < buttons.length; i++) {
+    buttons[i].onclick = function() {
+        socket.send(JSON.stringify({ type: "command", data: this.id }));
+    };
+}
+</script>
+</body>
+</html>
+)html";
+}
+
+WebSocketConnector::WebSocketConnector(KeySender* keySender) :
+    RemoteControl(keySender), server(NULL), listenPort(webSocketPort),
+    handshakeTimer(this), closeRequested(false)
+{
+    connect(&handshakeTimer, SIGNAL(timeout()),
+                       this, SLOT(closeStalledHandshakes()));
+}
+
+WebSocketConnector::~WebSocketConnector()
+{
+    stopServer();
+}
+
+bool WebSocketConnector::start()
+{
+    server = new QTcpServer(this);
+    connect(server, SIGNAL(newConnection()), this, SLOT(clientConnected()));
+
+    if (!server->listen(QHostAddress::Any, listenPort))
+    {
+        emit error(tr("Did not start server. %1.").arg(server->errorString()));
+        return false;
+    }
+
+    handshakeTimer.start(1000);
+
+    emit info(tr("Browser remote available on port %1")
+              .arg(server->serverPort()));
+    return true;
+}
+
+void WebSocketConnector::setPort(quint16 port)
+{
+    listenPort = port;
+}
+
+quint16 WebSocketConnector::port() const
+{
+    return server ? server->serverPort() : 0;
+}
+
+FlightRecorder::Source WebSocketConnector::source(
+        const ClientState* client) const
+{
+    Q_UNUSED(client);
+
+    return FlightRecorder::WebSocket;
+}
+
+void WebSocketConnector::stop()
+{
+    handshakeTimer.stop();
+
+    // Close sockets without handling their disconnect signals
+    for (ClientState* client: clients)
+    {
+        client->connection->disconnect(this);
+        delete client->connection;
+    }
+    clients.clear();
+
+    delete server;
+    server = NULL;
+}
+
+void WebSocketConnector::write(const QString& message)
+{
+    QByteArray messageToSend(message.toUtf8());
+    for (ClientState* client: clients)
+    {
+        if (!client->pending)
+        {
+            reply(*client, messageToSend);
+        }
+    }
+}
+
+void WebSocketConnector::reply(ClientState& client, const QByteArray& message)
+{
+    sendFrame(static_cast<QTcpSocket*>(client.connection), opcodeText,
+              message.constData(), message.length());
+    client.bytesSent += message.length();
+}
+
+void WebSocketConnector::clientConnected()
+{
+    QTcpSocket *socket = server->nextPendingConnection();
+    if (!socket)
+    {
+        return;
+    }
+
+    // Our messages are tiny, so don't wait to fill up tcp segments. Keep
+    // idle connections of phones alive.
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
+
+    // The buffers keep their memory once reserved, so pooled states only
+    // allocate for the first client
+    ClientState* client = clients.add(socket,
+                                      socket->peerAddress().toString());
+    client->pending = true;
+    client->receiveBuffer.reserve(bufferSize);
+    client->messageBuffer.reserve(bufferSize);
+
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readSocket()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(clientDisconnected()));
+}
+
+void WebSocketConnector::clientDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket)
+    {
+        return;
+    }
+
+    ClientState* client = clients.find(socket);
+    if (client && !client->pending)
+    {
+        emit RemoteControl::clientDisconnected();
+    }
+
+    removeClient(client);
+    socket->deleteLater();
+}
+
+void WebSocketConnector::readSocket()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    ClientState* client = clients.find(socket);
+    if (!socket || !client)
+    {
+        return;
+    }
+
+    Tracer::beginTrace();
+    TraceSpan span("socket read");
+
+    closeRequested = false;
+    QByteArray& buffer = client->receiveBuffer;
+    while (!closeRequested && socket->bytesAvailable() > 0)
+    {
+        // Reading directly into the reserved buffer, so no copy is needed
+        int used = buffer.size();
+        buffer.resize(bufferSize);
+        qint64 read = socket->read(buffer.data() + used, bufferSize - used);
+        buffer.resize(used + int(qMax(read, qint64(0))));
+        if (read <= 0)
+        {
+            break;
+        }
+        client->bytesReceived += quint64(read);
+        client->lastActivity = clients.now();
+
+        if (client->pending)
+        {
+            handleHandshake(socket, client);
+        }
+        if (!client->pending && !closeRequested)
+        {
+            handleFrames(socket, client);
+        }
+    }
+
+    // Might delete the client, so this needs to be the last call
+    if (closeRequested)
+    {
+        socket->disconnectFromHost();
+    }
+}
+
+void WebSocketConnector::closeStalledHandshakes()
+{
+    // Aborting emits the disconnected signal, which removes the client,
+    // so the sockets are collected first
+    QList<QTcpSocket*> stalled;
+    for (ClientState* client: clients)
+    {
+        if (client->pending
+            && clients.now() - client->connectedTime >= handshakeTimeout)
+        {
+            stalled.append(static_cast<QTcpSocket*>(client->connection));
+        }
+    }
+
+    for (QTcpSocket* socket: stalled)
+    {
+        socket->abort();
+    }
+}
+
+void WebSocketConnector::handleHandshake(QTcpSocket* socket,
+                                         ClientState* client)
+{
+    QByteArray& received = client->receiveBuffer;
+    int end = received.indexOf("\r\n\r\n");
+    if (end < 0)
+    {
+        if (received.size() == bufferSize)
+        {
+            socket->write("HTTP/1.1 431 Request Header Fields Too Large\r\n"
+                          "Connection: close\r\n\r\n");
+            closeRequested = true;
+        }
+        return;
+    }
+
+    QList<QByteArray> lines = received.left(end).split('\n');
+    QByteArray key;
+    QByteArray host;
+    QByteArray origin;
+    QByteArray version;
+    bool upgrade = false;
+    bool connectionUpgrade = false;
+    for (int i = 1; i < lines.size(); i++)
+    {
+        int colon = lines[i].indexOf(':');
+        if (colon < 0)
+        {
+            continue;
+        }
+
+        QByteArray field = lines[i].left(colon).trimmed().toLower();
+        QByteArray value = lines[i].mid(colon + 1).trimmed();
+        if (field == "sec-websocket-key")
+        {
+            key = value;
+        }
+        else if (field == "upgrade")
+        {
+            upgrade = value.toLower() == "websocket";
+        }
+        else if (field == "connection")
+        {
+            // A list of tokens, e.g. "keep-alive, Upgrade" from firefox
+            QList<QByteArray> tokens = value.toLower().split(',');
+            for (int token = 0; token < tokens.size(); token++)
+            {
+                connectionUpgrade |= tokens[token].trimmed() == "upgrade";
+            }
+        }
+        else if (field == "host")
+        {
+            host = value;
+        }
+        else if (field == "origin")
+        {
+            origin = value;
+        }
+        else if (field == "sec-websocket-version")
+        {
+            version = value;
+        }
+    }
+
+    // Keep frames that were sent directly behind the request
+    received.remove(0, end + 4);
+
+    if (!lines.first().startsWith("GET "))
+    {
+        socket->write("HTTP/1.1 405 Method Not Allowed\r\n"
+                      "Connection: close\r\n\r\n");
+        closeRequested = true;
+        return;
+    }
+
+    if (!upgrade || !connectionUpgrade || key.isEmpty())
+    {
+        QByteArray page(remotePage);
+        socket->write("HTTP/1.1 200 OK\r\n"
+                      "Content-Type: text/html; charset=utf-8\r\n"
+                      "Content-Length: " + QByteArray::number(page.size())
+                      + "\r\nConnection: close\r\n\r\n" + page);
+        closeRequested = true;
+        return;
+    }
+
+    if (version != "13")
+    {
+        socket->write("HTTP/1.1 426 Upgrade Required\r\n"
+                      "Sec-WebSocket-Version: 13\r\n"
+                      "Connection: close\r\n\r\n");
+        closeRequested = true;
+        return;
+    }
+
+    // Browsers send the origin of the page that opens the socket. Only our
+    // own page may control the presentation, other pages the user visits
+    // could otherwise do so too. Other clients don't send an origin.
+    if (!origin.isEmpty() && origin.toLower() != "http://" + host.toLower())
+    {
+        socket->write("HTTP/1.1 403 Forbidden\r\n"
+                      "Connection: close\r\n\r\n");
+        closeRequested = true;
+        return;
+    }
+
+    // We don't offer any extensions. Compression does not pay off for our
+    // tiny messages.
+    QByteArray accept = QCryptographicHash::hash(key + handshakeGuid,
+            QCryptographicHash::Sha1).toBase64();
+    socket->write("HTTP/1.1 101 Switching Protocols\r\n"
+                  "Upgrade: websocket\r\n"
+                  "Connection: Upgrade\r\n"
+                  "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+    client->pending = false;
+
+    // Only the new client needs to know our version, the others already
+    // got it when they connected
+    reply(*client, versionMessage().toUtf8());
+
+    emit RemoteControl::clientConnected(client->name);
+}
+
+void WebSocketConnector::handleFrames(QTcpSocket* socket,
+                                      ClientState* client)
+{
+    TraceSpan span("framing");
+
+    int offset = 0;
+    while (!closeRequested)
+    {
+        uchar* frame = reinterpret_cast<uchar*>(client->receiveBuffer.data()
+                                                + offset);
+        int available = client->receiveBuffer.size() - offset;
+        if (available < 2)
+        {
+            break;
+        }
+
+        bool isFinal = frame[0] & 0x80;
+        int opcode = frame[0] & 0x0f;
+        bool masked = frame[1] & 0x80;
+        quint64 length = frame[1] & 0x7f;
+        int headerLength = 2;
+
+        if (length == 126)
+        {
+            if (available < 4)
+            {
+                break;
+            }
+            length = (quint64(frame[2]) << 8) | frame[3];
+            headerLength = 4;
+        }
+        else if (length == 127)
+        {
+            if (available < 10)
+            {
+                break;
+            }
+            length = 0;
+            for (int i = 2; i < 10; i++)
+            {
+                length = (length << 8) | frame[i];
+            }
+            headerLength = 10;
+        }
+
+        // Clients always need to mask their frames
+        if (!masked)
+        {
+            close(socket, closeProtocolError);
+            break;
+        }
+        if (length > quint64(bufferSize - 14))
+        {
+            close(socket, closeTooBig);
+            break;
+        }
+
+        headerLength += 4;
+        if (quint64(available) < headerLength + length)
+        {
+            break;
+        }
+
+        const uchar* mask = frame + headerLength - 4;
+        uchar* payload = frame + headerLength;
+        for (int i = 0; i < int(length); i++)
+        {
+            payload[i] ^= mask[i & 3];
+        }
+
+        handleFrame(socket, client, isFinal, opcode,
+                    reinterpret_cast<const char*>(payload), int(length));
+        offset += headerLength + int(length);
+    }
+
+    client->receiveBuffer.remove(0, offset);
+}
+
+void WebSocketConnector::handleFrame(QTcpSocket* socket, ClientState* client,
+                                     bool isFinal, int opcode,
+                                     const char* payload, int length)
+{
+    // Control frames may not be fragmented and are limited in size
+    if ((opcode & 0x8) && (!isFinal || length > 125))
+    {
+        close(socket, closeProtocolError);
+        return;
+    }
+
+    switch (opcode)
+    {
+        case opcodeText:
+        case opcodeBinary:
+        case opcodeContinuation:
+            if ((opcode == opcodeContinuation) != client->fragmented)
+            {
+                close(socket, closeProtocolError);
+            }
+            else if (isFinal && !client->fragmented && length > 0
+                     && payload[0] == motionPrefix)
+            {
+                // Decoded in place, moves arrive at the rate of the motion
+                handleMotion(*client, payload, length);
+            }
+            else if (isFinal && !client->fragmented)
+            {
+                client->messages++;
+                handleMessage(client->name,
+                              QString::fromUtf8(payload, length), client);
+            }
+            else if (client->messageBuffer.size() + length > bufferSize)
+            {
+                close(socket, closeTooBig);
+            }
+            else
+            {
+                client->messageBuffer.append(payload, length);
+                client->fragmented = !isFinal;
+
+                if (isFinal)
+                {
+                    client->messages++;
+                    handleMessage(client->name,
+                                  QString::fromUtf8(
+                                          client->messageBuffer.constData(),
+                                          client->messageBuffer.size()),
+                                  client);
+                    client->messageBuffer.resize(0);
+                }
+            }
+            break;
+
+        case opcodeClose:
+            close(socket, closeNormal);
+            break;
+
+        case opcodePing:
+            sendFrame(socket, opcodePong, payload, length);
+            break;
+
+        case opcodePong:
+            break;
+
+        default:
+            close(socket, closeProtocolError);
+            break;
+    }
+}
+
+void WebSocketConnector::sendFrame(QTcpSocket* socket, int opcode,
+                                   const char* payload, int length)
+{
+    // Server frames are not masked
+    char header[10];
+    int headerLength = 2;
+    header[0] = char(0x80 | opcode);
+
+    if (length < 126)
+    {
+        header[1] = char(length);
+    }
+    else if (length <= 0xffff)
+    {
+        header[1] = 126;
+        header[2] = char(length >> 8);
+        header[3] = char(length & 0xff);
+        headerLength = 4;
+    }
+    else
+    {
+        header[1] = 127;
+        for (int i = 0; i < 8; i++)
+        {
+            header[9 - i] = char((quint64(length) >> (8 * i)) & 0xff);
+        }
+        headerLength = 10;
+    }
+
+    socket->write(header, headerLength);
+    socket->write(payload, length);
+}
+
+void WebSocketConnector::close(QTcpSocket* socket, quint16 code)
+{
+    char payload[2] = { char(code >> 8), char(code & 0xff) };
+    sendFrame(socket, opcodeClose, payload, sizeof(payload));
+    closeRequested = true;
+}
@@ -0,0 +1,225 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * WebSocketConnector.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_CONNECTOR_WEBSOCKET_WEBSOCKETCONNECTOR_H_
+#define SRC_MAIN_CONNECTOR_WEBSOCKET_WEBSOCKETCONNECTOR_H_
+
+#include "../RemoteControl.h"
+
+#include <QTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/**
+ * A remote control class to control the presentation from a web browser.
+ * Serves a small remote control page and a websocket endpoint. Each text or
+ * binary websocket message contains one protocol message.
+ */
+class WebSocketConnector: public RemoteControl
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new websocket connector.
+         *
+         * @param keySender The key sender to use. If NULL, the key sender of
+         *                  the system will be used.
+         */
+        WebSocketConnector(KeySender* keySender = NULL);
+
+        /**
+         * Cleans up the websocket connector.
+         */
+        ~WebSocketConnector();
+
+        /**
+         * Sets the port of the websocket server. Used on the next start.
+         *
+         * @param port The port, 0 to choose a free port, e.g. for tests.
+         */
+        void setPort(quint16 port);
+
+        /**
+         * Returns the port the websocket server is listening on.
+         *
+         * @return The port, 0 if the server is not running.
+         */
+        quint16 port() const;
+
+        /**
+         * The default network port of the websocket server.
+         */
+        static const int webSocketPort;
+
+    protected:
+        /**
+         * Starts the server.
+         *
+         * @return True if the server is ready for connections.
+         */
+        bool start();
+
+        /**
+         * Stops the server and closes all connections.
+         */
+        void stop();
+
+        /**
+         * Returns the source that is recorded in the flight recorder.
+         *
+         * @param client The client, unused.
+         * @return The websocket source.
+         */
+        FlightRecorder::Source source(const ClientState* client) const;
+
+    private:
+        /**
+         * The size of the receive buffer of each client. Our messages are
+         * tiny, so bigger frames are rejected.
+         */
+        static const int bufferSize = 4096;
+
+        /**
+         * Time in milliseconds after which connections that did not
+         * complete the handshake are closed.
+         */
+        static const int handshakeTimeout;
+
+        /**
+         * The tcp server for the websocket connections.
+         */
+        QTcpServer* server;
+
+        /**
+         * The port to listen on.
+         */
+        quint16 listenPort;
+
+        /**
+         * Checks regularly for connections that did not complete the
+         * handshake in time.
+         */
+        QTimer handshakeTimer;
+
+        /**
+         * If the connection that is currently read should be closed after
+         * the read.
+         */
+        bool closeRequested;
+
+        /**
+         * Write a given message to all connected clients.
+         *
+         * @param message The message to write.
+         */
+        void write(const QString& message);
+
+        /**
+         * Sends a message to a single client as text frame.
+         *
+         * @param client The client.
+         * @param message The message to send.
+         */
+        void reply(ClientState& client, const QByteArray& message);
+
+        /**
+         * Handles the http request of a client. Upgrades the connection to a
+         * websocket or serves the remote control page. Websocket requests
+         * of browsers are only accepted from the page served here. Sends
+         * the version message to upgraded clients.
+         *
+         * @param socket The socket of the client.
+         * @param client The state of the client.
+         */
+        void handleHandshake(QTcpSocket* socket, ClientState* client);
+
+        /**
+         * Parses and handles all complete frames in the receive buffer.
+         * Frames are unmasked in place, so no memory is allocated.
+         *
+         * @param socket The socket of the client.
+         * @param client The state of the client.
+         */
+        void handleFrames(QTcpSocket* socket, ClientState* client);
+
+        /**
+         * Handles a single unmasked frame.
+         *
+         * @param socket The socket of the client.
+         * @param client The state of the client.
+         * @param isFinal If this is the last frame of a message.
+         * @param opcode The opcode of the frame.
+         * @param payload The payload of the frame.
+         * @param length The length of the payload.
+         */
+        void handleFrame(QTcpSocket* socket, ClientState* client,
+                         bool isFinal, int opcode, const char* payload,
+                         int length);
+
+        /**
+         * Sends a frame to a client.
+         *
+         * @param socket The socket of the client.
+         * @param opcode The opcode of the frame.
+         * @param payload The payload of the frame.
+         * @param length The length of the payload.
+         */
+        void sendFrame(QTcpSocket* socket, int opcode, const char* payload,
+                       int length);
+
+        /**
+         * Sends a close frame and closes the connection after the current
+         * read.
+         *
+         * @param socket The socket of the client.
+         * @param code The websocket close code.
+         */
+        void close(QTcpSocket* socket, quint16 code);
+
+    private slots:
+        /**
+         * Called if a new client connected.
+         */
+        void clientConnected();
+
+        /**
+         * Called if a client disconnected.
+         */
+        void clientDisconnected();
+
+        /**
+         * Called if new data is available to read.
+         */
+        void readSocket();
+
+        /**
+         * Closes the connections that did not complete the handshake in
+         * time, e.g. because they never sent a request.
+         */
+        void closeStalledHandshakes();
+};
+
+#endif /* SRC_MAIN_CONNECTOR_WEBSOCKET_WEBSOCKETCONNECTOR_H_ */
@@ -0,0 +1,143 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * EventLoopMonitor.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "EventLoopMonitor.h"
+
+#include <QCoreApplication>
+
+#include "Metrics.h"
+#include "StallProbe.h"
+
+const QEvent::Type EventLoopMonitor::measurementEvent =
+        QEvent::Type(QEvent::registerEventType());
+
+EventLoopMonitor::EventLoopMonitor(const QString& name, int interval,
+                                   int stallThreshold) :
+    loopName(name), interval(interval),
+    stallThreshold(qint64(stallThreshold) * 1000), timer(this), lastTick(0),
+    eventPosted(-1), queueDelay(0), maxLag(0)
+{
+    // Coarse timers may fire 5% late on purpose, which is not a lag
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+QString EventLoopMonitor::name() const
+{
+    return loopName;
+}
+
+qint64 EventLoopMonitor::maximumLag() const
+{
+    return maxLag;
+}
+
+void EventLoopMonitor::start()
+{
+    clock.start();
+    lastTick = now();
+    eventPosted = -1;
+    queueDelay = 0;
+
+    // Forget what happened before the monitor was running
+    const char* handler;
+    StallProbe::takeLongest(&handler);
+
+    timer.start(interval);
+}
+
+void EventLoopMonitor::stop()
+{
+    timer.stop();
+}
+
+qint64 EventLoopMonitor::now() const
+{
+    return clock.nsecsElapsed() / 1000;
+}
+
+void EventLoopMonitor::customEvent(QEvent* event)
+{
+    if (event->type() != measurementEvent)
+    {
+        QObject::customEvent(event);
+        return;
+    }
+
+    queueDelay = qMax(queueDelay, now() - eventPosted);
+    eventPosted = -1;
+}
+
+void EventLoopMonitor::tick()
+{
+    qint64 time = now();
+    qint64 drift = qMax(time - lastTick - interval * 1000, qint64(0));
+    lastTick = time;
+
+    // An event that is still queued is waiting at least since it was posted
+    qint64 delay = queueDelay;
+    if (eventPosted >= 0)
+    {
+        delay = qMax(delay, time - eventPosted);
+    }
+    queueDelay = 0;
+
+    qint64 lag = qMax(drift, delay);
+    maxLag = qMax(maxLag, lag);
+
+    const char* handler;
+    qint64 handlerTime = StallProbe::takeLongest(&handler);
+
+    Metrics* metrics = Metrics::instance();
+    if (metrics)
+    {
+        metrics->recordEventLoopLag(lag);
+    }
+
+    if (lag >= stallThreshold)
+    {
+        if (metrics)
+        {
+            metrics->countStall(loopName, handler);
+        }
+
+        QString cause = handler
+                ? QString("%1 ran for %2 ms").arg(handler)
+                      .arg(handlerTime / 1000)
+                : QString("no probed handler");
+        emit stalled(QString("Event loop %1 stalled for %2 ms "
+                             "(timer drift %3 ms, queue delay %4 ms), %5")
+                     .arg(loopName).arg(lag / 1000).arg(drift / 1000)
+                     .arg(delay / 1000).arg(cause));
+    }
+
+    // Only one measurement event is queued at a time, so a blocked loop
+    // does not fill its own queue
+    if (eventPosted < 0)
+    {
+        eventPosted = time;
+        QCoreApplication::postEvent(this, new QEvent(measurementEvent));
+    }
+}
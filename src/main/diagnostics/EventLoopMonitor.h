@@ -0,0 +1,178 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * EventLoopMonitor.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_EVENTLOOPMONITOR_H_
+#define SRC_MAIN_DIAGNOSTICS_EVENTLOOPMONITOR_H_
+
+#include <QEvent>
+#include <QTimer>
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+/**
+ * Measures the responsiveness of the event loop of the thread it lives in.
+ * A timer measures how late it fires and a posted event measures how long
+ * it waits in the event queue behind other events. If the event loop was
+ * blocked longer than the stall threshold, the longest {@link StallProbe}
+ * of the thread is reported as cause. The lag is added to the metrics.
+ */
+class EventLoopMonitor: public QObject
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * The default interval of the measurements in milliseconds.
+         */
+        static const int defaultInterval = 100;
+
+        /**
+         * The default lag in milliseconds from which on a stall is reported.
+         */
+        static const int defaultStallThreshold = 50;
+
+        /**
+         * Creates a new monitor. Move it to the thread to monitor and call
+         * {@link #start} in that thread.
+         *
+         * @param name The name of the monitored event loop.
+         * @param interval The interval of the measurements in milliseconds.
+         * @param stallThreshold The lag in milliseconds from which on a
+         *                       stall is reported.
+         */
+        EventLoopMonitor(const QString& name, int interval = defaultInterval,
+                         int stallThreshold = defaultStallThreshold);
+
+        /**
+         * Returns the name of the monitored event loop.
+         *
+         * @return The name.
+         */
+        QString name() const;
+
+        /**
+         * Returns the highest lag that was measured since the start.
+         *
+         * @return The lag in microseconds.
+         */
+        qint64 maximumLag() const;
+
+    public slots:
+        /**
+         * Starts the measurements.
+         */
+        void start();
+
+        /**
+         * Stops the measurements.
+         */
+        void stop();
+
+    signals:
+        /**
+         * Emitted if the event loop stalled.
+         *
+         * @param message The description of the stall and its cause.
+         */
+        void stalled(const QString& message);
+
+    protected:
+        /**
+         * Receives the posted measurement event.
+         *
+         * @param event The event.
+         */
+        void customEvent(QEvent* event);
+
+    private:
+        /**
+         * The type of the posted measurement event.
+         */
+        static const QEvent::Type measurementEvent;
+
+        /**
+         * The name of the monitored event loop.
+         */
+        QString loopName;
+
+        /**
+         * The interval of the measurements in milliseconds.
+         */
+        int interval;
+
+        /**
+         * The lag in microseconds from which on a stall is reported.
+         */
+        qint64 stallThreshold;
+
+        /**
+         * Triggers the measurements.
+         */
+        QTimer timer;
+
+        /**
+         * Monotonic clock of the measurements.
+         */
+        QElapsedTimer clock;
+
+        /**
+         * The time of the previous timer event in microseconds.
+         */
+        qint64 lastTick;
+
+        /**
+         * The time the measurement event was posted in microseconds, -1 if
+         * no event is queued.
+         */
+        qint64 eventPosted;
+
+        /**
+         * The highest queue delay since the previous timer event in
+         * microseconds.
+         */
+        qint64 queueDelay;
+
+        /**
+         * The highest lag since the start in microseconds.
+         */
+        qint64 maxLag;
+
+        /**
+         * Returns the current time of the clock.
+         *
+         * @return The time in microseconds.
+         */
+        qint64 now() const;
+
+    private slots:
+        /**
+         * Measures the timer drift, reports stalls and posts the next
+         * measurement event.
+         */
+        void tick();
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_EVENTLOOPMONITOR_H_ */
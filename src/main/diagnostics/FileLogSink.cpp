@@ -0,0 +1,341 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FileLogSink.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "FileLogSink.h"
+
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+
+#include <climits>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+// Maximum number of queued messages, further messages are dropped
+static const int maxQueuedMessages = 10000;
+
+// Interval in ms in which the written messages are synced to the disk
+static const int syncInterval = 1000;
+
+// The sink that receives the Qt messages
+static QAtomicPointer<FileLogSink> installedSink;
+
+// The number of handler calls that may still use the installed sink
+static QAtomicInt activeHandlers;
+
+// The handler that was installed before our handler
+static QtMessageHandler previousHandler = NULL;
+
+// If the messages are also passed to the previous handler
+static bool forwardMessages = true;
+
+/**
+ * Qt message handler that writes the messages to the installed sink.
+ */
+static void handleMessage(QtMsgType type, const QMessageLogContext& context,
+                          const QString& message)
+{
+    // Both operations are full barriers, so install either sees this
+    // call as active or this call sees the removed sink
+    activeHandlers.ref();
+    FileLogSink* sink = installedSink.fetchAndAddOrdered(0);
+    if (sink)
+    {
+        sink->write(type, context.category, message);
+    }
+    activeHandlers.deref();
+
+    if (forwardMessages && previousHandler)
+    {
+        previousHandler(type, context, message);
+    }
+}
+
+FileLogSink::FileLogSink(const QString& fileName, qint64 maxFileSize,
+                         int maxFiles) :
+    file(fileName), maxFileSize(maxFileSize), maxFiles(qMax(maxFiles, 1)),
+    fileSize(0), queue(), dropped(0), running(false)
+{}
+
+FileLogSink::~FileLogSink()
+{
+    if (installedSink.load() == this)
+    {
+        install(NULL);
+    }
+
+    close();
+}
+
+bool FileLogSink::openFile()
+{
+    #ifdef _WIN32
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        {
+            return false;
+        }
+        fileSize = file.size();
+    #else
+        // The daemon logs as root, so a planted link must not redirect the
+        // log to another file. The checks use the opened descriptor, the
+        // name could be replaced between a check and the open.
+        int fd = ::open(QFile::encodeName(file.fileName()).constData(),
+                        O_WRONLY | O_APPEND | O_CREAT | O_NOFOLLOW
+                        | O_CLOEXEC, 0640);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)
+            || status.st_nlink != 1
+            || !file.open(fd, QIODevice::WriteOnly | QIODevice::Append,
+                          QFileDevice::AutoCloseHandle))
+        {
+            ::close(fd);
+            return false;
+        }
+        fileSize = status.st_size;
+    #endif
+
+    return true;
+}
+
+bool FileLogSink::open()
+{
+    if (isRunning())
+    {
+        return true;
+    }
+
+    if (!openFile())
+    {
+        return false;
+    }
+
+    running = true;
+    start(QThread::LowPriority);
+
+    return true;
+}
+
+void FileLogSink::close()
+{
+    {
+        QMutexLocker locker(&mutex);
+        running = false;
+        queued.wakeOne();
+    }
+
+    wait();
+    file.close();
+}
+
+void FileLogSink::write(QtMsgType type, const char* category,
+                        const QString& message)
+{
+    QMutexLocker locker(&mutex);
+    if (!running)
+    {
+        return;
+    }
+
+    if (queue.size() >= maxQueuedMessages)
+    {
+        dropped++;
+        return;
+    }
+
+    Record record;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.type = type;
+    record.category = QString::fromLatin1(category ? category : "default");
+    record.message = message;
+    queue.append(record);
+
+    queued.wakeOne();
+}
+
+QString FileLogSink::fileName() const
+{
+    return file.fileName();
+}
+
+void FileLogSink::install(FileLogSink* sink, bool forward)
+{
+    forwardMessages = forward;
+    FileLogSink* previousSink = installedSink.fetchAndStoreOrdered(sink);
+    if (sink && !previousSink)
+    {
+        previousHandler = qInstallMessageHandler(handleMessage);
+    }
+    else if (!sink && previousSink)
+    {
+        qInstallMessageHandler(previousHandler);
+    }
+
+    // Other threads may still write to the previous sink, wait for them so
+    // that it can be deleted afterwards
+    while (previousSink && previousSink != sink
+           && activeHandlers.fetchAndAddOrdered(0) > 0)
+    {
+        QThread::yieldCurrentThread();
+    }
+}
+
+void FileLogSink::run()
+{
+    QVector<Record> batch;
+    QElapsedTimer lastSync;
+    lastSync.start();
+    bool unsynced = false;
+    bool keepRunning = true;
+
+    while (keepRunning)
+    {
+        int droppedMessages;
+        {
+            QMutexLocker locker(&mutex);
+            if (queue.isEmpty() && running)
+            {
+                queued.wait(&mutex, unsynced ? syncInterval : ULONG_MAX);
+            }
+
+            batch.swap(queue);
+            droppedMessages = dropped;
+            dropped = 0;
+            keepRunning = running;
+        }
+
+        if (droppedMessages > 0)
+        {
+            Record record;
+            record.timestamp = QDateTime::currentMSecsSinceEpoch();
+            record.type = QtWarningMsg;
+            record.category = "default";
+            record.message = QString("Dropped %1 log messages")
+                    .arg(droppedMessages);
+            batch.append(record);
+        }
+
+        for (const Record& record: batch)
+        {
+            fileSize += qMax(file.write(encode(record)), qint64(0));
+            if (fileSize >= maxFileSize)
+            {
+                rotate();
+            }
+        }
+
+        if (!batch.isEmpty())
+        {
+            file.flush();
+            unsynced = true;
+            batch.clear();
+        }
+
+        // Sync in batches, not for every message
+        if (unsynced && (lastSync.elapsed() >= syncInterval || !keepRunning))
+        {
+            sync();
+            lastSync.restart();
+            unsynced = false;
+        }
+    }
+}
+
+QByteArray FileLogSink::encode(const Record& record)
+{
+    QJsonObject object;
+    object["time"] = QDateTime::fromMSecsSinceEpoch(record.timestamp)
+            .toUTC().toString("yyyy-MM-dd'T'HH:mm:ss.zzz'Z'");
+
+    switch (record.type)
+    {
+        case QtDebugMsg:
+            object["level"] = QString("debug");
+            break;
+        case QtInfoMsg:
+            object["level"] = QString("info");
+            break;
+        case QtWarningMsg:
+            object["level"] = QString("warning");
+            break;
+        case QtCriticalMsg:
+            object["level"] = QString("critical");
+            break;
+        case QtFatalMsg:
+            object["level"] = QString("fatal");
+            break;
+    }
+
+    object["category"] = record.category;
+    object["message"] = record.message;
+
+    return QJsonDocument(object).toJson(QJsonDocument::Compact).append('\n');
+}
+
+void FileLogSink::sync()
+{
+    #ifdef _WIN32
+        FlushFileBuffers((HANDLE) _get_osfhandle(file.handle()));
+    #else
+        fsync(file.handle());
+    #endif
+}
+
+void FileLogSink::rotate()
+{
+    file.flush();
+    sync();
+    file.close();
+
+    // Shift the backups, the oldest one is overwritten
+    QString name = file.fileName();
+    QFile::remove(QString("%1.%2").arg(name).arg(maxFiles));
+    for (int i = maxFiles - 1; i >= 1; i--)
+    {
+        QFile::rename(QString("%1.%2").arg(name).arg(i),
+                      QString("%1.%2").arg(name).arg(i + 1));
+    }
+    QFile::rename(name, QString("%1.1").arg(name));
+
+    if (!openFile())
+    {
+        fileSize = 0;
+    }
+}
@@ -0,0 +1,212 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FileLogSink.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_FILELOGSINK_H_
+#define SRC_MAIN_DIAGNOSTICS_FILELOGSINK_H_
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+/**
+ * Writes log messages as JSON lines to a file. The messages are queued and
+ * written by a background thread, so logging never waits for the disk.
+ * The file is rotated once it reaches its maximum size and synced to the
+ * disk in batches.
+ */
+class FileLogSink: public QThread
+{
+    public:
+        /**
+         * Creates a new sink. Call {@link #open} to open the file.
+         *
+         * @param fileName The name of the log file.
+         * @param maxFileSize The size in bytes after which the file is
+         *                    rotated.
+         * @param maxFiles The number of rotated files that are kept.
+         */
+        FileLogSink(const QString& fileName, qint64 maxFileSize = 4194304,
+                    int maxFiles = 3);
+
+        /**
+         * Writes the queued messages and closes the file.
+         */
+        ~FileLogSink();
+
+        /**
+         * Opens the log file and starts the writer thread.
+         *
+         * @return False if the file could not be opened.
+         */
+        bool open();
+
+        /**
+         * Writes the queued messages, syncs the file and stops the writer
+         * thread.
+         */
+        void close();
+
+        /**
+         * Queues a message. Can be called from any thread. If the writer
+         * can't keep up, messages are dropped and the number of dropped
+         * messages is logged later.
+         *
+         * @param type The type of the message.
+         * @param category The category of the message.
+         * @param message The message.
+         */
+        void write(QtMsgType type, const char* category,
+                   const QString& message);
+
+        /**
+         * Returns the name of the log file.
+         *
+         * @return The file name.
+         */
+        QString fileName() const;
+
+        /**
+         * Installs a Qt message handler that writes all messages to the
+         * given sink.
+         *
+         * Once a sink is replaced or removed, no other thread writes to it
+         * anymore and it can be deleted.
+         *
+         * @param sink The sink or NULL to restore the previous handler.
+         * @param forward If the messages should also be passed to the
+         *                previous handler, e.g. to print them on stderr.
+         */
+        static void install(FileLogSink* sink, bool forward = true);
+
+    protected:
+        /**
+         * The writer thread.
+         */
+        void run();
+
+    private:
+        /**
+         * A queued message.
+         */
+        struct Record
+        {
+            /**
+             * The time the message was queued, in ms since the epoch.
+             */
+            qint64 timestamp;
+
+            /**
+             * The type of the message.
+             */
+            QtMsgType type;
+
+            /**
+             * The category of the message.
+             */
+            QString category;
+
+            /**
+             * The message.
+             */
+            QString message;
+        };
+
+        /**
+         * The log file.
+         */
+        QFile file;
+
+        /**
+         * The size in bytes after which the file is rotated.
+         */
+        qint64 maxFileSize;
+
+        /**
+         * The number of rotated files that are kept.
+         */
+        int maxFiles;
+
+        /**
+         * The current size of the log file.
+         */
+        qint64 fileSize;
+
+        /**
+         * Protects the queue and the running flag.
+         */
+        QMutex mutex;
+
+        /**
+         * Wakes up the writer once messages were queued.
+         */
+        QWaitCondition queued;
+
+        /**
+         * The messages that were not written yet.
+         */
+        QVector<Record> queue;
+
+        /**
+         * The number of messages that were dropped since the last write.
+         */
+        int dropped;
+
+        /**
+         * If the writer should keep running.
+         */
+        bool running;
+
+        /**
+         * Encodes a message as JSON line.
+         *
+         * @param record The message.
+         * @return The encoded line.
+         */
+        static QByteArray encode(const Record& record);
+
+        /**
+         * Opens the log file for appending and updates the file size.
+         * Links are not followed, so the file can't be redirected to
+         * another file.
+         *
+         * @return False if the file could not be opened.
+         */
+        bool openFile();
+
+        /**
+         * Writes the data of the file to the disk.
+         */
+        void sync();
+
+        /**
+         * Moves the current file to the first backup and opens a new file.
+         */
+        void rotate();
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_FILELOGSINK_H_ */
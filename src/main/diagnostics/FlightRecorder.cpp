@@ -0,0 +1,260 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FlightRecorder.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "FlightRecorder.h"
+
+#include <QDateTime>
+#include <QAtomicInteger>
+
+#include <string.h>
+
+// The records must have the same layout on all platforms
+static_assert(sizeof(FlightRecorderHeader) == 32,
+              "Unexpected flight recorder header size");
+static_assert(sizeof(FlightRecord) == 48,
+              "Unexpected flight record size");
+static_assert(sizeof(QAtomicInteger<quint64>) == sizeof(quint64),
+              "Sequence numbers can't be accessed atomically");
+
+/**
+ * Accesses a sequence number in the mapped file atomically. The sequence
+ * numbers are aligned to 8 bytes, since the file is mapped at a page
+ * boundary and the header and the records are multiples of 8 bytes.
+ */
+static QAtomicInteger<quint64>* atomic(quint64& sequence)
+{
+    return reinterpret_cast<QAtomicInteger<quint64>*>(&sequence);
+}
+
+const char FlightRecorder::magic[8] = { 'P', 'R', 'E', 'S', 'F', 'L', 'T',
+                                        'R' };
+
+const quint32 FlightRecorder::version = 1;
+
+FlightRecorder* FlightRecorder::currentInstance = NULL;
+
+FlightRecorder::FlightRecorder(const QString& fileName, quint32 capacity) :
+    file(fileName), capacity(qMax(capacity, quint32(1))), header(NULL),
+    records(NULL), openTime(0)
+{}
+
+FlightRecorder::~FlightRecorder()
+{
+    if (currentInstance == this)
+    {
+        currentInstance = NULL;
+    }
+
+    if (header)
+    {
+        file.unmap(reinterpret_cast<uchar*>(header));
+    }
+    file.close();
+}
+
+bool FlightRecorder::open()
+{
+    if (header)
+    {
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+
+    qint64 size = qint64(sizeof(FlightRecorderHeader))
+            + qint64(capacity) * qint64(sizeof(FlightRecord));
+    bool continueRing = false;
+    if (file.size() == size)
+    {
+        FlightRecorderHeader existing;
+        continueRing =
+                file.read(reinterpret_cast<char*>(&existing), sizeof(existing))
+                    == sizeof(existing)
+                && memcmp(existing.magic, magic, sizeof(magic)) == 0
+                && existing.version == version
+                && existing.recordSize == sizeof(FlightRecord)
+                && existing.capacity == capacity;
+    }
+
+    if (!continueRing && !file.resize(size))
+    {
+        file.close();
+        return false;
+    }
+
+    uchar* memory = file.map(0, size);
+    if (!memory)
+    {
+        file.close();
+        return false;
+    }
+
+    header = reinterpret_cast<FlightRecorderHeader*>(memory);
+    records = reinterpret_cast<FlightRecord*>(
+            memory + sizeof(FlightRecorderHeader));
+
+    if (!continueRing)
+    {
+        memset(memory, 0, size_t(size));
+        memcpy(header->magic, magic, sizeof(magic));
+        header->version = version;
+        header->recordSize = sizeof(FlightRecord);
+        header->capacity = capacity;
+        header->nextSequence = 1;
+    }
+
+    openTime = QDateTime::currentMSecsSinceEpoch() * 1000;
+    clock.start();
+
+    return true;
+}
+
+void FlightRecorder::record(Source source, quint32 clientId,
+                            const QString& client, Command command,
+                            Outcome outcome)
+{
+    if (!header)
+    {
+        return;
+    }
+
+    quint64 sequence = atomic(header->nextSequence)->fetchAndAddOrdered(1);
+    FlightRecord& record = records[(sequence - 1) % capacity];
+
+    // Mark the record as incomplete while it is written. The barrier keeps
+    // the following writes behind the mark.
+    atomic(record.sequence)->fetchAndStoreOrdered(0);
+    record.timestamp = openTime + clock.nsecsElapsed() / 1000;
+    record.clientId = clientId;
+    record.source = quint8(source);
+    record.command = quint8(command);
+    record.outcome = quint8(outcome);
+    record.reserved = 0;
+
+    // Keep the printable ascii part of the name, no conversion needed
+    int length = qMin(client.length(), int(sizeof(record.client)) - 1);
+    for (int i = 0; i < length; i++)
+    {
+        ushort character = client.at(i).unicode();
+        record.client[i] = character >= 0x20 && character < 0x7f
+                ? char(character) : '?';
+    }
+    record.client[length] = '\0';
+
+    // Publish the record after all of its fields were written
+    atomic(record.sequence)->storeRelease(sequence);
+}
+
+FlightRecorder::Command FlightRecorder::command(const QString& command)
+{
+    if (command == "nextSlide")
+    {
+        return NextSlide;
+    }
+    else if (command == "prevSlide")
+    {
+        return PrevSlide;
+    }
+    else if (command == "startPresentation")
+    {
+        return StartPresentation;
+    }
+    else if (command == "stopPresentation")
+    {
+        return StopPresentation;
+    }
+
+    return UnknownCommand;
+}
+
+const char* FlightRecorder::sourceName(quint8 source)
+{
+    switch (source)
+    {
+        case Bluetooth:
+            return "bluetooth";
+        case Network:
+            return "network";
+        case NetworkDatagram:
+            return "datagram";
+        case WebSocket:
+            return "websocket";
+        default:
+            return "unknown";
+    }
+}
+
+const char* FlightRecorder::commandName(quint8 command)
+{
+    switch (command)
+    {
+        case NextSlide:
+            return "nextSlide";
+        case PrevSlide:
+            return "prevSlide";
+        case StartPresentation:
+            return "startPresentation";
+        case StopPresentation:
+            return "stopPresentation";
+        case Subscribe:
+            return "subscribe";
+        case Schedule:
+            return "schedule";
+        case Cancel:
+            return "cancel";
+        default:
+            return "unknown";
+    }
+}
+
+const char* FlightRecorder::outcomeName(quint8 outcome)
+{
+    switch (outcome)
+    {
+        case Sent:
+            return "sent";
+        case Ignored:
+            return "ignored";
+        case Duplicate:
+            return "duplicate";
+        case Failed:
+            return "failed";
+        default:
+            return "unknown";
+    }
+}
+
+FlightRecorder* FlightRecorder::instance()
+{
+    return currentInstance;
+}
+
+void FlightRecorder::setInstance(FlightRecorder* recorder)
+{
+    currentInstance = recorder;
+}
@@ -0,0 +1,300 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FlightRecorder.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_FLIGHTRECORDER_H_
+#define SRC_MAIN_DIAGNOSTICS_FLIGHTRECORDER_H_
+
+#include <QFile>
+#include <QString>
+#include <QElapsedTimer>
+
+/**
+ * The header at the start of a flight recorder file.
+ */
+struct FlightRecorderHeader
+{
+    /**
+     * Identifies the file, see {@link FlightRecorder#magic}.
+     */
+    char magic[8];
+
+    /**
+     * The version of the file format.
+     */
+    quint32 version;
+
+    /**
+     * The size of a record in bytes.
+     */
+    quint32 recordSize;
+
+    /**
+     * The number of records in the ring.
+     */
+    quint32 capacity;
+
+    /**
+     * Unused, keeps the header aligned.
+     */
+    quint32 reserved;
+
+    /**
+     * The sequence number of the next record.
+     */
+    quint64 nextSequence;
+};
+
+/**
+ * A recorded command event.
+ */
+struct FlightRecord
+{
+    /**
+     * The sequence number of the record, starting at 1. 0 for unused or
+     * incomplete records. Written last when the record is recorded.
+     */
+    quint64 sequence;
+
+    /**
+     * The time of the event in microseconds since the epoch.
+     */
+    qint64 timestamp;
+
+    /**
+     * The connection id of the client, 0 if unknown.
+     */
+    quint32 clientId;
+
+    /**
+     * The connector that received the command, see
+     * {@link FlightRecorder#Source}.
+     */
+    quint8 source;
+
+    /**
+     * The command, see {@link FlightRecorder#Command}.
+     */
+    quint8 command;
+
+    /**
+     * The outcome, see {@link FlightRecorder#Outcome}.
+     */
+    quint8 outcome;
+
+    /**
+     * Unused, keeps the record aligned.
+     */
+    quint8 reserved;
+
+    /**
+     * The beginning of the client name, 0 terminated.
+     */
+    char client[24];
+};
+
+/**
+ * Records command events into a memory mapped ring file. Recording an event
+ * just fills a fixed size record in the mapped memory, there is no
+ * formatting and no system call. The events survive a crash of the server,
+ * since the operating system writes the mapped memory to the file. Use the
+ * flight dump tool to read the recorded events.
+ *
+ * The connectors record from their own threads without a lock. Each event
+ * atomically claims the next sequence number and its record. The sequence
+ * number of the record is published after the other fields, so readers
+ * can tell complete records from the ones that are being written.
+ */
+class FlightRecorder
+{
+    public:
+        /**
+         * The connector that received a command.
+         */
+        enum Source
+        {
+            UnknownSource = 0,
+            Bluetooth = 1,
+            Network = 2,
+            NetworkDatagram = 3,
+            WebSocket = 4
+        };
+
+        /**
+         * The received command.
+         */
+        enum Command
+        {
+            UnknownCommand = 0,
+            NextSlide = 1,
+            PrevSlide = 2,
+            StartPresentation = 3,
+            StopPresentation = 4,
+            Subscribe = 5,
+            Schedule = 6,
+            Cancel = 7
+        };
+
+        /**
+         * The outcome of a command.
+         */
+        enum Outcome
+        {
+            Sent = 0,
+            Ignored = 1,
+            Duplicate = 2,
+            Failed = 3
+        };
+
+        /**
+         * Creates a new recorder. Call {@link #open} to map the file.
+         *
+         * @param fileName The name of the ring file.
+         * @param capacity The number of records in the ring.
+         */
+        FlightRecorder(const QString& fileName, quint32 capacity = 65536);
+
+        /**
+         * Unmaps the ring file.
+         */
+        ~FlightRecorder();
+
+        /**
+         * Opens and maps the ring file. An existing ring with the same
+         * format is continued, otherwise the file is initialized.
+         *
+         * @return False if the file could not be mapped.
+         */
+        bool open();
+
+        /**
+         * Records an event. Does nothing if the recorder is not open.
+         *
+         * @param source The connector that received the command.
+         * @param clientId The connection id of the client, 0 if unknown.
+         * @param client The name of the client.
+         * @param command The command.
+         * @param outcome The outcome of the command.
+         */
+        void record(Source source, quint32 clientId, const QString& client,
+                    Command command, Outcome outcome);
+
+        /**
+         * Converts a protocol command to the recorded command.
+         *
+         * @param command The command of the protocol, e.g. "nextSlide".
+         * @return The recorded command.
+         */
+        static Command command(const QString& command);
+
+        /**
+         * Returns the name of a source.
+         *
+         * @param source The source.
+         * @return The name.
+         */
+        static const char* sourceName(quint8 source);
+
+        /**
+         * Returns the name of a command.
+         *
+         * @param command The command.
+         * @return The name.
+         */
+        static const char* commandName(quint8 command);
+
+        /**
+         * Returns the name of an outcome.
+         *
+         * @param outcome The outcome.
+         * @return The name.
+         */
+        static const char* outcomeName(quint8 outcome);
+
+        /**
+         * Returns the recorder used by the remote controls.
+         *
+         * @return The recorder or NULL if no recorder is used.
+         */
+        static FlightRecorder* instance();
+
+        /**
+         * Sets the recorder used by the remote controls.
+         *
+         * @param recorder The recorder or NULL to stop recording.
+         */
+        static void setInstance(FlightRecorder* recorder);
+
+        /**
+         * The identification of a ring file.
+         */
+        static const char magic[8];
+
+        /**
+         * The version of the file format.
+         */
+        static const quint32 version;
+
+    private:
+        /**
+         * The ring file.
+         */
+        QFile file;
+
+        /**
+         * The number of records in the ring.
+         */
+        quint32 capacity;
+
+        /**
+         * The mapped header, NULL if not open.
+         */
+        FlightRecorderHeader* header;
+
+        /**
+         * The mapped records, NULL if not open.
+         */
+        FlightRecord* records;
+
+        /**
+         * The time since the recorder was opened.
+         */
+        QElapsedTimer clock;
+
+        /**
+         * The time the recorder was opened, in microseconds since the epoch.
+         */
+        qint64 openTime;
+
+        /**
+         * The recorder used by the remote controls.
+         */
+        static FlightRecorder* currentInstance;
+
+        // The recorder owns the mapping, so it can't be copied
+        FlightRecorder(const FlightRecorder&);
+        FlightRecorder& operator=(const FlightRecorder&);
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_FLIGHTRECORDER_H_ */
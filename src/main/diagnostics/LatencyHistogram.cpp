@@ -0,0 +1,128 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LatencyHistogram.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "LatencyHistogram.h"
+
+#include <math.h>
+
+// From 50 microseconds, fast enough for key injection, to 2.5 seconds, e.g.
+// a blocked bluetooth stack
+const qint64 LatencyHistogram::bounds[bucketCount - 1] = {
+    50, 100, 250, 500,
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+    1000000, 2500000
+};
+
+LatencyHistogram::LatencyHistogram() :
+    total(0), totalTime(0), maximum(0)
+{}
+
+void LatencyHistogram::record(qint64 microseconds)
+{
+    if (microseconds < 0)
+    {
+        microseconds = 0;
+    }
+
+    int index = 0;
+    while (index < bucketCount - 1 && microseconds > bounds[index])
+    {
+        index++;
+    }
+
+    buckets[index].fetchAndAddRelaxed(1);
+    totalTime.fetchAndAddRelaxed(quint64(microseconds));
+    total.fetchAndAddRelaxed(1);
+
+    quint64 current = maximum.load();
+    while (quint64(microseconds) > current
+           && !maximum.testAndSetRelaxed(current, quint64(microseconds)))
+    {
+        current = maximum.load();
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < bucketCount; i++)
+    {
+        buckets[i].store(0);
+    }
+    total.store(0);
+    totalTime.store(0);
+    maximum.store(0);
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return total.load();
+}
+
+quint64 LatencyHistogram::sum() const
+{
+    return totalTime.load();
+}
+
+quint64 LatencyHistogram::bucket(int index) const
+{
+    return buckets[index].load();
+}
+
+qint64 LatencyHistogram::bound(int index)
+{
+    return index < bucketCount - 1 ? bounds[index] : -1;
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const
+{
+    quint64 counted = 0;
+    for (int i = 0; i < bucketCount; i++)
+    {
+        counted += buckets[i].load();
+    }
+    if (counted == 0)
+    {
+        return -1;
+    }
+
+    // The rank of the percentile, starting at 1
+    quint64 rank = quint64(ceil(fraction * counted));
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+
+    quint64 seen = 0;
+    for (int i = 0; i < bucketCount - 1; i++)
+    {
+        seen += buckets[i].load();
+        if (seen >= rank)
+        {
+            return bounds[i];
+        }
+    }
+
+    return qint64(maximum.load());
+}
@@ -0,0 +1,130 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LatencyHistogram.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_LATENCYHISTOGRAM_H_
+#define SRC_MAIN_DIAGNOSTICS_LATENCYHISTOGRAM_H_
+
+#include <QAtomicInteger>
+
+/**
+ * Counts latencies in fixed buckets. Recording and reading use atomic
+ * counters only, so a histogram can be filled in one thread and read in
+ * another one without locks. Reads that race with recording may see a
+ * value that is off by the concurrent recordings.
+ */
+class LatencyHistogram
+{
+    public:
+        /**
+         * The number of buckets, including the overflow bucket.
+         */
+        static const int bucketCount = 16;
+
+        /**
+         * Creates an empty histogram.
+         */
+        LatencyHistogram();
+
+        /**
+         * Counts a latency.
+         *
+         * @param microseconds The latency in microseconds.
+         */
+        void record(qint64 microseconds);
+
+        /**
+         * Removes all counted latencies. Not thread safe regarding
+         * concurrent recordings.
+         */
+        void reset();
+
+        /**
+         * Returns the number of counted latencies.
+         *
+         * @return The number of latencies.
+         */
+        quint64 count() const;
+
+        /**
+         * Returns the sum of all counted latencies.
+         *
+         * @return The sum in microseconds.
+         */
+        quint64 sum() const;
+
+        /**
+         * Returns the number of latencies in a bucket.
+         *
+         * @param index The index of the bucket.
+         * @return The number of latencies that fell into the bucket.
+         */
+        quint64 bucket(int index) const;
+
+        /**
+         * Returns the upper bound of a bucket.
+         *
+         * @param index The index of the bucket.
+         * @return The upper bound in microseconds, -1 for the overflow
+         *         bucket.
+         */
+        static qint64 bound(int index);
+
+        /**
+         * Estimates a percentile as the upper bound of the bucket that
+         * contains it. For the overflow bucket, the maximum is returned.
+         *
+         * @param fraction The percentile as fraction, e.g. 0.99.
+         * @return The latency in microseconds or -1 if nothing was counted.
+         */
+        qint64 percentile(double fraction) const;
+
+    private:
+        /**
+         * The upper bounds of the buckets, except the overflow bucket.
+         */
+        static const qint64 bounds[bucketCount - 1];
+
+        /**
+         * The number of latencies per bucket.
+         */
+        QAtomicInteger<quint64> buckets[bucketCount];
+
+        /**
+         * The number of latencies.
+         */
+        QAtomicInteger<quint64> total;
+
+        /**
+         * The sum of the latencies in microseconds.
+         */
+        QAtomicInteger<quint64> totalTime;
+
+        /**
+         * The largest latency in microseconds.
+         */
+        QAtomicInteger<quint64> maximum;
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_LATENCYHISTOGRAM_H_ */
@@ -0,0 +1,224 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Metrics.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "Metrics.h"
+
+#include <QMutexLocker>
+
+Metrics* Metrics::currentInstance = NULL;
+
+Metrics::Metrics() :
+    injectionErrors(0), beacons(0), pointerMoves(0)
+{}
+
+void Metrics::addConnectedClients(FlightRecorder::Source source, int delta)
+{
+    connectedClients[source].fetchAndAddRelaxed(delta);
+}
+
+void Metrics::countCommand(FlightRecorder::Command command,
+                           FlightRecorder::Outcome outcome)
+{
+    commands[command][outcome].fetchAndAddRelaxed(1);
+}
+
+void Metrics::countInjectionErrors(int count)
+{
+    injectionErrors.fetchAndAddRelaxed(quint64(count));
+}
+
+void Metrics::countBeacons(int count)
+{
+    beacons.fetchAndAddRelaxed(quint64(count));
+}
+
+void Metrics::recordCommandLatency(qint64 microseconds)
+{
+    commandLatency.record(microseconds);
+}
+
+void Metrics::recordRoundTrip(qint64 microseconds)
+{
+    roundTrip.record(microseconds);
+}
+
+void Metrics::countPointerMoves()
+{
+    pointerMoves.fetchAndAddRelaxed(1);
+}
+
+void Metrics::recordEventLoopLag(qint64 microseconds)
+{
+    eventLoopLag.record(microseconds);
+}
+
+void Metrics::countStall(const QString& loop, const char* handler)
+{
+    QByteArray labels = "loop=\"" + loop.toUtf8() + "\",handler=\""
+            + (handler ? handler : "unknown") + "\"";
+
+    QMutexLocker locker(&stallsMutex);
+    stalls[labels]++;
+}
+
+QByteArray Metrics::render() const
+{
+    QByteArray out;
+    out.reserve(4096);
+
+    appendHeader(out, "presenter_connected_clients", "gauge",
+                 "Connected clients by connector.");
+    for (int source = FlightRecorder::Bluetooth; source < sourceCount;
+         source++)
+    {
+        // Datagram clients don't connect
+        if (source != FlightRecorder::NetworkDatagram)
+        {
+            appendSample(out, "presenter_connected_clients",
+                         QByteArray("connector=\"")
+                             + FlightRecorder::sourceName(source) + "\"",
+                         quint64(qMax(connectedClients[source].load(), 0)));
+        }
+    }
+
+    // Only commands that were received are rendered
+    appendHeader(out, "presenter_commands_total", "counter",
+                 "Received commands by type and outcome.");
+    for (int command = 0; command < commandCount; command++)
+    {
+        for (int outcome = 0; outcome < outcomeCount; outcome++)
+        {
+            quint64 count = commands[command][outcome].load();
+            if (count > 0)
+            {
+                appendSample(out, "presenter_commands_total",
+                             QByteArray("command=\"")
+                                 + FlightRecorder::commandName(command)
+                                 + "\",outcome=\""
+                                 + FlightRecorder::outcomeName(outcome)
+                                 + "\"",
+                             count);
+            }
+        }
+    }
+
+    appendHeader(out, "presenter_injection_errors_total", "counter",
+                 "Key injections that failed.");
+    appendSample(out, "presenter_injection_errors_total", QByteArray(),
+                 injectionErrors.load());
+
+    appendHeader(out, "presenter_discovery_beacons_total", "counter",
+                 "Sent discovery announcements.");
+    appendSample(out, "presenter_discovery_beacons_total", QByteArray(),
+                 beacons.load());
+
+    appendHeader(out, "presenter_pointer_moves_total", "counter",
+                 "Received pointer moves.");
+    appendSample(out, "presenter_pointer_moves_total", QByteArray(),
+                 pointerMoves.load());
+
+    appendHistogram(out, "presenter_command_latency_seconds",
+                    "Time to handle a command including the key injection.",
+                    commandLatency);
+
+    appendHistogram(out, "presenter_client_round_trip_seconds",
+                    "Network round trip time to the clients, measured by the "
+                    "time synchronization.",
+                    roundTrip);
+
+    appendHistogram(out, "presenter_event_loop_lag_seconds",
+                    "Timer drift and queue delay of the event loops.",
+                    eventLoopLag);
+
+    appendHeader(out, "presenter_event_loop_stalls_total", "counter",
+                 "Event loop stalls by the handler that caused them.");
+    QMutexLocker locker(&stallsMutex);
+    for (QMap<QByteArray, quint64>::const_iterator stall = stalls.begin();
+         stall != stalls.end(); ++stall)
+    {
+        appendSample(out, "presenter_event_loop_stalls_total", stall.key(),
+                     stall.value());
+    }
+
+    return out;
+}
+
+void Metrics::appendHeader(QByteArray& out, const char* name,
+                           const char* type, const char* help)
+{
+    out.append("# HELP ").append(name).append(' ').append(help).append('\n');
+    out.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+}
+
+void Metrics::appendSample(QByteArray& out, const char* name,
+                           const QByteArray& labels, quint64 value)
+{
+    out.append(name);
+    if (!labels.isEmpty())
+    {
+        out.append('{').append(labels).append('}');
+    }
+    out.append(' ').append(QByteArray::number(value)).append('\n');
+}
+
+void Metrics::appendHistogram(QByteArray& out, const char* name,
+                              const char* help,
+                              const LatencyHistogram& histogram)
+{
+    appendHeader(out, name, "histogram", help);
+
+    // Prometheus buckets are cumulative
+    QByteArray bucketName = QByteArray(name) + "_bucket";
+    quint64 cumulative = 0;
+    for (int i = 0; i < LatencyHistogram::bucketCount; i++)
+    {
+        cumulative += histogram.bucket(i);
+        qint64 bound = LatencyHistogram::bound(i);
+        QByteArray label = bound < 0
+                ? QByteArray("+Inf")
+                : QByteArray::number(bound / 1000000.0, 'g', 6);
+        appendSample(out, bucketName.constData(), "le=\"" + label + "\"",
+                     cumulative);
+    }
+
+    out.append(name).append("_sum ")
+       .append(QByteArray::number(histogram.sum() / 1000000.0, 'g', 12))
+       .append('\n');
+
+    // The count must match the buckets, even if a latency was recorded
+    // while rendering
+    appendSample(out, (QByteArray(name) + "_count").constData(), QByteArray(),
+                 cumulative);
+}
+
+Metrics* Metrics::instance()
+{
+    return currentInstance;
+}
+
+void Metrics::setInstance(Metrics* metrics)
+{
+    currentInstance = metrics;
+}
@@ -0,0 +1,245 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Metrics.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_METRICS_H_
+#define SRC_MAIN_DIAGNOSTICS_METRICS_H_
+
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QByteArray>
+#include <QAtomicInteger>
+
+#include "FlightRecorder.h"
+#include "LatencyHistogram.h"
+
+/**
+ * Operational metrics of the server. All values are atomic counters, so they
+ * can be updated in the connector threads and rendered in another thread
+ * without locks. The metrics are rendered in the Prometheus text format.
+ */
+class Metrics
+{
+    public:
+        /**
+         * The number of sources, see {@link FlightRecorder#Source}.
+         */
+        static const int sourceCount = FlightRecorder::WebSocket + 1;
+
+        /**
+         * The number of commands, see {@link FlightRecorder#Command}.
+         */
+        static const int commandCount = FlightRecorder::Cancel + 1;
+
+        /**
+         * The number of outcomes, see {@link FlightRecorder#Outcome}.
+         */
+        static const int outcomeCount = FlightRecorder::Failed + 1;
+
+        /**
+         * Creates metrics with all counters at zero.
+         */
+        Metrics();
+
+        /**
+         * Changes the number of connected clients of a source.
+         *
+         * @param source The source of the clients.
+         * @param delta The number of clients that connected, negative if
+         *              clients disconnected.
+         */
+        void addConnectedClients(FlightRecorder::Source source, int delta);
+
+        /**
+         * Counts a received command.
+         *
+         * @param command The command.
+         * @param outcome The outcome of the command.
+         */
+        void countCommand(FlightRecorder::Command command,
+                          FlightRecorder::Outcome outcome);
+
+        /**
+         * Counts failed key injections.
+         *
+         * @param count The number of failed injections.
+         */
+        void countInjectionErrors(int count = 1);
+
+        /**
+         * Counts sent discovery announcements.
+         *
+         * @param count The number of sent datagrams.
+         */
+        void countBeacons(int count);
+
+        /**
+         * Counts the time to handle a command, including the key injection.
+         *
+         * @param microseconds The time in microseconds.
+         */
+        void recordCommandLatency(qint64 microseconds);
+
+        /**
+         * Records the network round trip time of a client, measured by the
+         * time synchronization.
+         *
+         * @param microseconds The time in microseconds.
+         */
+        void recordRoundTrip(qint64 microseconds);
+
+        /**
+         * Counts a pointer move of a client.
+         */
+        void countPointerMoves();
+
+        /**
+         * Counts the lag of an event loop, see {@link EventLoopMonitor}.
+         *
+         * @param microseconds The lag in microseconds.
+         */
+        void recordEventLoopLag(qint64 microseconds);
+
+        /**
+         * Counts a stall of an event loop.
+         *
+         * @param loop The name of the event loop.
+         * @param handler The handler that caused the stall, NULL if unknown.
+         */
+        void countStall(const QString& loop, const char* handler);
+
+        /**
+         * Renders all metrics in the Prometheus text format.
+         *
+         * @return The rendered metrics.
+         */
+        QByteArray render() const;
+
+        /**
+         * Appends the help and type lines of a metric.
+         *
+         * @param out The rendered metrics.
+         * @param name The name of the metric.
+         * @param type The type, e.g. "counter".
+         * @param help The description of the metric.
+         */
+        static void appendHeader(QByteArray& out, const char* name,
+                                 const char* type, const char* help);
+
+        /**
+         * Appends a sample of a metric.
+         *
+         * @param out The rendered metrics.
+         * @param name The name of the metric.
+         * @param labels The labels without braces or NULL.
+         * @param value The value.
+         */
+        static void appendSample(QByteArray& out, const char* name,
+                                 const QByteArray& labels, quint64 value);
+
+        /**
+         * Appends a histogram, converted to seconds.
+         *
+         * @param out The rendered metrics.
+         * @param name The name of the metric.
+         * @param help The description of the metric.
+         * @param histogram The histogram.
+         */
+        static void appendHistogram(QByteArray& out, const char* name,
+                                    const char* help,
+                                    const LatencyHistogram& histogram);
+
+        /**
+         * Returns the metrics used by the connectors.
+         *
+         * @return The metrics or NULL if no metrics are collected.
+         */
+        static Metrics* instance();
+
+        /**
+         * Sets the metrics used by the connectors.
+         *
+         * @param metrics The metrics or NULL to stop collecting.
+         */
+        static void setInstance(Metrics* metrics);
+
+    private:
+        /**
+         * The number of connected clients per source.
+         */
+        QAtomicInt connectedClients[sourceCount];
+
+        /**
+         * The number of commands per command and outcome.
+         */
+        QAtomicInteger<quint64> commands[commandCount][outcomeCount];
+
+        /**
+         * The number of failed key injections.
+         */
+        QAtomicInteger<quint64> injectionErrors;
+
+        /**
+         * The number of sent discovery announcements.
+         */
+        QAtomicInteger<quint64> beacons;
+
+        /**
+         * The number of received pointer moves.
+         */
+        QAtomicInteger<quint64> pointerMoves;
+
+        /**
+         * The time to handle the commands.
+         */
+        LatencyHistogram commandLatency;
+
+        /**
+         * The network round trip times to the clients.
+         */
+        LatencyHistogram roundTrip;
+
+        /**
+         * The lag of the event loops.
+         */
+        LatencyHistogram eventLoopLag;
+
+        /**
+         * Protects the stalls. Stalls are rare, so a lock is fine.
+         */
+        mutable QMutex stallsMutex;
+
+        /**
+         * The number of stalls by their rendered labels.
+         */
+        QMap<QByteArray, quint64> stalls;
+
+        /**
+         * The metrics used by the connectors.
+         */
+        static Metrics* currentInstance;
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_METRICS_H_ */
@@ -0,0 +1,216 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * MetricsServer.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "MetricsServer.h"
+
+#include <QTcpServer>
+#include <QHostAddress>
+
+// Interval in ms in which the server checks if it should stop
+static const int pollInterval = 100;
+
+// Maximum size of a request header, longer requests are rejected
+static const int maxRequestSize = 8192;
+
+MetricsServer::MetricsServer(const Metrics* metrics, quint16 port) :
+    metrics(metrics), port(port), daemonPort(0), listeningPort(0),
+    daemon(NULL)
+{}
+
+MetricsServer::~MetricsServer()
+{
+    close();
+}
+
+void MetricsServer::setDaemonPort(quint16 port)
+{
+    daemonPort = port;
+}
+
+bool MetricsServer::open()
+{
+    if (isRunning())
+    {
+        return true;
+    }
+
+    start(QThread::LowPriority);
+    started.acquire();
+
+    if (listeningPort == 0)
+    {
+        wait();
+        return false;
+    }
+    return true;
+}
+
+void MetricsServer::close()
+{
+    if (isRunning())
+    {
+        requestInterruption();
+        wait();
+    }
+    listeningPort = 0;
+}
+
+quint16 MetricsServer::serverPort() const
+{
+    return listeningPort;
+}
+
+QString MetricsServer::errorString() const
+{
+    return error;
+}
+
+void MetricsServer::run()
+{
+    // Only reachable from this machine, scrape it via an exporter proxy or
+    // ssh tunnel if needed
+    QTcpServer server;
+    if (!server.listen(QHostAddress::LocalHost, port))
+    {
+        error = server.errorString();
+        started.release();
+        return;
+    }
+    listeningPort = server.serverPort();
+    started.release();
+
+    // Created in this thread, since the socket is used without event loop
+    QTcpSocket daemonSocket;
+    daemon = &daemonSocket;
+
+    while (!isInterruptionRequested())
+    {
+        if (!server.waitForNewConnection(pollInterval))
+        {
+            continue;
+        }
+
+        // Scrapes are rare, so clients are handled one after another
+        QTcpSocket* socket = server.nextPendingConnection();
+        handleRequest(*socket);
+        delete socket;
+    }
+
+    daemon = NULL;
+}
+
+void MetricsServer::handleRequest(QTcpSocket& socket)
+{
+    QByteArray request;
+    while (!request.contains("\r\n\r\n") && !request.contains("\n\n"))
+    {
+        if (request.size() > maxRequestSize
+            || !socket.waitForReadyRead(ioTimeout))
+        {
+            return;
+        }
+        request.append(socket.readAll());
+    }
+
+    QList<QByteArray> requestLine =
+            request.left(request.indexOf('\n')).trimmed().split(' ');
+    QByteArray status;
+    QByteArray body;
+    if (requestLine.size() >= 2 && requestLine[0] == "GET"
+        && (requestLine[1] == "/metrics" || requestLine[1] == "/"))
+    {
+        status = "200 OK";
+        body = metrics->render();
+        body.append(daemonStatistics());
+    }
+    else
+    {
+        status = "404 Not Found";
+        body = "Not found\n";
+    }
+
+    socket.write("HTTP/1.1 " + status + "\r\n"
+                 "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                 "Content-Length: " + QByteArray::number(body.size())
+                     + "\r\n"
+                 "Connection: close\r\n\r\n");
+    socket.write(body);
+    socket.disconnectFromHost();
+    if (socket.state() != QAbstractSocket::UnconnectedState)
+    {
+        socket.waitForDisconnected(ioTimeout);
+    }
+}
+
+QByteArray MetricsServer::daemonStatistics()
+{
+    if (daemonPort == 0)
+    {
+        return QByteArray();
+    }
+
+    // The daemon may have closed a reused connection, e.g. after a
+    // restart, so a reused connection is retried once with a new one
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        bool reused = daemon->state() == QAbstractSocket::ConnectedState;
+        if (!reused)
+        {
+            daemon->abort();
+            daemon->connectToHost(QHostAddress::LocalHost, daemonPort);
+            if (!daemon->waitForConnected(ioTimeout))
+            {
+                daemon->abort();
+                return QByteArray();
+            }
+        }
+
+        daemon->write("stats\n");
+
+        // The daemon terminates its statistics with an eof marker
+        QByteArray statistics;
+        while (!statistics.endsWith("# EOF\n")
+               && daemon->waitForReadyRead(ioTimeout))
+        {
+            statistics.append(daemon->readAll());
+        }
+
+        if (statistics.endsWith("# EOF\n"))
+        {
+            statistics.chop(6);
+            return statistics;
+        }
+
+        // A late answer would mix with the next one, so the connection
+        // is not used anymore
+        daemon->abort();
+        if (!reused)
+        {
+            break;
+        }
+    }
+
+    return QByteArray();
+}
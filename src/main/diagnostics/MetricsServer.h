@@ -0,0 +1,160 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * MetricsServer.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_METRICSSERVER_H_
+#define SRC_MAIN_DIAGNOSTICS_METRICSSERVER_H_
+
+#include <QString>
+#include <QThread>
+#include <QSemaphore>
+#include <QTcpSocket>
+
+#include "Metrics.h"
+
+/**
+ * Serves the metrics via http on the loopback interface, so they can be
+ * scraped by Prometheus. The server runs in its own thread without an event
+ * loop, so scraping never touches the gui thread. If a key sender daemon is
+ * used, its statistics are queried and appended to the metrics.
+ */
+class MetricsServer: public QThread
+{
+    public:
+        /**
+         * Creates a new server. Call {@link #open} to start it.
+         *
+         * @param metrics The metrics to serve.
+         * @param port The port to listen on, 0 for any free port.
+         */
+        MetricsServer(const Metrics* metrics, quint16 port);
+
+        /**
+         * Stops the server.
+         */
+        ~MetricsServer();
+
+        /**
+         * Sets the port of the key sender daemon whose statistics are
+         * appended to the metrics.
+         *
+         * @param port The port of the daemon, 0 if no daemon is used.
+         */
+        void setDaemonPort(quint16 port);
+
+        /**
+         * Starts the server thread and waits until it is listening.
+         *
+         * @return False if the server could not listen on the port.
+         */
+        bool open();
+
+        /**
+         * Stops the server thread.
+         */
+        void close();
+
+        /**
+         * Returns the port the server is listening on.
+         *
+         * @return The port, 0 if the server is not listening.
+         */
+        quint16 serverPort() const;
+
+        /**
+         * Returns the error that occurred while opening the server.
+         *
+         * @return The error message.
+         */
+        QString errorString() const;
+
+    protected:
+        /**
+         * The server thread.
+         */
+        void run();
+
+    private:
+        /**
+         * Time in milliseconds a client or the daemon may take to send its
+         * data.
+         */
+        static const int ioTimeout = 1000;
+
+        /**
+         * The metrics to serve.
+         */
+        const Metrics* metrics;
+
+        /**
+         * The port to listen on.
+         */
+        quint16 port;
+
+        /**
+         * The port of the key sender daemon, 0 if no daemon is used.
+         */
+        quint16 daemonPort;
+
+        /**
+         * The port the server is listening on.
+         */
+        quint16 listeningPort;
+
+        /**
+         * The error that occurred while opening the server.
+         */
+        QString error;
+
+        /**
+         * Released by the server thread once it is listening or failed.
+         */
+        QSemaphore started;
+
+        /**
+         * The connection to the key sender daemon, kept open between the
+         * scrapes. Only used by the server thread, NULL while the server is
+         * not running.
+         */
+        QTcpSocket* daemon;
+
+        /**
+         * Answers a single request.
+         *
+         * @param socket The connection of the client.
+         */
+        void handleRequest(QTcpSocket& socket);
+
+        /**
+         * Queries the statistics of the key sender daemon. Connects to the
+         * daemon if not connected yet, the connection is reused for the
+         * following queries.
+         *
+         * @return The statistics in the Prometheus text format, empty if the
+         *         daemon is not available.
+         */
+        QByteArray daemonStatistics();
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_METRICSSERVER_H_ */
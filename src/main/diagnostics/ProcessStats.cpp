@@ -0,0 +1,118 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ProcessStats.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ProcessStats.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <stdio.h>
+    #include <stdlib.h>
+    #include <unistd.h>
+    #include <dirent.h>
+#endif
+
+#ifdef __GLIBC__
+    #include <malloc.h>
+#endif
+
+qint64 ProcessStats::residentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters)))
+    {
+        return -1;
+    }
+
+    return counters.WorkingSetSize;
+#else
+    // The second value is the number of resident pages
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL)
+    {
+        return -1;
+    }
+
+    long long size = 0;
+    long long resident = 0;
+    int read = fscanf(statm, "%lld %lld", &size, &resident);
+    fclose(statm);
+    if (read != 2)
+    {
+        return -1;
+    }
+
+    return resident * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+qint64 ProcessStats::heapBytes()
+{
+#ifdef __GLIBC__
+    #if __GLIBC_PREREQ(2, 33)
+        return mallinfo2().uordblks;
+    #else
+        // The counters of mallinfo are int and wrap above 2 GB
+        return (unsigned int) mallinfo().uordblks;
+    #endif
+#else
+    return -1;
+#endif
+}
+
+int ProcessStats::openFileCount()
+{
+#ifdef _WIN32
+    DWORD handles = 0;
+    if (!GetProcessHandleCount(GetCurrentProcess(), &handles))
+    {
+        return -1;
+    }
+
+    return handles;
+#else
+    DIR* fds = opendir("/proc/self/fd");
+    if (fds == NULL)
+    {
+        return -1;
+    }
+
+    // Skip ".", ".." and the descriptor of the directory itself
+    int count = 0;
+    while (struct dirent* entry = readdir(fds))
+    {
+        if (entry->d_name[0] != '.' && dirfd(fds) != atoi(entry->d_name))
+        {
+            count++;
+        }
+    }
+    closedir(fds);
+
+    return count;
+#endif
+}
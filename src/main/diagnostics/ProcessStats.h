@@ -0,0 +1,67 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ProcessStats.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_PROCESSSTATS_H_
+#define SRC_MAIN_DIAGNOSTICS_PROCESSSTATS_H_
+
+#include <QtGlobal>
+
+/**
+ * Reads resource usage of the current process from the operating system.
+ */
+class ProcessStats
+{
+    public:
+        /**
+         * Returns the resident memory of the process.
+         *
+         * @return The resident memory in bytes or -1 if not available.
+         */
+        static qint64 residentBytes();
+
+        /**
+         * Returns the heap memory that is allocated by the process and not
+         * yet freed.
+         *
+         * @return The allocated heap memory in bytes or -1 if not available.
+         */
+        static qint64 heapBytes();
+
+        /**
+         * Returns the number of open file descriptors of the process. On
+         * windows, this is the number of open handles.
+         *
+         * @return The number of open files or -1 if not available.
+         */
+        static int openFileCount();
+
+    private:
+        /**
+         * Only static methods.
+         */
+        ProcessStats();
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_PROCESSSTATS_H_ */
@@ -0,0 +1,58 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * StallProbe.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "StallProbe.h"
+
+// The longest handler of each thread since it was taken by the monitor.
+// Only the owning thread accesses it, so no locking is needed.
+static thread_local const char* longestHandler = NULL;
+static thread_local qint64 longestDuration = 0;
+
+StallProbe::StallProbe(const char* handler) :
+    handler(handler)
+{
+    timer.start();
+}
+
+StallProbe::~StallProbe()
+{
+    qint64 duration = timer.nsecsElapsed() / 1000;
+    if (duration >= longestDuration)
+    {
+        longestHandler = handler;
+        longestDuration = duration;
+    }
+}
+
+qint64 StallProbe::takeLongest(const char** handler)
+{
+    *handler = longestHandler;
+    qint64 duration = longestDuration;
+
+    longestHandler = NULL;
+    longestDuration = 0;
+
+    return duration;
+}
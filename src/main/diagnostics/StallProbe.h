@@ -0,0 +1,77 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * StallProbe.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_STALLPROBE_H_
+#define SRC_MAIN_DIAGNOSTICS_STALLPROBE_H_
+
+#include <QElapsedTimer>
+
+/**
+ * Measures the run time of a handler while it is in scope. The longest
+ * handler of each thread is kept until the {@link EventLoopMonitor} of the
+ * thread takes it, so stalls of the event loop can be attributed to the code
+ * that caused them. Create it as first statement of a slot or callback.
+ */
+class StallProbe
+{
+    public:
+        /**
+         * Starts measuring a handler.
+         *
+         * @param handler The name of the handler. Must be a string literal,
+         *                as only the pointer is kept.
+         */
+        explicit StallProbe(const char* handler);
+
+        /**
+         * Stops measuring and remembers the handler if it is the longest
+         * one of this thread.
+         */
+        ~StallProbe();
+
+        /**
+         * Returns the longest handler of the current thread since the last
+         * call and forgets it.
+         *
+         * @param handler Receives the name of the handler, NULL if no
+         *                handler was measured.
+         * @return The run time of the handler in microseconds, 0 if no
+         *         handler was measured.
+         */
+        static qint64 takeLongest(const char** handler);
+
+    private:
+        /**
+         * The name of the handler.
+         */
+        const char* handler;
+
+        /**
+         * Measures the run time of the handler.
+         */
+        QElapsedTimer timer;
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_STALLPROBE_H_ */
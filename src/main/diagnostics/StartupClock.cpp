@@ -0,0 +1,54 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * StartupClock.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "StartupClock.h"
+
+#include <QElapsedTimer>
+
+// Invalid until started
+static QElapsedTimer startupTimer;
+
+void StartupClock::start()
+{
+    if (!startupTimer.isValid())
+    {
+        startupTimer.start();
+    }
+}
+
+bool StartupClock::isStarted()
+{
+    return startupTimer.isValid();
+}
+
+qint64 StartupClock::elapsed()
+{
+    if (!startupTimer.isValid())
+    {
+        return -1;
+    }
+
+    return startupTimer.elapsed();
+}
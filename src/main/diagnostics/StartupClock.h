@@ -0,0 +1,64 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * StartupClock.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_STARTUPCLOCK_H_
+#define SRC_MAIN_DIAGNOSTICS_STARTUPCLOCK_H_
+
+#include <QtGlobal>
+
+/**
+ * Measures the time since the start of the process, so the time until the
+ * servers are ready can be reported. Start it first thing in main().
+ */
+class StartupClock
+{
+    public:
+        /**
+         * Starts the clock. Later calls are ignored.
+         */
+        static void start();
+
+        /**
+         * Returns if the clock was started.
+         *
+         * @return True if {@link #start} was called.
+         */
+        static bool isStarted();
+
+        /**
+         * Returns the time since the clock was started.
+         *
+         * @return The time in milliseconds or -1 if the clock was not started.
+         */
+        static qint64 elapsed();
+
+    private:
+        /**
+         * Only static methods.
+         */
+        StartupClock();
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_STARTUPCLOCK_H_ */
@@ -0,0 +1,336 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Tracer.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "Tracer.h"
+
+#include <QMutexLocker>
+#include <QAtomicPointer>
+#include <QCoreApplication>
+
+#include <stdio.h>
+
+#include <chrono>
+
+// Interval in ms in which the buffers are written to the file
+static const int flushInterval = 100;
+
+// The tracer used by the command pipeline, read by all its threads
+static QAtomicPointer<Tracer> currentInstance;
+
+// The generation of the last created tracer
+static QAtomicInt lastGeneration(0);
+
+// The last trace id that was handed out
+static QAtomicInteger<quint64> lastTrace(0);
+
+thread_local Tracer::Buffer* Tracer::localBuffer = NULL;
+thread_local int Tracer::localGeneration = 0;
+thread_local quint64 Tracer::localTrace = 0;
+
+Tracer::Tracer(const QString& fileName) :
+    file(fileName), generation(lastGeneration.fetchAndAddRelaxed(1) + 1),
+    processId(QCoreApplication::applicationPid()), buffers(), dropped(0),
+    running(false), firstEvent(true)
+{}
+
+Tracer::~Tracer()
+{
+    if (currentInstance.load() == this)
+    {
+        setInstance(NULL);
+    }
+
+    close();
+    qDeleteAll(buffers);
+}
+
+bool Tracer::open()
+{
+    if (isRunning())
+    {
+        return true;
+    }
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    // The array format allows viewers to load files that were not
+    // completed, e.g. after a crash
+    file.write("[\n");
+    firstEvent = true;
+
+    running = true;
+    start(QThread::LowPriority);
+
+    return true;
+}
+
+void Tracer::close()
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (!running)
+        {
+            return;
+        }
+
+        running = false;
+        stopRequested.wakeOne();
+    }
+
+    wait();
+    file.write("\n]\n");
+    file.close();
+}
+
+void Tracer::span(const char* name, qint64 start, qint64 duration,
+                  quint64 traceId)
+{
+    Event event;
+    event.name = name;
+    event.phase = 'X';
+    event.timestamp = start;
+    event.duration = duration;
+    event.traceId = traceId;
+    append(event);
+}
+
+void Tracer::flowStart(quint64 traceId)
+{
+    Event event;
+    event.name = "command";
+    event.phase = 's';
+    event.timestamp = now();
+    event.duration = 0;
+    event.traceId = traceId;
+    append(event);
+}
+
+void Tracer::flowEnd(quint64 traceId)
+{
+    Event event;
+    event.name = "command";
+    event.phase = 'f';
+    event.timestamp = now();
+    event.duration = 0;
+    event.traceId = traceId;
+    append(event);
+}
+
+quint64 Tracer::droppedEvents() const
+{
+    return dropped.load();
+}
+
+qint64 Tracer::now()
+{
+    // The steady clock is the monotonic clock of the system on linux, so
+    // the timestamps of the server and the daemon match
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+quint64 Tracer::beginTrace()
+{
+    if (!currentInstance.loadAcquire())
+    {
+        return 0;
+    }
+
+    localTrace = lastTrace.fetchAndAddRelaxed(1) + 1;
+    return localTrace;
+}
+
+quint64 Tracer::currentTrace()
+{
+    return localTrace;
+}
+
+void Tracer::setCurrentTrace(quint64 traceId)
+{
+    localTrace = traceId;
+}
+
+Tracer* Tracer::instance()
+{
+    return currentInstance.loadAcquire();
+}
+
+void Tracer::setInstance(Tracer* tracer)
+{
+    currentInstance.storeRelease(tracer);
+}
+
+void Tracer::append(const Event& event)
+{
+    if (localGeneration != generation)
+    {
+        // The first event of this thread, the buffer is created once and
+        // kept until the tracer is deleted
+        Buffer* buffer = new Buffer();
+        buffer->threadName = QThread::currentThread()->objectName().toUtf8();
+        buffer->named = false;
+        buffer->head.store(0);
+        buffer->tail.store(0);
+
+        QMutexLocker locker(&mutex);
+        buffer->threadId = buffers.size() + 1;
+        buffers.append(buffer);
+
+        localBuffer = buffer;
+        localGeneration = generation;
+    }
+
+    Buffer* buffer = localBuffer;
+    quint32 head = buffer->head.load();
+    if (head - buffer->tail.loadAcquire() >= bufferSize)
+    {
+        dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    buffer->events[head % bufferSize] = event;
+    buffer->head.storeRelease(head + 1);
+}
+
+void Tracer::run()
+{
+    QByteArray out;
+    bool keepRunning = true;
+
+    while (keepRunning)
+    {
+        QList<Buffer*> pending;
+        {
+            QMutexLocker locker(&mutex);
+            if (running)
+            {
+                stopRequested.wait(&mutex, flushInterval);
+            }
+
+            pending = buffers;
+            keepRunning = running;
+        }
+
+        for (Buffer* buffer: pending)
+        {
+            take(buffer, out);
+        }
+
+        if (!out.isEmpty())
+        {
+            file.write(out);
+            file.flush();
+            out.clear();
+        }
+    }
+}
+
+void Tracer::take(Buffer* buffer, QByteArray& out)
+{
+    quint32 head = buffer->head.loadAcquire();
+    quint32 tail = buffer->tail.load();
+    if (head == tail)
+    {
+        return;
+    }
+
+    if (!buffer->named)
+    {
+        // Names the thread in the viewer
+        Event event;
+        event.name = "thread_name";
+        event.phase = 'M';
+        event.timestamp = 0;
+        event.duration = 0;
+        event.traceId = 0;
+        encode(event, buffer->threadId, out);
+        out.append("\"args\":{\"name\":\"");
+        out.append(buffer->threadName.isEmpty()
+                   ? QByteArray("thread ")
+                         + QByteArray::number(buffer->threadId)
+                   : buffer->threadName);
+        out.append("\"}}");
+        buffer->named = true;
+    }
+
+    for (; tail != head; tail++)
+    {
+        const Event& event = buffer->events[tail % bufferSize];
+        encode(event, buffer->threadId, out);
+        if (event.phase == 'X')
+        {
+            out.append("\"dur\":" + QByteArray::number(event.duration)
+                       + ",\"args\":{\"trace\":"
+                       + QByteArray::number(event.traceId) + "}}");
+        }
+        else if (event.phase == 'f')
+        {
+            // Binds the end of the flow to the enclosing span
+            out.append("\"id\":" + QByteArray::number(event.traceId)
+                       + ",\"bp\":\"e\"}");
+        }
+        else
+        {
+            out.append("\"id\":" + QByteArray::number(event.traceId) + "}");
+        }
+    }
+
+    buffer->tail.storeRelease(tail);
+}
+
+void Tracer::encode(const Event& event, int threadId, QByteArray& out)
+{
+    // Only the common fields, the caller appends the fields of the phase
+    // and closes the object
+    char fields[160];
+    snprintf(fields, sizeof(fields),
+             "%s{\"name\":\"%s\",\"cat\":\"presenter\",\"ph\":\"%c\","
+             "\"ts\":%lld,\"pid\":%lld,\"tid\":%d,",
+             firstEvent ? "" : ",\n", event.name, event.phase,
+             (long long) event.timestamp, (long long) processId, threadId);
+    out.append(fields);
+    firstEvent = false;
+}
+
+TraceSpan::TraceSpan(const char* name) :
+    tracer(Tracer::instance()), name(name), start(0)
+{
+    if (tracer)
+    {
+        start = Tracer::now();
+    }
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (tracer)
+    {
+        tracer->span(name, start, Tracer::now() - start,
+                     Tracer::currentTrace());
+    }
+}
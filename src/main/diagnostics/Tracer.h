@@ -0,0 +1,365 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * Tracer.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_DIAGNOSTICS_TRACER_H_
+#define SRC_MAIN_DIAGNOSTICS_TRACER_H_
+
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QByteArray>
+#include <QAtomicInteger>
+#include <QWaitCondition>
+
+/**
+ * Writes the stages of the command pipeline as Chrome trace events, which
+ * can be viewed in chrome://tracing or Perfetto. Each thread records into
+ * its own buffer without locking and a background thread writes the buffers
+ * to the file, so tracing costs little while it is enabled.
+ *
+ * All stages of a command share a trace id, which is also passed to the key
+ * sender daemon. The presenter server and the daemon write their own file.
+ * Both use the monotonic clock of the system, so the files can be merged
+ * into one timeline, e.g. with "jq -s add server.json daemon.json".
+ */
+class Tracer: public QThread
+{
+    public:
+        /**
+         * Creates a new tracer. Call {@link #open} to open the file.
+         *
+         * @param fileName The name of the trace file.
+         */
+        explicit Tracer(const QString& fileName);
+
+        /**
+         * Writes the buffered events and closes the file.
+         */
+        ~Tracer();
+
+        /**
+         * Opens the trace file and starts the writer thread.
+         *
+         * @return False if the file could not be opened.
+         */
+        bool open();
+
+        /**
+         * Writes the buffered events, completes the file and stops the
+         * writer thread.
+         */
+        void close();
+
+        /**
+         * Records a completed span. Can be called from any thread. The
+         * span is dropped if the buffer of the thread is full.
+         *
+         * @param name The name of the span. Must be a string literal, as
+         *             only the pointer is kept.
+         * @param start The start of the span, see {@link #now}.
+         * @param duration The duration of the span in microseconds.
+         * @param traceId The trace id of the command, 0 if not known.
+         */
+        void span(const char* name, qint64 start, qint64 duration,
+                  quint64 traceId);
+
+        /**
+         * Records that a command is passed on to another stage, e.g. to
+         * the daemon. Viewers draw an arrow from the enclosing span to the
+         * span that contains the matching {@link #flowEnd}.
+         *
+         * @param traceId The trace id of the command.
+         */
+        void flowStart(quint64 traceId);
+
+        /**
+         * Records that a command arrived from another stage.
+         *
+         * @param traceId The trace id of the command.
+         */
+        void flowEnd(quint64 traceId);
+
+        /**
+         * Returns the number of events that were dropped because a buffer
+         * was full.
+         *
+         * @return The number of dropped events.
+         */
+        quint64 droppedEvents() const;
+
+        /**
+         * Returns the current time of the monotonic system clock, which is
+         * the same in all processes.
+         *
+         * @return The time in microseconds.
+         */
+        static qint64 now();
+
+        /**
+         * Starts tracing a new command on the calling thread. The following
+         * spans of the thread use its trace id.
+         *
+         * @return The new trace id, 0 if no tracer is used.
+         */
+        static quint64 beginTrace();
+
+        /**
+         * Returns the trace id of the current command of the calling
+         * thread.
+         *
+         * @return The trace id, 0 if unknown.
+         */
+        static quint64 currentTrace();
+
+        /**
+         * Continues tracing a command on the calling thread, e.g. one that
+         * was received from another process.
+         *
+         * @param traceId The trace id, 0 if unknown.
+         */
+        static void setCurrentTrace(quint64 traceId);
+
+        /**
+         * Returns the tracer used by the command pipeline.
+         *
+         * @return The tracer or NULL if tracing is disabled.
+         */
+        static Tracer* instance();
+
+        /**
+         * Sets the tracer used by the command pipeline.
+         *
+         * @param tracer The tracer or NULL to disable tracing.
+         */
+        static void setInstance(Tracer* tracer);
+
+    protected:
+        /**
+         * The writer thread.
+         */
+        void run();
+
+    private:
+        /**
+         * The number of events each thread can buffer.
+         */
+        static const quint32 bufferSize = 4096;
+
+        /**
+         * A recorded event.
+         */
+        struct Event
+        {
+            /**
+             * The name of the event.
+             */
+            const char* name;
+
+            /**
+             * The phase of the event as defined by the trace event format,
+             * e.g. 'X' for a completed span.
+             */
+            char phase;
+
+            /**
+             * The start of the event in microseconds.
+             */
+            qint64 timestamp;
+
+            /**
+             * The duration of a span in microseconds.
+             */
+            qint64 duration;
+
+            /**
+             * The trace id of the command.
+             */
+            quint64 traceId;
+        };
+
+        /**
+         * The events of a single thread. The thread appends at the head,
+         * the writer thread takes the events from the tail.
+         */
+        struct Buffer
+        {
+            /**
+             * The id of the thread in the trace.
+             */
+            int threadId;
+
+            /**
+             * The name of the thread, written once as metadata.
+             */
+            QByteArray threadName;
+
+            /**
+             * If the name of the thread was written.
+             */
+            bool named;
+
+            /**
+             * The number of appended events.
+             */
+            QAtomicInteger<quint32> head;
+
+            /**
+             * The number of written events.
+             */
+            QAtomicInteger<quint32> tail;
+
+            /**
+             * The ring of events.
+             */
+            Event events[bufferSize];
+        };
+
+        /**
+         * The buffer of the calling thread.
+         */
+        static thread_local Buffer* localBuffer;
+
+        /**
+         * The generation of the tracer that owns the buffer of the calling
+         * thread.
+         */
+        static thread_local int localGeneration;
+
+        /**
+         * The trace id of the current command of the calling thread.
+         */
+        static thread_local quint64 localTrace;
+
+        /**
+         * The trace file.
+         */
+        QFile file;
+
+        /**
+         * Identifies this tracer, so threads don't use the buffer of an
+         * older tracer.
+         */
+        int generation;
+
+        /**
+         * The id of the process in the trace.
+         */
+        qint64 processId;
+
+        /**
+         * Protects the buffers and the running flag.
+         */
+        QMutex mutex;
+
+        /**
+         * Wakes up the writer to write the remaining events.
+         */
+        QWaitCondition stopRequested;
+
+        /**
+         * The buffers of all threads that recorded events.
+         */
+        QList<Buffer*> buffers;
+
+        /**
+         * The number of dropped events.
+         */
+        QAtomicInteger<quint64> dropped;
+
+        /**
+         * If the writer should keep running.
+         */
+        bool running;
+
+        /**
+         * If no event was written to the file yet.
+         */
+        bool firstEvent;
+
+        /**
+         * Appends an event to the buffer of the calling thread.
+         *
+         * @param event The event.
+         */
+        void append(const Event& event);
+
+        /**
+         * Takes the events of a buffer and encodes them.
+         *
+         * @param buffer The buffer.
+         * @param out Receives the encoded events.
+         */
+        void take(Buffer* buffer, QByteArray& out);
+
+        /**
+         * Encodes an event as JSON object.
+         *
+         * @param event The event.
+         * @param threadId The id of the thread that recorded the event.
+         * @param out Receives the encoded event.
+         */
+        void encode(const Event& event, int threadId, QByteArray& out);
+};
+
+/**
+ * Records a span of the command pipeline while it is in scope. Does nothing
+ * if tracing is disabled.
+ */
+class TraceSpan
+{
+    public:
+        /**
+         * Starts a span.
+         *
+         * @param name The name of the span. Must be a string literal, as
+         *             only the pointer is kept.
+         */
+        explicit TraceSpan(const char* name);
+
+        /**
+         * Ends the span and records it with the current trace id.
+         */
+        ~TraceSpan();
+
+    private:
+        /**
+         * The tracer, NULL if tracing is disabled.
+         */
+        Tracer* tracer;
+
+        /**
+         * The name of the span.
+         */
+        const char* name;
+
+        /**
+         * The start of the span.
+         */
+        qint64 start;
+};
+
+#endif /* SRC_MAIN_DIAGNOSTICS_TRACER_H_ */
@@ -0,0 +1,142 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LogModel.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "LogModel.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QDateTime>
+
+// Add pending messages at most once per frame
+static const int flushInterval = 16;
+
+LogModel::LogModel(int capacity, QObject* parent) :
+    QAbstractListModel(parent), entries(qMax(capacity, 1)), first(0),
+    count(0), pending(), flushTimer(this)
+{
+    flushTimer.setSingleShot(true);
+    connect(&flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+int LogModel::capacity() const
+{
+    return entries.size();
+}
+
+void LogModel::append(const QString& message, Severity severity)
+{
+    Entry entry;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.message = message;
+    entry.severity = severity;
+    pending.append(entry);
+
+    if (!flushTimer.isActive())
+    {
+        flushTimer.start(flushInterval);
+    }
+}
+
+void LogModel::flush()
+{
+    flushTimer.stop();
+    if (pending.isEmpty())
+    {
+        return;
+    }
+
+    // Only the latest messages of a large batch fit into the buffer
+    int skipped = qMax(pending.size() - capacity(), 0);
+    int added = pending.size() - skipped;
+
+    // Drop the oldest messages to make room for the batch
+    int dropped = qMax(count + added - capacity(), 0);
+    if (dropped > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, dropped - 1);
+        first = (first + dropped) % capacity();
+        count -= dropped;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), count, count + added - 1);
+    for (int i = skipped; i < pending.size(); i++)
+    {
+        entries[(first + count) % capacity()] = pending.at(i);
+        count++;
+    }
+    endInsertRows();
+
+    pending.clear();
+}
+
+int LogModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+    {
+        return 0;
+    }
+
+    return count;
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= count)
+    {
+        return QVariant();
+    }
+
+    const Entry& logEntry = entry(index.row());
+    switch (role)
+    {
+        case Qt::DisplayRole:
+            return QString("%1 %2")
+                    .arg(QDateTime::fromMSecsSinceEpoch(logEntry.timestamp)
+                            .toString("hh:mm:ss.zzz"))
+                    .arg(logEntry.message);
+
+        case Qt::ToolTipRole:
+            return logEntry.message;
+
+        case Qt::ForegroundRole:
+            if (logEntry.severity == Error)
+            {
+                return QBrush(QColor(0xaa, 0x33, 0x33));
+            }
+            return QVariant();
+
+        case SeverityRole:
+            return logEntry.severity;
+
+        default:
+            return QVariant();
+    }
+}
+
+const LogModel::Entry& LogModel::entry(int row) const
+{
+    return entries.at((first + row) % capacity());
+}
@@ -0,0 +1,167 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LogModel.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_MAIN_GUI_LOGMODEL_H_
+#define SRC_MAIN_GUI_LOGMODEL_H_
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QString>
+#include <QTimer>
+
+/**
+ * Keeps the latest log messages in a ring buffer of fixed capacity. Once the
+ * buffer is full, the oldest messages are dropped. Messages are added to
+ * the model in batches, at most once per frame, and are only formatted
+ * when a view shows them.
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * The severity of a message.
+         */
+        enum Severity
+        {
+            Info,
+            Error
+        };
+
+        /**
+         * The role to query the severity of a message.
+         */
+        static const int SeverityRole = Qt::UserRole;
+
+        /**
+         * The default number of messages that are kept.
+         */
+        static const int defaultCapacity = 10000;
+
+        /**
+         * Creates a new, empty model.
+         *
+         * @param capacity The maximum number of messages that are kept.
+         * @param parent The parent object.
+         */
+        LogModel(int capacity = defaultCapacity, QObject* parent = 0);
+
+        /**
+         * Returns the maximum number of messages that are kept.
+         *
+         * @return The capacity.
+         */
+        int capacity() const;
+
+        /**
+         * Adds a message. It will be shown with the next batch.
+         *
+         * @param message The message to add.
+         * @param severity The severity of the message.
+         */
+        void append(const QString& message, Severity severity = Info);
+
+        /**
+         * Returns the number of messages in the model.
+         *
+         * @param parent Unused, the model is a flat list.
+         * @return The number of messages.
+         */
+        int rowCount(const QModelIndex& parent = QModelIndex()) const;
+
+        /**
+         * Returns the data of a message. The display text is formatted on
+         * each call, so only shown messages are formatted.
+         *
+         * @param index The index of the message.
+         * @param role The requested role.
+         * @return The data or an invalid variant.
+         */
+        QVariant data(const QModelIndex& index, int role) const;
+
+    public slots:
+        /**
+         * Adds the pending messages to the model.
+         */
+        void flush();
+
+    private:
+        /**
+         * A stored message.
+         */
+        struct Entry
+        {
+            /**
+             * The time the message was added, in ms since the epoch.
+             */
+            qint64 timestamp;
+
+            /**
+             * The message text.
+             */
+            QString message;
+
+            /**
+             * The severity of the message.
+             */
+            Severity severity;
+        };
+
+        /**
+         * The ring buffer of messages, allocated with the full capacity.
+         */
+        QVector<Entry> entries;
+
+        /**
+         * The index of the oldest message in the ring buffer.
+         */
+        int first;
+
+        /**
+         * The number of messages in the ring buffer.
+         */
+        int count;
+
+        /**
+         * The messages that were not added to the model yet.
+         */
+        QVector<Entry> pending;
+
+        /**
+         * Timer that adds the pending messages once per frame.
+         */
+        QTimer flushTimer;
+
+        /**
+         * Returns the message of a given row.
+         *
+         * @param row The row, 0 is the oldest message.
+         * @return The message.
+         */
+        const Entry& entry(int row) const;
+};
+
+#endif /* SRC_MAIN_GUI_LOGMODEL_H_ */
@@ -26,13 +26,22 @@
 #include "Logger.h"
 #include "ui_Logger.h"
 
-Logger::Logger(QWidget* parent) :
+#include <QScrollBar>
+
+Logger::Logger(LogModel* model, QWidget* parent) :
     QDialog(parent, Qt::WindowSystemMenuHint | Qt::WindowTitleHint
             | Qt::WindowCloseButtonHint | Qt::MSWindowsFixedSizeDialogHint),
-    ui(new Ui::Logger)
+    ui(new Ui::Logger), followNewMessages(true)
 {
     // Initialize window
     ui->setupUi(this);
+    ui->logger->setModel(model);
+    ui->logger->scrollToBottom();
+
+    connect(model, SIGNAL(rowsAboutToBeInserted(QModelIndex, int, int)),
+            this, SLOT(messagesAboutToBeAdded()));
+    connect(model, SIGNAL(rowsInserted(QModelIndex, int, int)),
+            this, SLOT(messagesAdded()));
 }
 
 Logger::~Logger()
@@ -40,9 +49,18 @@ Logger::~Logger()
     delete ui;
 }
 
-void Logger::append(const QString &message)
+void Logger::messagesAboutToBeAdded()
+{
+    QScrollBar* scrollBar = ui->logger->verticalScrollBar();
+    followNewMessages = scrollBar->value() == scrollBar->maximum();
+}
+
+void Logger::messagesAdded()
 {
-    ui->logger->append(message);
+    if (followNewMessages && isVisible())
+    {
+        ui->logger->scrollToBottom();
+    }
 }
 
 void Logger::closeEvent(QCloseEvent *event)
@@ -29,6 +29,8 @@
 #include <QDialog>
 #include <QCloseEvent>
 
+#include "LogModel.h"
+
 namespace Ui {
     class Logger;
 }
@@ -46,22 +48,17 @@ class Logger : public QDialog
         /**
          * Constructor. Initializes the window elements.
          *
+         * @param model The messages to show. Owned by the caller, so
+         *              messages are kept even if no logger window exists.
          * @param parent The parent window
          */
-        Logger(QWidget* parent);
+        Logger(LogModel* model, QWidget* parent);
 
         /**
          * Destructor. Deletes the ui object.
          */
         virtual ~Logger();
 
-        /**
-         * Append a message to the logger.
-         *
-         * @param message The message to log.
-         */
-        void append(const QString &message);
-
     protected:
         /**
          * We need our own close event handler to hide instead of close.
@@ -75,6 +72,25 @@ class Logger : public QDialog
          * The ui of the dialog.
          */
         Ui::Logger* ui;
+
+        /**
+         * If the view should follow new messages. True while the view is
+         * scrolled to the latest message.
+         */
+        bool followNewMessages;
+
+    private slots:
+        /**
+         * Called before messages are added, remembers if the view shows the
+         * latest message.
+         */
+        void messagesAboutToBeAdded();
+
+        /**
+         * Called once messages were added. Scrolls to the latest message if
+         * the view showed the latest message before.
+         */
+        void messagesAdded();
 };
 
 #endif // SRC_MAIN_GUI_LOGGER_H_
@@ -28,25 +28,38 @@
 
 #include "AboutWindow.h"
 
+#include "../connector/NullKeySender.h"
+#include "../diagnostics/StartupClock.h"
+#include "../diagnostics/ProcessStats.h"
+#include "../diagnostics/StallProbe.h"
+#include "../diagnostics/EventLoopMonitor.h"
+
 #include <QIcon>
 #include <QMenu>
 #include <QThread>
+#include <QEventLoop>
 #include <QCloseEvent>
+#include <QElapsedTimer>
 #include <QMessageBox>
 
+// Time to wait for the servers to stop on shutdown
+const int MainWindow::shutdownTimeout = 2000;
+
 MainWindow::MainWindow(QWidget *parent) :
-    QMainWindow(parent), ui(new Ui::MainWindow),
-    btConnector(NULL), networkConnector(NULL)
+    QMainWindow(parent), ui(NULL),
+    ioThread(new QThread()), bluetoothThread(new QThread()),
+    webSocketThread(new QThread()), runningConnectors(0),
+    keyInjectionEnabled(true), datagramCommandsEnabled(false), logger(NULL),
+    logModel(new LogModel(LogModel::defaultCapacity, this)),
+    btConnector(NULL), networkConnector(NULL), webSocketConnector(NULL),
+    slideStateModel(NULL)
 {
-    // Initialize window
-    ui->setupUi(this);
+    // The window elements are created once the window is shown the first
+    // time, so running in the system tray only needs the tray icon
 
     // Initialize system tray icon
     icon = new QIcon(":/icon");
 
-    // Initialize the logger window
-    logger = new Logger(this);
-
     // Create tray icon and context menu
     openAction = new QAction(tr("&Open"), this);
     connect(openAction, SIGNAL(triggered()), this, SLOT(restore()));
@@ -70,6 +83,103 @@ MainWindow::MainWindow(QWidget *parent) :
     setWindowIcon(*icon);
     trayIcon->show();
 
+    // Start the server in a background thread to keep the UI responsible
+    serverStartTimer = new QTimer();
+    serverStartTimer->setSingleShot(true);
+    connect(serverStartTimer, SIGNAL(timeout()), this, SLOT(startServer()));
+    serverStartTimer->start(10);
+}
+
+MainWindow::~MainWindow()
+{
+    QElapsedTimer shutdownTimer;
+    shutdownTimer.start();
+
+    // If the connectors were not created yet, they will not be created anymore
+    delete serverStartTimer;
+
+    if (btConnector != NULL)
+    {
+        // Stop the servers in the io thread and wait until all of them
+        // reported that they stopped
+        QList<RemoteControl*> connectors;
+        connectors << btConnector << networkConnector << webSocketConnector;
+
+        QEventLoop shutdownLoop;
+        runningConnectors = connectors.size();
+        connect(this, SIGNAL(connectorsStopped()), &shutdownLoop, SLOT(quit()));
+
+        for (RemoteControl* connector: connectors)
+        {
+            connect(connector, SIGNAL(stopped()),
+                         this, SLOT(connectorStopped()));
+            QMetaObject::invokeMethod(connector, "stopServer",
+                                      Qt::QueuedConnection);
+        }
+
+        // Do not hang forever if a connector is blocked
+        QTimer::singleShot(shutdownTimeout, &shutdownLoop, SLOT(quit()));
+        shutdownLoop.exec(QEventLoop::ExcludeUserInputEvents);
+
+        if (runningConnectors > 0)
+        {
+            qWarning("%d servers did not stop within %d ms",
+                     runningConnectors, shutdownTimeout);
+        }
+
+        // No more signals to the window that is destroyed
+        for (RemoteControl* connector: connectors)
+        {
+            connector->disconnect(this);
+        }
+    }
+
+    // The connectors are deleted in their threads once they finished
+    QList<QThread*> threads;
+    threads << ioThread << bluetoothThread << webSocketThread;
+    for (QThread* thread: threads)
+    {
+        thread->quit();
+    }
+    for (QThread* thread: threads)
+    {
+        thread->wait();
+        delete thread;
+    }
+
+    qInfo("Shutdown took %lld ms", shutdownTimer.elapsed());
+
+    delete logger;
+    delete ui;
+    delete icon;
+}
+
+void MainWindow::setVisible(bool visible)
+{
+    if (visible)
+    {
+        ensureUi();
+    }
+
+    QMainWindow::setVisible(visible);
+
+    if (visible)
+    {
+        showStatistics();
+    }
+}
+
+void MainWindow::ensureUi()
+{
+    if (ui != NULL)
+    {
+        return;
+    }
+
+    // Initialize window
+    ui = new Ui::MainWindow();
+    ui->setupUi(this);
+
     // Set minimum width for info labels
     ui->bluetoothServerStatus->setMinimumWidth(
             ui->bluetoothServerStatus->fontMetrics()
@@ -87,35 +197,16 @@ MainWindow::MainWindow(QWidget *parent) :
             ui->networkServerStatus->fontMetrics()
                 .boundingRect(tr("Error, see log for Details"))
                 .width());
+    ui->webSocketServerStatus->setMinimumWidth(
+            ui->webSocketServerStatus->fontMetrics()
+                .boundingRect(tr("Error, see log for Details"))
+                .width());
 
-    // Start the server in a background thread to keep the UI responsible
-    serverStartTimer = new QTimer();
-    serverStartTimer->setSingleShot(true);
-    connect(serverStartTimer, SIGNAL(timeout()), this, SLOT(startServer()));
-    serverStartTimer->start(10);
-}
-
-MainWindow::~MainWindow()
-{
-    // Make sure that the connectors are properly
-    // initialized before deleting them
-    while (btConnector == NULL)
+    // Show what happened while the window did not exist
+    for (int server = 0; server < serverCount; server++)
     {
-        QThread::msleep(100);
-        QApplication::processEvents();
+        showStatus(Server(server));
     }
-    while (networkConnector == NULL)
-    {
-        QThread::msleep(100);
-        QApplication::processEvents();
-    }
-    delete serverStartTimer;
-    delete btConnector;
-    delete networkConnector;
-
-    delete ui;
-    delete icon;
-    delete logger;
 }
 
 void MainWindow::changeEvent(QEvent *event)
@@ -147,8 +238,23 @@ void MainWindow::changeEvent(QEvent *event)
 
 void MainWindow::startServer()
 {
-    btConnector = new BluetoothConnector();
-    networkConnector = new NetworkConnector();
+    btConnector = new BluetoothConnector(createKeySender());
+    networkConnector = new NetworkConnector(createKeySender());
+    networkConnector->setDatagramCommandsEnabled(datagramCommandsEnabled);
+    webSocketConnector = new WebSocketConnector(createKeySender());
+    slideStateModel = new SlideStateModel();
+
+    // Receiving, decoding and sending the keys happens outside of the ui
+    // thread. Each connector has its own thread, so they start concurrently
+    // and a slow service registration does not delay the other servers.
+    // The signals to the ui are queued.
+    runInThread(btConnector, bluetoothThread);
+    runInThread(networkConnector, ioThread);
+    runInThread(webSocketConnector, webSocketThread);
+    runInThread(slideStateModel, ioThread);
+    ioThread->start();
+    bluetoothThread->start();
+    webSocketThread->start();
 
     // The signals of our bt connector
     connect(btConnector, SIGNAL(info(QString)),
@@ -159,8 +265,8 @@ void MainWindow::startServer()
                     this, SLOT(bluetoothClientConnected(QString)));
     connect(btConnector, SIGNAL(clientDisconnected()),
                     this, SLOT(bluetoothClientDisconnected()));
-    connect(btConnector, SIGNAL(keySent(QString, QString)),
-                    this, SLOT(keySent(QString, QString)));
+    connect(btConnector, SIGNAL(keysSent(int, QString, QString)),
+                    this, SLOT(keysSent(int, QString, QString)));
     connect(btConnector, SIGNAL(serverReady()),
                     this, SLOT(bluetoothServerReady()));
 
@@ -173,79 +279,344 @@ void MainWindow::startServer()
                     this, SLOT(networkClientConnected(QString)));
     connect(networkConnector, SIGNAL(clientDisconnected()),
                     this, SLOT(networkClientDisconnected()));
-    connect(networkConnector, SIGNAL(keySent(QString, QString)),
-                    this, SLOT(keySent(QString, QString)));
+    connect(networkConnector, SIGNAL(keysSent(int, QString, QString)),
+                    this, SLOT(keysSent(int, QString, QString)));
     connect(networkConnector, SIGNAL(serverReady()),
                     this, SLOT(networkServerReady()));
 
-    btConnector->startServer();
-    networkConnector->startServer();
+    // The signals of our websocket connector
+    connect(webSocketConnector, SIGNAL(info(QString)),
+                      this, SLOT(info(QString)));
+    connect(webSocketConnector, SIGNAL(error(QString)),
+                      this, SLOT(webSocketError(QString)));
+    connect(webSocketConnector, SIGNAL(clientConnected(QString)),
+                      this, SLOT(webSocketClientConnected(QString)));
+    connect(webSocketConnector, SIGNAL(clientDisconnected()),
+                      this, SLOT(webSocketClientDisconnected()));
+    connect(webSocketConnector, SIGNAL(keysSent(int, QString, QString)),
+                      this, SLOT(keysSent(int, QString, QString)));
+    connect(webSocketConnector, SIGNAL(serverReady()),
+                      this, SLOT(webSocketServerReady()));
+
+    // The statistics of all connectors
+    connect(btConnector, SIGNAL(statisticsUpdated(QList<ClientStatistics>)),
+                   this, SLOT(statisticsUpdated(QList<ClientStatistics>)));
+    connect(networkConnector,
+            SIGNAL(statisticsUpdated(QList<ClientStatistics>)),
+            this, SLOT(statisticsUpdated(QList<ClientStatistics>)));
+    connect(webSocketConnector,
+            SIGNAL(statisticsUpdated(QList<ClientStatistics>)),
+            this, SLOT(statisticsUpdated(QList<ClientStatistics>)));
+
+    // Follow the slide position and publish it to the network viewers
+    connect(btConnector, SIGNAL(keySent(QString, QString)),
+            slideStateModel, SLOT(keySent(QString, QString)));
+    connect(networkConnector, SIGNAL(keySent(QString, QString)),
+            slideStateModel, SLOT(keySent(QString, QString)));
+    connect(webSocketConnector, SIGNAL(keySent(QString, QString)),
+            slideStateModel, SLOT(keySent(QString, QString)));
+    connect(slideStateModel, SIGNAL(stateChanged(QByteArray)),
+            networkConnector, SLOT(publishSlideState(QByteArray)));
+    QMetaObject::invokeMethod(slideStateModel, "publish",
+                              Qt::QueuedConnection);
+
+    // Slow handlers delay all connectors of a thread, so make them visible
+    monitorEventLoop("ui", NULL);
+    monitorEventLoop("io", ioThread);
+    monitorEventLoop("bluetooth", bluetoothThread);
+    monitorEventLoop("websocket", webSocketThread);
+
+    QMetaObject::invokeMethod(btConnector, "startServer",
+                              Qt::QueuedConnection);
+    QMetaObject::invokeMethod(networkConnector, "startServer",
+                              Qt::QueuedConnection);
+    QMetaObject::invokeMethod(webSocketConnector, "startServer",
+                              Qt::QueuedConnection);
+
+    // Makes the cost of the ui visible, compare with the --tray option
+    log(tr("Started in %1 ms, resident memory %2 KiB")
+        .arg(StartupClock::elapsed())
+        .arg(ProcessStats::residentBytes() / 1024));
+}
+
+void MainWindow::setKeyInjectionEnabled(bool enabled)
+{
+    keyInjectionEnabled = enabled;
+}
+
+void MainWindow::setDatagramCommandsEnabled(bool enabled)
+{
+    datagramCommandsEnabled = enabled;
+}
+
+KeySender* MainWindow::createKeySender() const
+{
+    return keyInjectionEnabled ? NULL : new NullKeySender();
+}
+
+void MainWindow::runInThread(QObject* object, QThread* thread)
+{
+    object->moveToThread(thread);
+    connect(thread, SIGNAL(finished()), object, SLOT(deleteLater()));
+}
+
+void MainWindow::monitorEventLoop(const QString& name, QThread* thread)
+{
+    EventLoopMonitor* monitor = new EventLoopMonitor(name);
+    if (thread)
+    {
+        runInThread(monitor, thread);
+    }
+    else
+    {
+        monitor->setParent(this);
+    }
+
+    connect(monitor, SIGNAL(stalled(QString)), this, SLOT(info(QString)));
+    QMetaObject::invokeMethod(monitor, "start", Qt::QueuedConnection);
+}
+
+void MainWindow::serverReady(Server server, const QString& name)
+{
+    setStatus(server, QString("<font color=\"#0b0\">%1</font>")
+                          .arg(tr("Ready")));
+
+    qint64 readyTime = StartupClock::elapsed();
+    if (readyTime >= 0)
+    {
+        statusToolTips[server] = tr("Ready %1 ms after start").arg(readyTime);
+        showStatus(server);
+        log(tr("%1 server ready %2 ms after start").arg(name).arg(readyTime));
+    }
+}
+
+void MainWindow::setStatus(Server server, const QString& status)
+{
+    statusTexts[server] = status;
+    showStatus(server);
+}
+
+void MainWindow::showStatus(Server server)
+{
+    if (ui == NULL || statusTexts[server].isEmpty())
+    {
+        return;
+    }
+
+    QLabel* label = NULL;
+    switch (server)
+    {
+        case BluetoothServer:
+            label = ui->bluetoothServerStatus;
+            break;
+        case NetworkServer:
+            label = ui->networkServerStatus;
+            break;
+        default:
+            label = ui->webSocketServerStatus;
+            break;
+    }
+
+    label->setText(statusTexts[server]);
+    label->setToolTip(statusToolTips[server]);
+}
+
+void MainWindow::log(const QString& message, LogModel::Severity severity)
+{
+    StallProbe probe("MainWindow::log");
+
+    // Pass the message to the log file, too
+    if (severity == LogModel::Error)
+    {
+        qWarning("%s", qPrintable(message));
+    }
+    else
+    {
+        qInfo("%s", qPrintable(message));
+    }
+
+    logModel->append(message, severity);
+}
+
+void MainWindow::connectorStopped()
+{
+    runningConnectors--;
+    if (runningConnectors == 0)
+    {
+        emit connectorsStopped();
+    }
 }
 
 void MainWindow::info(const QString &message)
 {
-    logger->append(message);
+    log(message);
 }
 
 void MainWindow::bluetoothServerReady()
 {
-    ui->bluetoothServerStatus->setText(
-                QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
+    serverReady(BluetoothServer, tr("Bluetooth"));
 }
 
 void MainWindow::bluetoothError(const QString &message)
 {
-    logger->append(QString("<font color=\"#a33\">%1</font>").arg(message));
-    ui->bluetoothServerStatus->setText(
+    log(message, LogModel::Error);
+    setStatus(BluetoothServer,
             QString("<font color=\"#a33\">%1</font>")
                 .arg(tr("Error, see log for Details")));
 }
 
 void MainWindow::bluetoothClientConnected(const QString &name)
 {
-    logger->append(tr("Connected: %1").arg(name));
-    ui->bluetoothServerStatus->setText(
-                QString("<font color=\"#0b0\">%1</font>").arg(tr("Connected")));
+    log(tr("Connected: %1").arg(name));
+    setStatus(BluetoothServer,
+            QString("<font color=\"#0b0\">%1</font>").arg(tr("Connected")));
 }
 
 void MainWindow::bluetoothClientDisconnected()
 {
-    logger->append(tr("Disconnected."));
-    ui->bluetoothServerStatus->setText(
-                QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
+    log(tr("Disconnected."));
+    setStatus(BluetoothServer,
+            QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
 }
 
 void MainWindow::networkServerReady()
 {
-    ui->networkServerStatus->setText(
-                QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
+    serverReady(NetworkServer, tr("Network"));
 }
 
 void MainWindow::networkError(const QString &message)
 {
-    logger->append(QString("<font color=\"#a33\">%1</font>").arg(message));
-    ui->networkServerStatus->setText(
+    log(message, LogModel::Error);
+    setStatus(NetworkServer,
             QString("<font color=\"#a33\">%1</font>")
                 .arg(tr("Error, see log for Details")));
 }
 
 void MainWindow::networkClientConnected(const QString &name)
 {
-    logger->append(tr("Connected: %1").arg(name));
-    ui->networkServerStatus->setText(
-                QString("<font color=\"#0b0\">%1</font>").arg(tr("Connected")));
+    log(tr("Connected: %1").arg(name));
+    setStatus(NetworkServer,
+            QString("<font color=\"#0b0\">%1</font>").arg(tr("Connected")));
 }
 
 void MainWindow::networkClientDisconnected()
 {
-    logger->append(tr("Disconnected."));
-    ui->networkServerStatus->setText(
-                QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
+    log(tr("Disconnected."));
+    setStatus(NetworkServer,
+            QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
 }
 
-void MainWindow::keySent(const QString &sender, const QString &key)
+void MainWindow::webSocketServerReady()
 {
-    logger->append(tr("Key press, sender %1: %2").arg(sender, key));
+    serverReady(WebSocketServer, tr("Browser"));
+}
+
+void MainWindow::webSocketError(const QString &message)
+{
+    log(message, LogModel::Error);
+    setStatus(WebSocketServer,
+            QString("<font color=\"#a33\">%1</font>")
+                .arg(tr("Error, see log for Details")));
+}
+
+void MainWindow::webSocketClientConnected(const QString &name)
+{
+    log(tr("Connected: %1").arg(name));
+    setStatus(WebSocketServer,
+            QString("<font color=\"#0b0\">%1</font>").arg(tr("Connected")));
+}
+
+void MainWindow::webSocketClientDisconnected()
+{
+    log(tr("Disconnected."));
+    setStatus(WebSocketServer,
+            QString("<font color=\"#0b0\">%1</font>").arg(tr("Ready")));
+}
+
+void MainWindow::statisticsUpdated(const QList<ClientStatistics>& statistics)
+{
+    clientStatistics.insert(sender(), statistics);
+    showStatistics();
+}
+
+void MainWindow::showStatistics()
+{
+    // Nobody looks at the statistics while we run in the tray
+    if (ui == NULL || !isVisible())
+    {
+        return;
+    }
+
+    int rows = 0;
+    for (const QList<ClientStatistics>& statistics: clientStatistics)
+    {
+        rows += statistics.size();
+    }
+    ui->statistics->setRowCount(rows);
+
+    int row = 0;
+    for (const QList<ClientStatistics>& statistics: clientStatistics)
+    {
+        for (const ClientStatistics& client: statistics)
+        {
+            setStatisticsCell(row, 0, client.connector);
+            setStatisticsCell(row, 1, client.name);
+            setStatisticsCell(row, 2,
+                              QString::number(client.commandsPerSecond,
+                                              'f', 1));
+            setStatisticsCell(row, 3, QString::number(client.bytesReceived));
+            setStatisticsCell(row, 4, QString::number(client.bytesSent));
+            setStatisticsCell(row, 5, formatLatency(client.latencyP50));
+            setStatisticsCell(row, 6, formatLatency(client.latencyP99));
+            setStatisticsCell(row, 7, formatLatency(client.roundTrip));
+            setStatisticsCell(row, 8, client.roundTrip < 0
+                                      ? QString("-")
+                                      : tr("%1 ms").arg(
+                                            client.clockOffset / 1000.0,
+                                            0, 'f', 2));
+            setStatisticsCell(row, 9, QString::number(client.reconnects));
+            setStatisticsCell(row, 10,
+                              tr("%1 s").arg(client.idleTime / 1000));
+            row++;
+        }
+    }
+}
+
+void MainWindow::setStatisticsCell(int row, int column, const QString& text)
+{
+    QTableWidgetItem* item = ui->statistics->item(row, column);
+    if (item == NULL)
+    {
+        ui->statistics->setItem(row, column, new QTableWidgetItem(text));
+    }
+    else if (item->text() != text)
+    {
+        item->setText(text);
+    }
+}
+
+QString MainWindow::formatLatency(qint64 microseconds)
+{
+    if (microseconds < 0)
+    {
+        return QString("-");
+    }
+
+    return tr("%1 ms").arg(microseconds / 1000.0, 0, 'f', 2);
+}
+
+void MainWindow::keysSent(int count, const QString &sender,
+                          const QString &key)
+{
+    if (count == 1)
+    {
+        log(tr("Key press, sender %1: %2").arg(sender, key));
+    }
+    else
+    {
+        log(tr("%1 key presses, last sender %2: %3")
+            .arg(count).arg(sender, key));
+    }
 }
 
 void MainWindow::iconActivated(QSystemTrayIcon::ActivationReason reason)
@@ -265,6 +636,11 @@ void MainWindow::iconActivated(QSystemTrayIcon::ActivationReason reason)
 
 void MainWindow::showLog()
 {
+    if (logger == NULL)
+    {
+        logger = new Logger(logModel, this);
+    }
+
     if (!logger->isVisible())
     {
         logger->setVisible(true);
@@ -26,21 +26,28 @@
 #ifndef SRC_MAIN_GUI_MAINWINDOW_H_
 #define SRC_MAIN_GUI_MAINWINDOW_H_
 
+#include <QMap>
 #include <QSystemTrayIcon>
+#include <QThread>
+#include <QTimer>
 
 #include <QMainWindow>
 
 #include "Logger.h"
+#include "LogModel.h"
 
 #include "../connector/bluetooth/BluetoothConnector.h"
 #include "../connector/network/NetworkConnector.h"
+#include "../connector/websocket/WebSocketConnector.h"
+#include "../connector/SlideStateModel.h"
 
 namespace Ui {
     class MainWindow;
 }
 
 /**
- * The main window. Shows the status log.
+ * The main window. Shows the status log. The window elements are created
+ * once the window is shown, so running in the system tray only is cheap.
  */
 class MainWindow : public QMainWindow
 {
@@ -59,6 +66,32 @@ class MainWindow : public QMainWindow
          */
         ~MainWindow();
 
+        /**
+         * Creates the window elements if not done yet before showing the
+         * window.
+         *
+         * @param visible If the window should be visible.
+         */
+        void setVisible(bool visible);
+
+        /**
+         * Enables or disables the key injection. If disabled, the servers
+         * handle the commands but drop the keys, e.g. for load tests.
+         * Enabled by default. Must be called before the servers are started.
+         *
+         * @param enabled If keys should be injected into the system.
+         */
+        void setKeyInjectionEnabled(bool enabled);
+
+        /**
+         * Enables or disables the command datagrams of the network server.
+         * Disabled by default. Must be called before the servers are
+         * started.
+         *
+         * @param enabled If commands should be accepted as datagrams.
+         */
+        void setDatagramCommandsEnabled(bool enabled);
+
     protected:
         /**
          * Handler that minimizes the window to system tray.
@@ -129,12 +162,45 @@ class MainWindow : public QMainWindow
         void networkClientDisconnected();
 
         /**
-         * Called if a key event was sent.
+         * Called if an error happened during websocket server
+         * initialization.
          *
-         * @param sender The name of the sender
-         * @param key The key that was sent
+         * @param message The error message to display
+         */
+        void webSocketError(const QString &message);
+
+        /**
+         * Called once the websocket server is ready to accept connections.
          */
-        void keySent(const QString &sender, const QString &key);
+        void webSocketServerReady();
+
+        /**
+         * Called if a new websocket client connected.
+         *
+         * @param name The client name
+         */
+        void webSocketClientConnected(const QString &name);
+
+        /**
+         * Called if a websocket client disconnected.
+         */
+        void webSocketClientDisconnected();
+
+        /**
+         * Called regularly if key events were sent. Logs a summary of them.
+         *
+         * @param count The number of keys that were sent
+         * @param sender The name of the sender of the last key
+         * @param key The last key that was sent
+         */
+        void keysSent(int count, const QString &sender, const QString &key);
+
+        /**
+         * Called if a connector published the statistics of its clients.
+         *
+         * @param statistics The statistics of the clients of the connector.
+         */
+        void statisticsUpdated(const QList<ClientStatistics>& statistics);
 
         /**
          * Called on clicks on the system tray icon.
@@ -159,22 +225,101 @@ class MainWindow : public QMainWindow
          */
         void restore();
 
+        /**
+         * Called once a connector stopped its server during shutdown.
+         */
+        void connectorStopped();
+
+    signals:
+        /**
+         * Emitted once all connectors stopped their servers during shutdown.
+         */
+        void connectorsStopped();
+
     private:
         /**
-         * The main window ui.
+         * The servers that have a status in the window.
+         */
+        enum Server
+        {
+            BluetoothServer,
+            NetworkServer,
+            WebSocketServer,
+            serverCount
+        };
+
+        /**
+         * Time in milliseconds to wait for the servers to stop on shutdown.
+         */
+        static const int shutdownTimeout;
+
+        /**
+         * The main window ui. NULL until the window is shown the first time.
          */
         Ui::MainWindow* ui;
 
+        /**
+         * The latest status of each server. Empty if there is no status yet.
+         * Kept to be shown once the ui is created.
+         */
+        QString statusTexts[serverCount];
+
+        /**
+         * The tool tip of the status of each server.
+         */
+        QString statusToolTips[serverCount];
+
         /**
          * Timer thread to start up the connectors
          */
         QTimer* serverStartTimer;
 
         /**
-         * The logger window.
+         * The thread that runs the network connector, its key sender and the
+         * slide state, so a busy ui does not delay the commands.
+         */
+        QThread* ioThread;
+
+        /**
+         * The thread that runs the bluetooth connector and its key sender.
+         */
+        QThread* bluetoothThread;
+
+        /**
+         * The thread that runs the websocket connector and its key sender.
+         */
+        QThread* webSocketThread;
+
+        /**
+         * The number of connectors that did not stop yet during shutdown.
+         */
+        int runningConnectors;
+
+        /**
+         * If the connectors inject the keys into the system.
+         */
+        bool keyInjectionEnabled;
+
+        /**
+         * If the network server accepts commands as datagrams.
+         */
+        bool datagramCommandsEnabled;
+
+        /**
+         * The logger window. NULL until the log is shown the first time.
          */
         Logger* logger;
 
+        /**
+         * The latest log messages.
+         */
+        LogModel* logModel;
+
+        /**
+         * The latest client statistics of each connector.
+         */
+        QMap<QObject*, QList<ClientStatistics> > clientStatistics;
+
         /**
          * The bluetooth connector class. Will create the bluetooth server.
          */
@@ -185,6 +330,16 @@ class MainWindow : public QMainWindow
          */
         NetworkConnector* networkConnector;
 
+        /**
+         * The websocket connector class. Will create a server for browsers.
+         */
+        WebSocketConnector* webSocketConnector;
+
+        /**
+         * The current slide position, published to viewers.
+         */
+        SlideStateModel* slideStateModel;
+
         /**
          * The action to open our log window.
          */
@@ -215,6 +370,92 @@ class MainWindow : public QMainWindow
          * The context menu for our tray icon.
          */
         QMenu *trayIconMenu;
+
+        /**
+         * Moves an object to a thread and deletes it there once the thread
+         * finished.
+         *
+         * @param object The object to move.
+         * @param thread The thread to move the object to.
+         */
+        void runInThread(QObject* object, QThread* thread);
+
+        /**
+         * Creates the key sender for a connector.
+         *
+         * @return NULL to use the key sender of the system, a key sender
+         *         that drops the keys if the injection is disabled.
+         */
+        KeySender* createKeySender() const;
+
+        /**
+         * Starts an event loop monitor in a thread. Stalls of the event loop
+         * are logged.
+         *
+         * @param name The name of the event loop.
+         * @param thread The thread to monitor, NULL for the ui thread.
+         */
+        void monitorEventLoop(const QString& name, QThread* thread);
+
+        /**
+         * Creates the window elements if not done yet.
+         */
+        void ensureUi();
+
+        /**
+         * Shows that a server is ready and reports the time since the start
+         * of the program.
+         *
+         * @param server The server that is ready.
+         * @param name The name of the server to log.
+         */
+        void serverReady(Server server, const QString& name);
+
+        /**
+         * Changes the status of a server.
+         *
+         * @param server The server.
+         * @param status The status text, may contain html.
+         */
+        void setStatus(Server server, const QString& status);
+
+        /**
+         * Shows the latest status of a server if the ui exists.
+         *
+         * @param server The server.
+         */
+        void showStatus(Server server);
+
+        /**
+         * Shows the latest client statistics if the window is visible.
+         */
+        void showStatistics();
+
+        /**
+         * Changes the text of a cell of the statistics table.
+         *
+         * @param row The row of the cell.
+         * @param column The column of the cell.
+         * @param text The new text.
+         */
+        void setStatisticsCell(int row, int column, const QString& text);
+
+        /**
+         * Formats a latency for the statistics table.
+         *
+         * @param microseconds The latency in microseconds, -1 if unknown.
+         * @return The formatted latency.
+         */
+        static QString formatLatency(qint64 microseconds);
+
+        /**
+         * Logs a message in the log window and the log file.
+         *
+         * @param message The message to log.
+         * @param severity The severity of the message.
+         */
+        void log(const QString& message,
+                 LogModel::Severity severity = LogModel::Info);
 };
 
 #endif // SRC_MAIN_GUI_MAINWINDOW_H_
@@ -2,10 +2,16 @@
 
 SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
 
+# The daemon runs as root, so its log must be in a directory that only root
+# can write. Otherwise a user process could replace the log by a symlink.
+DAEMON="${SCRIPT_DIR}/keysenderDaemon/Presenter_Server_Keysender_Daemon"
+LOG_FILE="/var/log/presenter_server_keysender_daemon.log"
+
 # Start daemon in background
 echo "Starting key sender daemon."
-# Wait until the user has entered his password, but execute the daemon in background afterwards
-pkexec /bin/bash -c "\"${SCRIPT_DIR}/keysenderDaemon/Presenter_Server_Keysender_Daemon\" &"
+# Wait until the user has entered his password, but execute the daemon in background afterwards.
+# The paths are passed as arguments, so they are not interpreted by the shell.
+pkexec /bin/bash -c '"$0" --log-file "$1" &' "${DAEMON}" "${LOG_FILE}"
 
 # Give the key sender some time to fire up
 sleep 0.5
@@ -0,0 +1,186 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ClientRegistryTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ClientRegistryTest.h"
+
+#include <QVector>
+
+void ClientRegistryTest::verifyLookup()
+{
+    ClientRegistry registry;
+    QObject first;
+    QObject second;
+
+    ClientState* firstClient = registry.add(&first, "first");
+    ClientState* secondClient = registry.add(&second, "second");
+
+    QCOMPARE(registry.size(), 2);
+    QVERIFY(firstClient->id != secondClient->id);
+    QCOMPARE(registry.find(firstClient->id), firstClient);
+    QCOMPARE(registry.find(&second), secondClient);
+    QCOMPARE(secondClient->name, QString("second"));
+    QCOMPARE(secondClient->messages, quint64(0));
+    QVERIFY(registry.find(quint32(0)) == NULL);
+}
+
+void ClientRegistryTest::verifyRemoveReusesState()
+{
+    ClientRegistry registry;
+    QObject first;
+    QObject second;
+
+    ClientState* client = registry.add(&first, "first");
+    quint32 id = client->id;
+    client->messagePart = "incomplete";
+    client->bytesReceived = 42;
+
+    registry.remove(client);
+    QCOMPARE(registry.size(), 0);
+    QVERIFY(registry.find(id) == NULL);
+    QVERIFY(registry.find(&first) == NULL);
+
+    // Removing twice must not put the state twice into the pool
+    registry.remove(client);
+    registry.remove(NULL);
+
+    ClientState* reused = registry.add(&second, "second");
+    QCOMPARE(reused, client);
+    QVERIFY(reused->id != id);
+    QVERIFY(reused->messagePart.isEmpty());
+    QCOMPARE(reused->bytesReceived, quint64(0));
+}
+
+void ClientRegistryTest::verifyManyClients()
+{
+    const int count = 1000;
+    ClientRegistry registry;
+    QVector<QObject*> connections;
+    QVector<ClientState*> clients;
+
+    for (int i = 0; i < count; i++)
+    {
+        connections.append(new QObject());
+        clients.append(registry.add(connections[i], QString::number(i)));
+    }
+    QCOMPARE(registry.size(), count);
+
+    for (int i = 0; i < count; i++)
+    {
+        QCOMPARE(registry.find(connections[i]), clients[i]);
+        QCOMPARE(registry.find(clients[i]->id)->name, QString::number(i));
+    }
+
+    // Remove every second client, the others must not be affected
+    for (int i = 0; i < count; i += 2)
+    {
+        registry.remove(clients[i]);
+    }
+    QCOMPARE(registry.size(), count / 2);
+
+    int visited = 0;
+    for (ClientState* client: registry)
+    {
+        QVERIFY(client->name.toInt() % 2 == 1);
+        visited++;
+    }
+    QCOMPARE(visited, count / 2);
+
+    qDeleteAll(connections);
+}
+
+void ClientRegistryTest::verifyClear()
+{
+    ClientRegistry registry;
+    QObject first;
+    QObject second;
+
+    registry.add(&first, "first");
+    registry.add(&second, "second");
+    registry.clear();
+
+    QCOMPARE(registry.size(), 0);
+    QVERIFY(registry.find(&first) == NULL);
+    QVERIFY(registry.begin() == registry.end());
+}
+
+void ClientRegistryTest::verifyReconnects()
+{
+    ClientRegistry registry;
+    QObject first;
+    QObject second;
+    QObject third;
+    QObject other;
+
+    ClientState* client = registry.add(&first, "phone");
+    QCOMPARE(client->reconnects, 0);
+    registry.remove(client);
+
+    client = registry.add(&second, "phone");
+    QCOMPARE(client->reconnects, 1);
+    QCOMPARE(registry.add(&other, "laptop")->reconnects, 0);
+
+    // Another client behind the same address while the first is connected
+    QCOMPARE(registry.add(&third, "phone")->reconnects, 1);
+    registry.remove(client);
+    registry.remove(registry.find(&third));
+    QCOMPARE(registry.add(&first, "phone")->reconnects, 2);
+}
+
+void ClientRegistryTest::verifyStatistics()
+{
+    ClientRegistry registry;
+    QObject connection;
+
+    ClientState* client = registry.add(&connection, "phone");
+    ClientStatistics statistics = registry.statistics(*client);
+    QCOMPARE(statistics.id, client->id);
+    QCOMPARE(statistics.name, QString("phone"));
+    QCOMPARE(statistics.latencyP50, qint64(-1));
+    QCOMPARE(statistics.latencyP99, qint64(-1));
+
+    client->bytesReceived = 100;
+    client->bytesSent = 200;
+    client->commands = 10;
+    for (int i = 0; i < 99; i++)
+    {
+        client->latency.record(80);
+    }
+    client->latency.record(40000);
+    QTest::qWait(20);
+
+    statistics = registry.statistics(*client);
+    QCOMPARE(statistics.bytesReceived, quint64(100));
+    QCOMPARE(statistics.bytesSent, quint64(200));
+    QVERIFY(statistics.commandsPerSecond > 0);
+    QCOMPARE(statistics.latencyP50, qint64(100));
+    QCOMPARE(statistics.latencyP99, qint64(100));
+    QVERIFY(statistics.idleTime >= 20);
+
+    // The rate is calculated since the previous snapshot
+    QTest::qWait(20);
+    statistics = registry.statistics(*client);
+    QCOMPARE(statistics.commandsPerSecond, 0.0);
+}
+
+QTEST_MAIN(ClientRegistryTest)
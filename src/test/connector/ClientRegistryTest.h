@@ -0,0 +1,83 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ClientRegistryTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_CLIENTREGISTRYTEST_H_
+#define SRC_TEST_CONNECTOR_CLIENTREGISTRYTEST_H_
+
+#include <QTest>
+
+#include "../../main/connector/ClientRegistry.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies the lookup and the pooling of the client registry.
+ */
+class ClientRegistryTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies that clients can be found by id and by connection.
+         */
+        void verifyLookup();
+
+        /**
+         * Verifies that removed clients can't be found anymore and their
+         * state is reused for the next client.
+         */
+        void verifyRemoveReusesState();
+
+        /**
+         * Verifies that a large audience is stored and found correctly.
+         */
+        void verifyManyClients();
+
+        /**
+         * Verifies that clearing the registry removes all clients.
+         */
+        void verifyClear();
+
+        /**
+         * Verifies that a client with the same name counts as reconnect
+         * only if the previous connections with the name were closed.
+         */
+        void verifyReconnects();
+
+        /**
+         * Verifies the statistics snapshot of a client.
+         */
+        void verifyStatistics();
+};
+
+#endif /* SRC_TEST_CONNECTOR_CLIENTREGISTRYTEST_H_ */
@@ -0,0 +1,96 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ClockSyncTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ClockSyncTest.h"
+
+#include <QDateTime>
+
+void ClockSyncTest::verifyExchange()
+{
+    ClockSync sync;
+    QCOMPARE(sync.samples(), 0);
+    QCOMPARE(sync.roundTrip(), qint64(-1));
+    QCOMPARE(sync.offset(), qint64(0));
+
+    // The client clock is 5 s ahead, each direction takes 2 ms and the
+    // client answers after 1 ms
+    QVERIFY(sync.addSample(1000000, 6002000, 6003000, 1005000));
+    QCOMPARE(sync.samples(), 1);
+    QCOMPARE(sync.roundTrip(), qint64(4000));
+    QCOMPARE(sync.offset(), qint64(5000000));
+
+    sync.reset();
+    QCOMPARE(sync.samples(), 0);
+    QCOMPARE(sync.roundTrip(), qint64(-1));
+}
+
+void ClockSyncTest::verifyShortestRoundTrip()
+{
+    ClockSync sync;
+
+    // The request of the fast exchange was delayed less, so its offset is
+    // closer to the truth
+    QVERIFY(sync.addSample(0, 1000, 1000, 2000));
+    QVERIFY(sync.addSample(10000, 18000, 18000, 20000));
+    QCOMPARE(sync.roundTrip(), qint64(2000));
+    QCOMPARE(sync.offset(), qint64(0));
+
+    // Once it left the window, the best of the remaining ones is used
+    for (int i = 1; i < ClockSync::window; i++)
+    {
+        qint64 t0 = 100000 * i;
+        QVERIFY(sync.addSample(t0, t0 + 2000 + i, t0 + 2000 + i,
+                               t0 + 4000 + 2 * i));
+    }
+    QCOMPARE(sync.samples(), ClockSync::window + 1);
+    QCOMPARE(sync.roundTrip(), qint64(4002));
+    QCOMPARE(sync.offset(), qint64(0));
+}
+
+void ClockSyncTest::verifyInvalidExchanges()
+{
+    ClockSync sync;
+
+    // Answered before received, received before sent and a client that
+    // claims to have needed longer than the whole round trip
+    QVERIFY(!sync.addSample(0, 2000, 1000, 3000));
+    QVERIFY(!sync.addSample(3000, 1000, 2000, 0));
+    QVERIFY(!sync.addSample(0, 1000, 9000, 3000));
+
+    QCOMPARE(sync.samples(), 0);
+    QCOMPARE(sync.roundTrip(), qint64(-1));
+}
+
+void ClockSyncTest::verifyNow()
+{
+    qint64 first = ClockSync::now();
+    qint64 system = QDateTime::currentMSecsSinceEpoch() * 1000;
+    QTest::qWait(10);
+    qint64 second = ClockSync::now();
+
+    QVERIFY(second - first >= 10000);
+    QVERIFY(qAbs(first - system) < 1000000);
+}
+
+QTEST_MAIN(ClockSyncTest)
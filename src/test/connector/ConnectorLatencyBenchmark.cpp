@@ -0,0 +1,158 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ConnectorLatencyBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ConnectorLatencyBenchmark.h"
+
+#include <QVector>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+#include "MockKeySender.h"
+
+// The command that is sent in both benchmarks
+static const char* const command =
+        "{ \"type\": \"command\", \"data\": \"nextSlide\" }";
+
+// The number of measured commands
+static const int samples = 200;
+
+// The maximum accepted 99th percentile latency in microseconds. Well below
+// the delayed acknowledgements of tcp, but leaves room for busy machines.
+static const qint64 maxLatency = 20000;
+
+void ConnectorLatencyBenchmark::initTestCase()
+{
+    networkConnector = new NetworkConnector(new MockKeySender());
+    networkConnector->setCommandPort(0);
+    networkConnector->setDiscoveryEnabled(false);
+    networkConnector->startServer();
+    webSocketConnector = new WebSocketConnector(new MockKeySender());
+    webSocketConnector->setPort(0);
+    webSocketConnector->startServer();
+
+    tcpClient = new QTcpSocket();
+    tcpClient->connectToHost(QHostAddress::LocalHost,
+                             networkConnector->commandPort());
+    QVERIFY2(tcpClient->waitForConnected(1000), "Could not connect via tcp");
+
+    webSocketClient = new QTcpSocket();
+    webSocketClient->connectToHost(QHostAddress::LocalHost,
+                                   webSocketConnector->port());
+    QVERIFY2(webSocketClient->waitForConnected(1000),
+             "Could not connect via websocket");
+
+    // The key and accept values are the example from RFC 6455
+    webSocketClient->write("GET / HTTP/1.1\r\n"
+                           "Host: localhost\r\n"
+                           "Upgrade: websocket\r\n"
+                           "Connection: Upgrade\r\n"
+                           "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                           "Sec-WebSocket-Version: 13\r\n\r\n");
+    QTRY_VERIFY_WITH_TIMEOUT(webSocketClient->bytesAvailable() > 0, 1000);
+    QByteArray response = webSocketClient->readAll();
+    QVERIFY(response.startsWith("HTTP/1.1 101"));
+    QVERIFY(response.contains("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="));
+}
+
+void ConnectorLatencyBenchmark::cleanupTestCase()
+{
+    delete tcpClient;
+    delete webSocketClient;
+    delete networkConnector;
+    delete webSocketConnector;
+}
+
+bool ConnectorLatencyBenchmark::sendCommand(QTcpSocket* client,
+                                            const QByteArray& data,
+                                            RemoteControl* connector)
+{
+    QSignalSpy spy(connector, SIGNAL(keySent(QString, QString)));
+    client->write(data);
+    client->flush();
+
+    return spy.wait(1000);
+}
+
+qint64 ConnectorLatencyBenchmark::measure(QTcpSocket* client,
+                                          const QByteArray& data,
+                                          RemoteControl* connector)
+{
+    QVector<qint64> latencies;
+    latencies.reserve(samples);
+    for (int i = 0; i < samples; i++)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        if (!sendCommand(client, data, connector))
+        {
+            return -1;
+        }
+        latencies.append(timer.nsecsElapsed() / 1000);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    qint64 p99 = latencies.at(samples * 99 / 100);
+    qInfo("Latency: median %lld us, p99 %lld us",
+          latencies.at(samples / 2), p99);
+
+    return p99;
+}
+
+QByteArray ConnectorLatencyBenchmark::createFrame(const QByteArray& payload)
+{
+    const char mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+
+    QByteArray frame;
+    frame.append(char(0x81)); // final text frame
+    frame.append(char(0x80 | payload.size())); // masked, short payload
+    frame.append(mask, 4);
+    for (int i = 0; i < payload.size(); i++)
+    {
+        frame.append(char(payload.at(i) ^ mask[i & 3]));
+    }
+
+    return frame;
+}
+
+void ConnectorLatencyBenchmark::benchmarkTcpCommand()
+{
+    qint64 p99 = measure(tcpClient, QByteArray(command) + "\n\n",
+                         networkConnector);
+
+    QVERIFY2(p99 >= 0, "Command was not handled");
+    QVERIFY2(p99 < maxLatency, "99th percentile latency too high");
+}
+
+void ConnectorLatencyBenchmark::benchmarkWebSocketCommand()
+{
+    qint64 p99 = measure(webSocketClient, createFrame(command),
+                         webSocketConnector);
+
+    QVERIFY2(p99 >= 0, "Command was not handled");
+    QVERIFY2(p99 < maxLatency, "99th percentile latency too high");
+}
+
+QTEST_MAIN(ConnectorLatencyBenchmark)
@@ -0,0 +1,131 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ConnectorLatencyBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_CONNECTORLATENCYBENCHMARK_H_
+#define SRC_TEST_CONNECTOR_CONNECTORLATENCYBENCHMARK_H_
+
+#include <QTest>
+#include <QTcpSocket>
+
+#include "../../main/connector/network/NetworkConnector.h"
+#include "../../main/connector/websocket/WebSocketConnector.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Compares the latency of a command sent via the raw tcp connector with a
+ * command sent via the websocket connector. Both run on loopback with a mock
+ * key sender, so the time is spent in the connectors only. They listen on
+ * free ports, so the benchmark can run with the tests, also next to an
+ * installed server. The 99th percentile latency must stay below a generous
+ * threshold, e.g. a connector that waits to fill up tcp segments fails.
+ */
+class ConnectorLatencyBenchmark: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The tcp connector under test.
+         */
+        NetworkConnector* networkConnector;
+
+        /**
+         * The websocket connector under test.
+         */
+        WebSocketConnector* webSocketConnector;
+
+        /**
+         * The client connected to the tcp connector.
+         */
+        QTcpSocket* tcpClient;
+
+        /**
+         * The client connected to the websocket connector.
+         */
+        QTcpSocket* webSocketClient;
+
+        /**
+         * Sends data and waits until the connector handled the command.
+         *
+         * @param client The client to send the data with.
+         * @param data The data to send.
+         * @param connector The connector that receives the data.
+         * @return True if the command was handled.
+         */
+        bool sendCommand(QTcpSocket* client, const QByteArray& data,
+                         RemoteControl* connector);
+
+        /**
+         * Sends a number of commands and reports their latency.
+         *
+         * @param client The client to send the data with.
+         * @param data The data to send.
+         * @param connector The connector that receives the data.
+         * @return The 99th percentile latency in microseconds or -1 if a
+         *         command was not handled.
+         */
+        qint64 measure(QTcpSocket* client, const QByteArray& data,
+                       RemoteControl* connector);
+
+        /**
+         * Creates a masked websocket text frame.
+         *
+         * @param payload The payload of the frame.
+         * @return The frame.
+         */
+        QByteArray createFrame(const QByteArray& payload);
+
+    private slots:
+        /**
+         * Starts both connectors and connects the clients.
+         */
+        void initTestCase();
+
+        /**
+         * Stops the connectors and clients.
+         */
+        void cleanupTestCase();
+
+    private slots:
+        /**
+         * Measures commands sent via the tcp connector.
+         */
+        void benchmarkTcpCommand();
+
+        /**
+         * Measures commands sent via the websocket connector.
+         */
+        void benchmarkWebSocketCommand();
+};
+
+#endif /* SRC_TEST_CONNECTOR_CONNECTORLATENCYBENCHMARK_H_ */
@@ -0,0 +1,300 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ConnectorSoakTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ConnectorSoakTest.h"
+
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QProcessEnvironment>
+
+#include "../../main/connector/websocket/WebSocketConnector.h"
+#include "../../main/diagnostics/ProcessStats.h"
+
+#ifdef __linux__
+    #include "../../keysenderDaemon/KeySenderDaemon.h"
+#endif
+
+// The default number of cycles, small enough for each ctest run
+static const int defaultIterations = 20;
+
+// The maximum growth of the resident memory after the warm up
+static const qint64 maxResidentGrowth = 16 * 1024 * 1024;
+
+// The maximum growth of the allocated heap after the warm up
+static const qint64 maxHeapGrowth = 4 * 1024 * 1024;
+
+// The maximum growth of the open files after the warm up
+static const int maxFileGrowth = 4;
+
+// The number of clients of each connector per cycle
+static const int clientCount = 20;
+
+// The number of clients that connect and disconnect per churn cycle
+static const int churnCount = 200;
+
+// The number of connections to the daemon per cycle
+static const int daemonConnections = 4;
+
+// A websocket upgrade request
+static const char* const webSocketHandshake =
+        "GET / HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "\r\n";
+
+void ConnectorSoakTest::initTestCase()
+{
+    bool isNumber = false;
+    iterations = QProcessEnvironment::systemEnvironment()
+            .value("PRESENTER_SOAK_ITERATIONS").toInt(&isNumber);
+    if (!isNumber || iterations < 2)
+    {
+        iterations = defaultIterations;
+    }
+
+    connector = NULL;
+    keySender = NULL;
+}
+
+void ConnectorSoakTest::cleanup()
+{
+    disconnectClients();
+}
+
+void ConnectorSoakTest::soak(Cycle cycle)
+{
+    int warmUp = qMax(1, iterations / 5);
+    Sample baseline = sample();
+    for (int i = 0; i < iterations; i++)
+    {
+        QVERIFY2((this->*cycle)(), qPrintable(QString("Cycle %1 failed")
+                                                  .arg(i)));
+        if (i + 1 == warmUp)
+        {
+            baseline = sample();
+        }
+    }
+
+    Sample last = sample();
+    qInfo("%d cycles: resident %+lld bytes, heap %+lld bytes, files %+d",
+          iterations, last.resident - baseline.resident,
+          last.heap - baseline.heap, last.files - baseline.files);
+
+    QVERIFY(last.resident - baseline.resident < maxResidentGrowth);
+    if (baseline.heap >= 0)
+    {
+        QVERIFY(last.heap - baseline.heap < maxHeapGrowth);
+    }
+    QVERIFY(last.files - baseline.files < maxFileGrowth);
+}
+
+ConnectorSoakTest::Sample ConnectorSoakTest::sample()
+{
+    // Sockets and connections are deleted later
+    for (int i = 0; i < 3; i++)
+    {
+        QCoreApplication::sendPostedEvents(NULL, QEvent::DeferredDelete);
+        QCoreApplication::processEvents();
+    }
+
+    Sample current;
+    current.resident = ProcessStats::residentBytes();
+    current.heap = ProcessStats::heapBytes();
+    current.files = ProcessStats::openFileCount();
+    return current;
+}
+
+bool ConnectorSoakTest::connectClients(quint16 port, int count,
+                                       const QByteArray& greeting)
+{
+    for (int i = 0; i < count; i++)
+    {
+        QTcpSocket* client = new QTcpSocket();
+        clients.append(client);
+        client->connectToHost(QHostAddress::LocalHost, port);
+        if (!client->waitForConnected(1000))
+        {
+            return false;
+        }
+        client->write(greeting);
+    }
+
+    return true;
+}
+
+void ConnectorSoakTest::disconnectClients()
+{
+    for (QTcpSocket* client: clients)
+    {
+        client->abort();
+        delete client;
+    }
+    clients.clear();
+}
+
+bool ConnectorSoakTest::waitFor(const QSignalSpy& spy, int count)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (spy.count() < count)
+    {
+        if (timer.elapsed() > 5000)
+        {
+            return false;
+        }
+        QTest::qWait(1);
+    }
+
+    return true;
+}
+
+bool ConnectorSoakTest::restartConnectors()
+{
+    NetworkConnector network(new MockKeySender());
+    network.setCommandPort(0);
+    network.setDiscoveryEnabled(false);
+    network.setDatagramCommandsEnabled(false);
+    WebSocketConnector webSocket(new MockKeySender());
+    webSocket.setPort(0);
+
+    QSignalSpy networkClients(&network, SIGNAL(clientConnected(QString)));
+    QSignalSpy webSocketClients(&webSocket,
+                                SIGNAL(clientConnected(QString)));
+
+    network.startServer();
+    webSocket.startServer();
+    if (network.state() != RemoteControl::Running
+        || webSocket.state() != RemoteControl::Running)
+    {
+        return false;
+    }
+
+    bool connected =
+            connectClients(network.commandPort(), clientCount,
+                           "{ \"type\": \"command\", "
+                           "\"data\": \"nextSlide\" }\n\n")
+            && connectClients(webSocket.port(), clientCount,
+                              webSocketHandshake)
+            && waitFor(networkClients, clientCount)
+            && waitFor(webSocketClients, clientCount);
+
+    // The clients are still connected while the connectors stop
+    network.stopServer();
+    webSocket.stopServer();
+    disconnectClients();
+
+    return connected;
+}
+
+bool ConnectorSoakTest::churnClients()
+{
+    QSignalSpy connected(connector, SIGNAL(clientConnected(QString)));
+    QSignalSpy disconnected(connector, SIGNAL(clientDisconnected()));
+
+    if (!connectClients(connector->commandPort(), churnCount,
+                        "{ \"type\": \"command\", "
+                        "\"data\": \"prevSlide\" }\n\n")
+        || !waitFor(connected, churnCount))
+    {
+        return false;
+    }
+
+    for (QTcpSocket* client: clients)
+    {
+        client->disconnectFromHost();
+    }
+    bool done = waitFor(disconnected, churnCount);
+    disconnectClients();
+
+    return done;
+}
+
+bool ConnectorSoakTest::restartDaemonLink()
+{
+#ifdef __linux__
+    KeySenderDaemon* daemon = new KeySenderDaemon(0, true);
+    if (!daemon->isListening())
+    {
+        delete daemon;
+        return false;
+    }
+
+    bool answered = connectClients(daemon->serverPort(), daemonConnections,
+                                   "sendNext\nsendPrev\nping\n");
+    for (QTcpSocket* client: clients)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (answered && !client->canReadLine())
+        {
+            answered = timer.elapsed() < 5000;
+            QTest::qWait(1);
+        }
+        answered = answered && client->readLine() == "pong\n";
+    }
+
+    disconnectClients();
+    delete daemon;
+
+    return answered;
+#else
+    return true;
+#endif
+}
+
+void ConnectorSoakTest::testConnectorRestarts()
+{
+    soak(&ConnectorSoakTest::restartConnectors);
+}
+
+void ConnectorSoakTest::testClientChurn()
+{
+    keySender = new MockKeySender();
+    connector = new NetworkConnector(keySender);
+    connector->setCommandPort(0);
+    connector->setDiscoveryEnabled(false);
+    connector->setDatagramCommandsEnabled(false);
+    connector->startServer();
+    QCOMPARE(connector->state(), RemoteControl::Running);
+
+    soak(&ConnectorSoakTest::churnClients);
+
+    delete connector;
+    connector = NULL;
+    keySender = NULL;
+}
+
+void ConnectorSoakTest::testDaemonLinkRestarts()
+{
+#ifdef __linux__
+    soak(&ConnectorSoakTest::restartDaemonLink);
+#else
+    QSKIP("The key sender daemon only exists on linux");
+#endif
+}
+
+QTEST_MAIN(ConnectorSoakTest)
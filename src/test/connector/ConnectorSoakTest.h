@@ -0,0 +1,204 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ConnectorSoakTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_CONNECTORSOAKTEST_H_
+#define SRC_TEST_CONNECTOR_CONNECTORSOAKTEST_H_
+
+#include <QTest>
+
+#include <QList>
+#include <QTcpSocket>
+#include <QSignalSpy>
+
+#include "../../main/connector/network/NetworkConnector.h"
+#include "MockKeySender.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Repeatedly starts and stops the connectors, connects and disconnects
+ * thousands of clients and restarts the link to the key sender daemon. The
+ * resident memory, the heap and the open files of the process are sampled
+ * over time and the test fails if they keep growing.
+ *
+ * The number of cycles is read from the environment variable
+ * PRESENTER_SOAK_ITERATIONS, so a long soak can be run outside of ctest.
+ */
+class ConnectorSoakTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The resource usage of the process at one point in time.
+         */
+        struct Sample
+        {
+            /**
+             * The resident memory in bytes.
+             */
+            qint64 resident;
+
+            /**
+             * The allocated heap memory in bytes, -1 if not available.
+             */
+            qint64 heap;
+
+            /**
+             * The number of open files.
+             */
+            int files;
+        };
+
+        /**
+         * A single cycle of a soak test.
+         *
+         * @return True if the cycle succeeded.
+         */
+        typedef bool (ConnectorSoakTest::*Cycle)();
+
+        /**
+         * The number of cycles per test.
+         */
+        int iterations;
+
+        /**
+         * The clients of the current cycle.
+         */
+        QList<QTcpSocket*> clients;
+
+        /**
+         * The connector of the client churn test.
+         */
+        NetworkConnector* connector;
+
+        /**
+         * The key sender of the connector, owned by the connector.
+         */
+        MockKeySender* keySender;
+
+        /**
+         * Runs a cycle repeatedly and verifies that the resource usage does
+         * not grow. The first cycles are not measured, so caches and pools
+         * are filled before the baseline is taken.
+         *
+         * @param cycle The cycle to run.
+         */
+        void soak(Cycle cycle);
+
+        /**
+         * Samples the resource usage after all pending deletes are done.
+         *
+         * @return The current resource usage.
+         */
+        static Sample sample();
+
+        /**
+         * Connects new clients to a server.
+         *
+         * @param port The port of the server.
+         * @param count The number of clients.
+         * @param greeting Written by each client after it is connected.
+         * @return True if all clients are connected.
+         */
+        bool connectClients(quint16 port, int count,
+                            const QByteArray& greeting);
+
+        /**
+         * Closes all clients.
+         */
+        void disconnectClients();
+
+        /**
+         * Waits until a signal was emitted a number of times, e.g. until a
+         * server accepted all clients.
+         *
+         * @param spy The spy on the signal.
+         * @param count The expected number of signals.
+         * @return True if the signal was emitted often enough in time.
+         */
+        static bool waitFor(const QSignalSpy& spy, int count);
+
+        /**
+         * Starts the network and the websocket connector, connects clients
+         * to both and stops the connectors with the clients still
+         * connected.
+         *
+         * @return True if the cycle succeeded.
+         */
+        bool restartConnectors();
+
+        /**
+         * Connects and disconnects many clients to a running connector.
+         *
+         * @return True if the cycle succeeded.
+         */
+        bool churnClients();
+
+        /**
+         * Starts a key sender daemon that writes to the null device, sends
+         * commands over several connections and stops the daemon.
+         *
+         * @return True if the cycle succeeded.
+         */
+        bool restartDaemonLink();
+
+    private slots:
+        /**
+         * Reads the number of cycles.
+         */
+        void initTestCase();
+
+        /**
+         * Deletes the remaining clients.
+         */
+        void cleanup();
+
+        /**
+         * Tests that starting and stopping the connectors does not leak.
+         */
+        void testConnectorRestarts();
+
+        /**
+         * Tests that connecting and disconnecting clients does not leak.
+         */
+        void testClientChurn();
+
+        /**
+         * Tests that restarting the daemon and its connections does not
+         * leak. The daemon quits all event loops if a client disconnects,
+         * so this test runs last and all tests only poll for events.
+         */
+        void testDaemonLinkRestarts();
+};
+
+#endif /* SRC_TEST_CONNECTOR_CONNECTORSOAKTEST_H_ */
@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * MdnsResponderTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "MdnsResponderTest.h"
+
+#include <QSignalSpy>
+
+// The ptr record type
+static const quint16 typePtr = 12;
+
+void MdnsResponderTest::init()
+{
+    responder = new MdnsResponder("TestHost", 43155, 0);
+    QVERIFY2(responder->start(), "Could not start responder");
+    QVERIFY(responder->localPort() != 0);
+
+    client = new QUdpSocket();
+    QVERIFY(client->bind(QHostAddress::LocalHost, 0));
+}
+
+void MdnsResponderTest::cleanup()
+{
+    delete client;
+    delete responder;
+}
+
+QByteArray MdnsResponderTest::createQuery(quint16 id, const QByteArray& name,
+                                          quint16 type)
+{
+    QByteArray query;
+    query.append(char(id >> 8)).append(char(id & 0xff));
+    query.append(QByteArray("\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00", 10));
+
+    for (const QByteArray& label: name.split('.'))
+    {
+        query.append(char(label.size())).append(label);
+    }
+    query.append('\0');
+
+    query.append(char(type >> 8)).append(char(type & 0xff));
+    query.append('\0').append('\1');
+
+    return query;
+}
+
+QByteArray MdnsResponderTest::sendQuery(const QByteArray& query)
+{
+    QSignalSpy spy(client, SIGNAL(readyRead()));
+    client->writeDatagram(query, QHostAddress::LocalHost,
+                          responder->localPort());
+
+    if (!client->hasPendingDatagrams() && !spy.wait(500))
+    {
+        return QByteArray();
+    }
+
+    QByteArray answer(int(client->pendingDatagramSize()), '\0');
+    client->readDatagram(answer.data(), answer.size());
+    return answer;
+}
+
+void MdnsResponderTest::verifyServiceQueryAnswered()
+{
+    QByteArray query = createQuery(0x1234, "_presenter._tcp.local", typePtr);
+    QByteArray answer = sendQuery(query);
+
+    // Our client does not use the mdns port, so this is a legacy unicast
+    // query. The answer repeats the id and the question.
+    QVERIFY2(answer.size() > query.size(), "Did not receive an answer");
+    QCOMPARE(answer.left(2), QByteArray("\x12\x34"));
+    QCOMPARE(answer.mid(2, 2), QByteArray("\x84\x00", 2));
+    QCOMPARE(answer.mid(4, 2), QByteArray("\x00\x01", 2));
+    QCOMPARE(answer.mid(6, 6), responder->responsePacket().mid(6, 6));
+    QCOMPARE(answer.mid(12, query.size() - 12), query.mid(12));
+    QVERIFY(answer.contains("Presenter on TestHost"));
+    QVERIFY(answer.contains(QByteArray("\x08testhost\x05local", 15)));
+
+    // The records have short ttls and no cache flush bit. Our names are
+    // not compressed, so the records can be walked label by label.
+    const uchar* data = reinterpret_cast<const uchar*>(answer.constData());
+    int records = (data[6] << 8) | data[7];
+    int offset = query.size();
+    for (int i = 0; i < records; i++)
+    {
+        while (offset < answer.size() && data[offset] != 0)
+        {
+            offset += data[offset] + 1;
+        }
+        offset++;
+        QVERIFY(offset + 10 <= answer.size());
+
+        quint16 recordClass = quint16((data[offset + 2] << 8)
+                                      | data[offset + 3]);
+        quint32 ttl = (quint32(data[offset + 4]) << 24)
+                | (quint32(data[offset + 5]) << 16)
+                | (quint32(data[offset + 6]) << 8) | data[offset + 7];
+        QCOMPARE(recordClass, quint16(1));
+        QVERIFY(ttl <= 10);
+        offset += 10 + ((data[offset + 8] << 8) | data[offset + 9]);
+    }
+    QCOMPARE(offset, answer.size());
+}
+
+void MdnsResponderTest::verifyAllQuestionsRepeated()
+{
+    // A foreign question followed by ours
+    QByteArray query = createQuery(0x4321, "_other._tcp.local", typePtr);
+    query[5] = 2;
+    query.append(createQuery(0, "_presenter._tcp.local", typePtr).mid(12));
+    QByteArray answer = sendQuery(query);
+
+    QVERIFY2(answer.size() > query.size(), "Did not receive an answer");
+    QCOMPARE(answer.left(2), QByteArray("\x43\x21"));
+    QCOMPARE(answer.mid(4, 2), QByteArray("\x00\x02", 2));
+    QCOMPARE(answer.mid(12, query.size() - 12), query.mid(12));
+}
+
+void MdnsResponderTest::verifyQueryIsCaseInsensitive()
+{
+    QByteArray answer = sendQuery(
+            createQuery(1, "Presenter on TestHost._PRESENTER._tcp.local", 33));
+
+    QVERIFY2(!answer.isEmpty(), "Did not receive an answer");
+}
+
+void MdnsResponderTest::verifyForeignQueryIgnored()
+{
+    QByteArray answer = sendQuery(
+            createQuery(1, "_other._tcp.local", typePtr));
+
+    QVERIFY2(answer.isEmpty(), "Answered a foreign query");
+}
+
+void MdnsResponderTest::verifyMalformedQueryIgnored()
+{
+    // Truncated in the middle of a label
+    QByteArray query = createQuery(1, "_presenter._tcp.local", typePtr);
+    QVERIFY(sendQuery(query.left(16)).isEmpty());
+
+    // Compression pointer pointing to itself
+    query = createQuery(1, "_presenter._tcp.local", typePtr).left(12);
+    query.append("\xc0\x0c\x00\x0c\x00\x01", 6);
+    QVERIFY(sendQuery(query).isEmpty());
+
+    // The responder still works afterwards
+    QVERIFY(!sendQuery(createQuery(1, "_presenter._tcp.local", typePtr))
+                .isEmpty());
+}
+
+QTEST_MAIN(MdnsResponderTest)
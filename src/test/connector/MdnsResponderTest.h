@@ -0,0 +1,123 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * MdnsResponderTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_MDNSRESPONDERTEST_H_
+#define SRC_TEST_CONNECTOR_MDNSRESPONDERTEST_H_
+
+#include <QTest>
+#include <QUdpSocket>
+
+#include "../../main/connector/network/MdnsResponder.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies that the mdns responder answers queries for our service.
+ * Uses a loopback client and a non standard port, so the test does not
+ * interfere with a responder running on the system.
+ */
+class MdnsResponderTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The responder under test.
+         */
+        MdnsResponder* responder;
+
+        /**
+         * The client that sends the queries.
+         */
+        QUdpSocket* client;
+
+        /**
+         * Creates a query packet for a single question.
+         *
+         * @param id The query id.
+         * @param name The dotted name to query.
+         * @param type The record type to query.
+         * @return The encoded query.
+         */
+        QByteArray createQuery(quint16 id, const QByteArray& name,
+                               quint16 type);
+
+        /**
+         * Sends a query to the responder and waits for the answer.
+         *
+         * @param query The query to send.
+         * @return The answer or an empty array if no answer was received.
+         */
+        QByteArray sendQuery(const QByteArray& query);
+
+    private slots:
+        /**
+         * Creates and starts the responder and the client.
+         */
+        void init();
+
+        /**
+         * Cleans up the responder and the client.
+         */
+        void cleanup();
+
+    private slots:
+        /**
+         * Verifies that a legacy unicast query for our service type gets
+         * answered with the id and the question of the query, short ttls
+         * and no cache flush bits.
+         */
+        void verifyServiceQueryAnswered();
+
+        /**
+         * Verifies that a legacy unicast answer repeats all questions of
+         * the query.
+         */
+        void verifyAllQuestionsRepeated();
+
+        /**
+         * Verifies that queries are answered case insensitive.
+         */
+        void verifyQueryIsCaseInsensitive();
+
+        /**
+         * Verifies that queries for other services are ignored.
+         */
+        void verifyForeignQueryIgnored();
+
+        /**
+         * Verifies that malformed queries are ignored.
+         */
+        void verifyMalformedQueryIgnored();
+};
+
+#endif /* SRC_TEST_CONNECTOR_MDNSRESPONDERTEST_H_ */
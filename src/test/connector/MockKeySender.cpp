@@ -0,0 +1,57 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * MockKeySender.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "MockKeySender.h"
+
+MockKeySender::MockKeySender() :
+    KeySender(false), nextCount(0), prevCount(0), startCount(0), stopCount(0),
+    moveCount(0), motionX(0), motionY(0)
+{}
+
+void MockKeySender::sendNext()
+{
+    nextCount++;
+}
+
+void MockKeySender::sendPrev()
+{
+    prevCount++;
+}
+
+void MockKeySender::startPresentation()
+{
+    startCount++;
+}
+
+void MockKeySender::stopPresentation()
+{
+    stopCount++;
+}
+
+void MockKeySender::movePointer(int dx, int dy)
+{
+    moveCount++;
+    motionX += dx;
+    motionY += dy;
+}
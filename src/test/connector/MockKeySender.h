@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * MockKeySender.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_MOCKKEYSENDER_H_
+#define SRC_TEST_CONNECTOR_MOCKKEYSENDER_H_
+
+#include "../../main/connector/KeySender.h"
+
+/**
+ * A key sender that just counts the sent keys instead of injecting them.
+ */
+class MockKeySender: public KeySender
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new mock key sender.
+         */
+        MockKeySender();
+
+        /**
+         * Counts the "next" key.
+         */
+        void sendNext();
+
+        /**
+         * Counts the "previous" key.
+         */
+        void sendPrev();
+
+        /**
+         * Counts the "start presentation" key.
+         */
+        void startPresentation();
+
+        /**
+         * Counts the "stop presentation" key.
+         */
+        void stopPresentation();
+
+        /**
+         * Counts the pointer move and adds up the motion.
+         *
+         * @param dx The horizontal motion.
+         * @param dy The vertical motion.
+         */
+        void movePointer(int dx, int dy);
+
+        /**
+         * The number of "next" keys.
+         */
+        int nextCount;
+
+        /**
+         * The number of "previous" keys.
+         */
+        int prevCount;
+
+        /**
+         * The number of "start presentation" keys.
+         */
+        int startCount;
+
+        /**
+         * The number of "stop presentation" keys.
+         */
+        int stopCount;
+
+        /**
+         * The number of pointer moves.
+         */
+        int moveCount;
+
+        /**
+         * The total horizontal motion.
+         */
+        qint64 motionX;
+
+        /**
+         * The total vertical motion.
+         */
+        qint64 motionY;
+};
+
+#endif /* SRC_TEST_CONNECTOR_MOCKKEYSENDER_H_ */
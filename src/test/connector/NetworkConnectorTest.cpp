@@ -0,0 +1,504 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * NetworkConnectorTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "NetworkConnectorTest.h"
+
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+
+#include "../../main/diagnostics/LatencyHistogram.h"
+
+// Minimum number of commands per second with many clients. Low enough for
+// debug builds with coverage on a busy build machine.
+static const int minimumThroughput = 1000;
+
+// Maximum p99 latency of a command in microseconds. Must be a bucket bound
+// of the latency histogram, as percentiles are reported as bucket bounds.
+static const qint64 maximumLatency = 25000;
+
+void NetworkConnectorTest::init()
+{
+    keySender = new MockKeySender();
+    connector = new NetworkConnector(keySender);
+
+    // Don't depend on the ports of an installed server and don't announce
+    // the test server to the network
+    connector->setCommandPort(0);
+    connector->setDiscoveryEnabled(false);
+    connector->setDatagramCommandsEnabled(false);
+}
+
+void NetworkConnectorTest::cleanup()
+{
+    qDeleteAll(clients);
+    clients.clear();
+    delete connector;
+}
+
+bool NetworkConnectorTest::canConnect()
+{
+    QTcpSocket client;
+    client.connectToHost(QHostAddress::LocalHost, connector->commandPort());
+
+    return client.waitForConnected(1000);
+}
+
+bool NetworkConnectorTest::connectClients(int count)
+{
+    QSignalSpy connected(connector, SIGNAL(clientConnected(QString)));
+
+    for (int i = 0; i < count; i++)
+    {
+        QTcpSocket* client = new QTcpSocket();
+        clients.append(client);
+        client->connectToHost(QHostAddress::LocalHost,
+                              connector->commandPort());
+        if (!client->waitForConnected(1000))
+        {
+            return false;
+        }
+    }
+
+    // Wait until the connector accepted all clients
+    QElapsedTimer timer;
+    timer.start();
+    while (connected.count() < count)
+    {
+        if (timer.elapsed() > 5000)
+        {
+            return false;
+        }
+        QTest::qWait(1);
+    }
+
+    return true;
+}
+
+int NetworkConnectorTest::sentKeys() const
+{
+    return keySender->nextCount + keySender->prevCount
+            + keySender->startCount + keySender->stopCount;
+}
+
+QByteArray NetworkConnectorTest::commandMessage(const char* command,
+                                                bool multiLine)
+{
+    return QByteArray("{ \"type\": \"command\",")
+            + (multiLine ? "\n" : " ")
+            + "\"data\": \"" + command + "\" }\n\n";
+}
+
+void NetworkConnectorTest::testStateTransitions()
+{
+    QSignalSpy states(connector, SIGNAL(stateChanged(RemoteControl::State)));
+    QSignalSpy ready(connector, SIGNAL(serverReady()));
+    QSignalSpy stopped(connector, SIGNAL(stopped()));
+
+    QCOMPARE(connector->state(), RemoteControl::Stopped);
+
+    connector->startServer();
+    QCOMPARE(connector->state(), RemoteControl::Running);
+    QCOMPARE(ready.count(), 1);
+    QCOMPARE(states.count(), 2);
+    QCOMPARE(states.at(0).at(0).value<RemoteControl::State>(),
+             RemoteControl::Starting);
+    QCOMPARE(states.at(1).at(0).value<RemoteControl::State>(),
+             RemoteControl::Running);
+
+    connector->stopServer();
+    QCOMPARE(connector->state(), RemoteControl::Stopped);
+    QCOMPARE(stopped.count(), 1);
+    QCOMPARE(states.count(), 4);
+    QCOMPARE(states.at(2).at(0).value<RemoteControl::State>(),
+             RemoteControl::Stopping);
+    QCOMPARE(states.at(3).at(0).value<RemoteControl::State>(),
+             RemoteControl::Stopped);
+}
+
+void NetworkConnectorTest::testStopWhenStopped()
+{
+    QSignalSpy states(connector, SIGNAL(stateChanged(RemoteControl::State)));
+    QSignalSpy stopped(connector, SIGNAL(stopped()));
+
+    connector->stopServer();
+
+    QCOMPARE(connector->state(), RemoteControl::Stopped);
+    QCOMPARE(states.count(), 0);
+    QCOMPARE(stopped.count(), 1);
+}
+
+void NetworkConnectorTest::testStartWhenRunning()
+{
+    QSignalSpy ready(connector, SIGNAL(serverReady()));
+    QSignalSpy error(connector, SIGNAL(error(QString)));
+
+    connector->startServer();
+    connector->startServer();
+
+    QCOMPARE(connector->state(), RemoteControl::Running);
+    QCOMPARE(ready.count(), 1);
+    QCOMPARE(error.count(), 0);
+}
+
+void NetworkConnectorTest::testStartFailure()
+{
+    QTcpServer blocker;
+    QVERIFY(blocker.listen(QHostAddress::Any, 0));
+    connector->setCommandPort(blocker.serverPort());
+
+    QSignalSpy ready(connector, SIGNAL(serverReady()));
+    QSignalSpy error(connector, SIGNAL(error(QString)));
+
+    connector->startServer();
+
+    QCOMPARE(connector->state(), RemoteControl::Stopped);
+    QCOMPARE(ready.count(), 0);
+    QCOMPARE(error.count(), 1);
+
+    // The connector must not keep anything open after the failed start
+    blocker.close();
+    connector->startServer();
+    QCOMPARE(connector->state(), RemoteControl::Running);
+}
+
+void NetworkConnectorTest::testRestart()
+{
+    QSignalSpy ready(connector, SIGNAL(serverReady()));
+    QSignalSpy error(connector, SIGNAL(error(QString)));
+
+    connector->startServer();
+    QVERIFY(canConnect());
+
+    QElapsedTimer timer;
+    timer.start();
+    connector->stopServer();
+    qint64 stopTime = timer.restart();
+    connector->startServer();
+    qint64 restartTime = timer.elapsed();
+
+    qDebug("Stop took %lld ms, restart took %lld ms", stopTime, restartTime);
+
+    QCOMPARE(error.count(), 0);
+    QCOMPARE(ready.count(), 2);
+    QCOMPARE(connector->state(), RemoteControl::Running);
+    QVERIFY(canConnect());
+
+    // Neither needs to wait for a timer or a socket timeout
+    QVERIFY(stopTime < 500);
+    QVERIFY(restartTime < 500);
+}
+
+void NetworkConnectorTest::testConcurrentClients()
+{
+    const int clientCount = 50;
+    const int commandCount = 20;
+
+    connector->startServer();
+    QVERIFY(connectClients(clientCount));
+
+    QByteArray next = commandMessage("nextSlide");
+    QByteArray prev = commandMessage("prevSlide");
+    for (int command = 0; command < commandCount; command++)
+    {
+        for (int i = 0; i < clientCount; i++)
+        {
+            clients[i]->write(i % 2 == 0 ? next : prev);
+        }
+    }
+
+    QTRY_COMPARE(sentKeys(), clientCount * commandCount);
+    QCOMPARE(keySender->nextCount, clientCount / 2 * commandCount);
+    QCOMPARE(keySender->prevCount, clientCount / 2 * commandCount);
+}
+
+void NetworkConnectorTest::testInterleavedFragments()
+{
+    const int clientCount = 8;
+    const int messageCount = 10;
+    const int fragmentCount = 5;
+
+    connector->startServer();
+    QVERIFY(connectClients(clientCount));
+
+    // Each client has its own command, half of them as multi line messages
+    const char* const commands[] = {
+        "nextSlide", "prevSlide", "startPresentation", "stopPresentation"
+    };
+    QList<QByteArray> messages;
+    for (int i = 0; i < clientCount; i++)
+    {
+        messages.append(commandMessage(commands[i % 4], i >= 4));
+    }
+
+    // The fragments split the lines and the empty line that ends a message
+    for (int message = 0; message < messageCount; message++)
+    {
+        for (int fragment = 0; fragment < fragmentCount; fragment++)
+        {
+            for (int i = 0; i < clientCount; i++)
+            {
+                int size = messages[i].size();
+                int start = size * fragment / fragmentCount;
+                int end = size * (fragment + 1) / fragmentCount;
+                clients[i]->write(messages[i].mid(start, end - start));
+                clients[i]->flush();
+            }
+
+            // Let the connector read the fragments before the next ones
+            QTest::qWait(1);
+        }
+    }
+
+    int expected = clientCount / 4 * messageCount;
+    QTRY_COMPARE(sentKeys(), clientCount * messageCount);
+    QCOMPARE(keySender->nextCount, expected);
+    QCOMPARE(keySender->prevCount, expected);
+    QCOMPARE(keySender->startCount, expected);
+    QCOMPARE(keySender->stopCount, expected);
+}
+
+void NetworkConnectorTest::testAcknowledgement()
+{
+    connector->startServer();
+    QVERIFY(connectClients(2));
+
+    // Skip the version messages
+    QTest::qWait(50);
+    clients[0]->readAll();
+    clients[1]->readAll();
+
+    clients[0]->write("{ \"type\": \"command\", \"data\": \"nextSlide\", "
+                      "\"id\": 42 }\n\n");
+    clients[0]->write(commandMessage("prevSlide"));
+
+    QTRY_COMPARE(sentKeys(), 2);
+    QTRY_VERIFY(clients[0]->bytesAvailable() > 0);
+    QCOMPARE(clients[0]->readAll(),
+             QByteArray("{\"data\":42,\"type\":\"ack\"}\n\n"));
+
+    // Commands without id and other clients get no acknowledgement
+    QTest::qWait(50);
+    QCOMPARE(clients[0]->bytesAvailable(), qint64(0));
+    QCOMPARE(clients[1]->bytesAvailable(), qint64(0));
+}
+
+void NetworkConnectorTest::testSchedule()
+{
+    connector->startServer();
+    QVERIFY(connectClients(1));
+
+    // Skip the version message
+    QTest::qWait(50);
+    clients[0]->readAll();
+
+    clients[0]->write("{ \"type\": \"schedule\", \"data\": { \"command\": "
+                      "\"nextSlide\", \"delay\": 0, \"interval\": 100 } }\n\n");
+    QTRY_VERIFY(clients[0]->bytesAvailable() > 0);
+    QCOMPARE(clients[0]->readAll(),
+             QByteArray("{\"data\":1,\"type\":\"scheduled\"}\n\n"));
+
+    QTRY_VERIFY(keySender->nextCount >= 3);
+    clients[0]->write("{ \"type\": \"cancel\", \"data\": 1 }\n\n");
+    QTest::qWait(50);
+    int sent = keySender->nextCount;
+    QTest::qWait(250);
+    QCOMPARE(keySender->nextCount, sent);
+
+    // Intervals below the minimum are rejected with id 0
+    clients[0]->write("{ \"type\": \"schedule\", \"data\": { \"command\": "
+                      "\"prevSlide\", \"delay\": 0, \"interval\": 1 } }\n\n");
+    QTRY_VERIFY(clients[0]->bytesAvailable() > 0);
+    QCOMPARE(clients[0]->readAll(),
+             QByteArray("{\"data\":0,\"type\":\"scheduled\"}\n\n"));
+    QCOMPARE(keySender->prevCount, 0);
+}
+
+void NetworkConnectorTest::testScheduleOwners()
+{
+    connector->startServer();
+    QVERIFY(connectClients(2));
+
+    // Skip the version messages
+    QTest::qWait(50);
+    clients[0]->readAll();
+    clients[1]->readAll();
+
+    clients[0]->write("{ \"type\": \"schedule\", \"data\": { \"command\": "
+                      "\"nextSlide\", \"delay\": 0, \"interval\": 100 } }\n\n");
+    QTRY_VERIFY(clients[0]->bytesAvailable() > 0);
+    QCOMPARE(clients[0]->readAll(),
+             QByteArray("{\"data\":1,\"type\":\"scheduled\"}\n\n"));
+    QTRY_VERIFY(keySender->nextCount >= 1);
+
+    // Another client can't cancel the schedule
+    clients[1]->write("{ \"type\": \"cancel\", \"data\": 1 }\n\n");
+    int sent = keySender->nextCount;
+    QTRY_VERIFY(keySender->nextCount >= sent + 2);
+
+    // The schedule is cancelled once its client disconnects
+    clients[0]->disconnectFromHost();
+    QTest::qWait(50);
+    sent = keySender->nextCount;
+    QTest::qWait(250);
+    QCOMPARE(keySender->nextCount, sent);
+
+    clients[1]->write("{ \"type\": \"schedule\", \"data\": { \"command\": "
+                      "\"prevSlide\", \"delay\": \"0\" } }\n\n");
+    QTRY_VERIFY(clients[1]->bytesAvailable() > 0);
+    QCOMPARE(clients[1]->readAll(),
+             QByteArray("{\"data\":0,\"type\":\"scheduled\"}\n\n"));
+
+    clients[1]->write("{ \"type\": \"schedule\", \"data\": { \"command\": "
+                      "\"prevSlide\", \"delay\": 1e12 } }\n\n");
+    QTRY_VERIFY(clients[1]->bytesAvailable() > 0);
+    QCOMPARE(clients[1]->readAll(),
+             QByteArray("{\"data\":0,\"type\":\"scheduled\"}\n\n"));
+    QCOMPARE(keySender->prevCount, 0);
+}
+
+void NetworkConnectorTest::testTimeSync()
+{
+    const qint64 clientOffset = 5000000;
+
+    connector->startServer();
+    QVERIFY(connectClients(1));
+
+    // Skip the version message
+    QTest::qWait(50);
+    clients[0]->readAll();
+
+    clients[0]->write("{ \"type\": \"timeSync\" }\n\n");
+    QTRY_VERIFY(clients[0]->bytesAvailable() > 0);
+    QJsonObject probe = QJsonDocument::fromJson(clients[0]->readAll())
+            .object();
+    QCOMPARE(probe["type"].toString(), QString("timeSync"));
+    qint64 t0 = qint64(probe["data"].toObject()["t0"].toDouble());
+    QVERIFY(t0 > 0);
+
+    // Answer as a client with a clock that is ahead, so the offset is
+    // known up to the round trip
+    QJsonObject answer;
+    answer["t0"] = double(t0);
+    answer["t1"] = double(t0 + clientOffset);
+    answer["t2"] = double(t0 + clientOffset);
+    QJsonObject message;
+    message["type"] = QString("timeSync");
+    message["data"] = answer;
+    QByteArray answerMessage = QJsonDocument(message).toJson() + "\n\n";
+    clients[0]->write(answerMessage);
+
+    QTRY_VERIFY(clients[0]->bytesAvailable() > 0);
+    QJsonObject synced = QJsonDocument::fromJson(clients[0]->readAll())
+            .object();
+    QCOMPARE(synced["type"].toString(), QString("timeSynced"));
+    qint64 roundTrip = qint64(synced["data"].toObject()["roundTrip"]
+            .toDouble());
+    qint64 offset = qint64(synced["data"].toObject()["offset"].toDouble());
+    QVERIFY(roundTrip >= 0);
+    QVERIFY(offset <= clientOffset);
+    QVERIFY(offset >= clientOffset - roundTrip);
+
+    // Replayed answers are ignored
+    clients[0]->write(answerMessage);
+    QTest::qWait(50);
+    QCOMPARE(clients[0]->bytesAvailable(), qint64(0));
+}
+
+void NetworkConnectorTest::testPointerMotion()
+{
+    connector->startServer();
+    QVERIFY(connectClients(1));
+
+    // Moves may even arrive between the lines of a message
+    clients[0]->write("@3,-4\n{ \"type\": \"command\",\n@1,1\n"
+                      "\"data\": \"nextSlide\" }\n\n");
+    clients[0]->write("@x\n@" + QByteArray(100, '1') + "\n@-2,0\r\n");
+
+    QTRY_COMPARE(keySender->moveCount, 3);
+    QCOMPARE(keySender->motionX, qint64(2));
+    QCOMPARE(keySender->motionY, qint64(-3));
+    QCOMPARE(keySender->nextCount, 1);
+}
+
+void NetworkConnectorTest::testThroughput()
+{
+    const int clientCount = 32;
+    const int commandCount = 200;
+
+    connector->startServer();
+    QVERIFY(connectClients(clientCount));
+
+    QByteArray next = commandMessage("nextSlide");
+    QElapsedTimer timer;
+    timer.start();
+    for (int command = 0; command < commandCount; command++)
+    {
+        for (QTcpSocket* client: clients)
+        {
+            client->write(next);
+        }
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(keySender->nextCount,
+                              clientCount * commandCount, 30000);
+    qint64 elapsed = qMax(timer.elapsed(), qint64(1));
+    qint64 throughput = qint64(clientCount) * commandCount * 1000 / elapsed;
+
+    qDebug("Handled %d commands in %lld ms, %lld commands/s",
+           clientCount * commandCount, elapsed, throughput);
+    QVERIFY2(throughput >= minimumThroughput,
+             qPrintable(QString("Only %1 commands/s").arg(throughput)));
+}
+
+void NetworkConnectorTest::testLatency()
+{
+    const int commandCount = 500;
+
+    connector->startServer();
+    QVERIFY(connectClients(1));
+
+    QSignalSpy keySent(connector, SIGNAL(keySent(QString, QString)));
+    QByteArray next = commandMessage("nextSlide");
+    LatencyHistogram latency;
+    QElapsedTimer timer;
+    for (int command = 0; command < commandCount; command++)
+    {
+        timer.start();
+        clients[0]->write(next);
+        clients[0]->flush();
+        QVERIFY(keySent.wait(1000));
+        latency.record(timer.nsecsElapsed() / 1000);
+    }
+
+    qint64 p99 = latency.percentile(0.99);
+    qDebug("p50 %lld us, p99 %lld us", latency.percentile(0.5), p99);
+    QCOMPARE(keySender->nextCount, commandCount);
+    QVERIFY2(p99 <= maximumLatency,
+             qPrintable(QString("p99 latency %1 us").arg(p99)));
+}
+
+QTEST_MAIN(NetworkConnectorTest)
@@ -0,0 +1,194 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * NetworkConnectorTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_NETWORKCONNECTORTEST_H_
+#define SRC_TEST_CONNECTOR_NETWORKCONNECTORTEST_H_
+
+#include <QTest>
+
+#include <QList>
+#include <QTcpSocket>
+
+#include "../../main/connector/network/NetworkConnector.h"
+#include "MockKeySender.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Tests the lifecycle of the network connector and drives it with loopback
+ * clients. The connector listens on a free port without discovery, so the
+ * tests don't depend on the system and don't send to the network.
+ */
+class NetworkConnectorTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The connector under test.
+         */
+        NetworkConnector* connector;
+
+        /**
+         * The key sender of the connector, owned by the connector.
+         */
+        MockKeySender* keySender;
+
+        /**
+         * The clients of the current test.
+         */
+        QList<QTcpSocket*> clients;
+
+        /**
+         * Checks that a client can connect to the command port.
+         *
+         * @return True if the connection was accepted.
+         */
+        bool canConnect();
+
+        /**
+         * Connects new clients to the running connector.
+         *
+         * @param count The number of clients.
+         * @return True if all clients are connected.
+         */
+        bool connectClients(int count);
+
+        /**
+         * Returns the number of keys the connector sent.
+         *
+         * @return The number of keys.
+         */
+        int sentKeys() const;
+
+        /**
+         * Creates a protocol message with a command.
+         *
+         * @param command The command, e.g. "nextSlide".
+         * @param multiLine If the message should be split into several
+         *                  lines.
+         * @return The message.
+         */
+        static QByteArray commandMessage(const char* command,
+                                         bool multiLine = false);
+
+    private slots:
+        /**
+         * Creates the connector.
+         */
+        void init();
+
+        /**
+         * Deletes the connector.
+         */
+        void cleanup();
+
+        /**
+         * Tests the states while starting and stopping the server.
+         */
+        void testStateTransitions();
+
+        /**
+         * Tests that stopping a stopped server only reports completion.
+         */
+        void testStopWhenStopped();
+
+        /**
+         * Tests that starting a running server does nothing.
+         */
+        void testStartWhenRunning();
+
+        /**
+         * Tests that the server is stopped if the port is in use.
+         */
+        void testStartFailure();
+
+        /**
+         * Tests that the server can be started again right after it stopped,
+         * and measures the time to stop and to restart it.
+         */
+        void testRestart();
+
+        /**
+         * Tests that the commands of many concurrent clients are all
+         * handled.
+         */
+        void testConcurrentClients();
+
+        /**
+         * Tests that messages which are received in fragments, interleaved
+         * with the fragments of other clients, don't corrupt each other.
+         */
+        void testInterleavedFragments();
+
+        /**
+         * Tests that commands with an id are acknowledged to their sender
+         * only.
+         */
+        void testAcknowledgement();
+
+        /**
+         * Tests that scheduled commands are sent periodically until they
+         * are cancelled and that invalid schedules are rejected.
+         */
+        void testSchedule();
+
+        /**
+         * Tests that only the owner cancels a schedule, that schedules are
+         * cancelled with their client and that durations which are no
+         * valid numbers are rejected.
+         */
+        void testScheduleOwners();
+
+        /**
+         * Tests the timestamp exchange of the clock synchronization.
+         */
+        void testTimeSync();
+
+        /**
+         * Tests that pointer moves are forwarded between protocol messages
+         * and invalid moves are dropped.
+         */
+        void testPointerMotion();
+
+        /**
+         * Tests the minimum throughput with many clients sending at once.
+         */
+        void testThroughput();
+
+        /**
+         * Tests the maximum p99 latency of single commands.
+         */
+        void testLatency();
+};
+
+#endif /* SRC_TEST_CONNECTOR_NETWORKCONNECTORTEST_H_ */
@@ -0,0 +1,225 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ProtocolBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ProtocolBenchmark.h"
+
+#include <QStringList>
+
+// A command as sent by the android app
+static const char* const command =
+        "{ \"type\": \"command\", \"data\": \"nextSlide\" }";
+
+// The size of the garbage inputs. Far more than a client ever sends.
+static const int garbageSize = 64 * 1024;
+
+// The nesting of the deeply nested input. Below the limit of the json
+// parser, so it is really parsed.
+static const int nesting = 512;
+
+BenchmarkConnector::BenchmarkConnector(KeySender* keySender) :
+    RemoteControl(keySender), client(clients.add(this, "benchmark"))
+{}
+
+bool BenchmarkConnector::start()
+{
+    return true;
+}
+
+void BenchmarkConnector::stop()
+{}
+
+void BenchmarkConnector::write(const QString& message)
+{
+    Q_UNUSED(message);
+}
+
+void ProtocolBenchmark::init()
+{
+    keySender = new MockKeySender();
+    connector = new BenchmarkConnector(keySender);
+}
+
+void ProtocolBenchmark::cleanup()
+{
+    delete connector;
+}
+
+int ProtocolBenchmark::sentKeys() const
+{
+    return keySender->nextCount + keySender->prevCount
+            + keySender->startCount + keySender->stopCount;
+}
+
+void ProtocolBenchmark::benchmarkHandleMessage_data()
+{
+    QTest::addColumn<QString>("message");
+    QTest::addColumn<int>("keys");
+
+    QTest::newRow("tiny command") << QString(command) << 1;
+    QTest::newRow("command with id")
+            << QString("{ \"type\": \"command\", \"data\": \"nextSlide\", "
+                       "\"id\": 42 }") << 1;
+    QTest::newRow("unknown command")
+            << QString("{ \"type\": \"command\", \"data\": \"jump\" }") << 0;
+    QTest::newRow("unknown type")
+            << QString("{ \"type\": \"chat\", \"data\": \"hello\" }") << 0;
+    QTest::newRow("truncated")
+            << QString("{ \"type\": \"command\", \"data\": ") << 0;
+    QTest::newRow("huge garbage") << QString(garbageSize, 'x') << 0;
+    QTest::newRow("huge string")
+            << QString("{ \"type\": \"command\", \"data\": \"%1\" }")
+                   .arg(QString(garbageSize, 'x')) << 0;
+    QTest::newRow("deeply nested")
+            << QString(nesting, '[') + QString(nesting, ']') << 0;
+}
+
+void ProtocolBenchmark::benchmarkHandleMessage()
+{
+    QFETCH(QString, message);
+    QFETCH(int, keys);
+
+    connector->handleMessage("benchmark", message, connector->client);
+    QCOMPARE(sentKeys(), keys);
+
+    QBENCHMARK
+    {
+        connector->handleMessage("benchmark", message, connector->client);
+    }
+}
+
+void ProtocolBenchmark::benchmarkHandleMotion_data()
+{
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("dx");
+    QTest::addColumn<int>("dy");
+
+    QTest::newRow("small") << QByteArray("@3,-4") << true << 3 << -4;
+    QTest::newRow("line end") << QByteArray("@-12,0\r\n") << true << -12 << 0;
+    QTest::newRow("maximum") << QByteArray("@4096,-4096") << true << 4096
+                             << -4096;
+    QTest::newRow("too big") << QByteArray("@4097,0") << false << 0 << 0;
+    QTest::newRow("overflow") << QByteArray("@99999999999,0") << false << 0
+                              << 0;
+    QTest::newRow("missing value") << QByteArray("@3,") << false << 0 << 0;
+    QTest::newRow("only sign") << QByteArray("@-,1") << false << 0 << 0;
+    QTest::newRow("trailing garbage") << QByteArray("@3,4x") << false << 0
+                                      << 0;
+    QTest::newRow("spaces") << QByteArray("@ 3, 4") << false << 0 << 0;
+}
+
+void ProtocolBenchmark::benchmarkHandleMotion()
+{
+    QFETCH(QByteArray, message);
+    QFETCH(bool, valid);
+    QFETCH(int, dx);
+    QFETCH(int, dy);
+
+    int parsedX = 0;
+    int parsedY = 0;
+    QCOMPARE(RemoteControl::parseMotion(message.constData(), message.length(),
+                                        &parsedX, &parsedY), valid);
+    if (valid)
+    {
+        QCOMPARE(parsedX, dx);
+        QCOMPARE(parsedY, dy);
+    }
+    connector->handleMotion(*connector->client, message.constData(),
+                            message.length());
+    QCOMPARE(keySender->moveCount, valid ? 1 : 0);
+    QCOMPARE(keySender->motionX, qint64(dx));
+    QCOMPARE(keySender->motionY, qint64(dy));
+
+    QBENCHMARK
+    {
+        connector->handleMotion(*connector->client, message.constData(),
+                                message.length());
+    }
+}
+
+void ProtocolBenchmark::benchmarkHandleLine_data()
+{
+    QTest::addColumn<QStringList>("lines");
+    QTest::addColumn<int>("keys");
+
+    QTest::newRow("single line") << QStringList(command) << 1;
+    QTest::newRow("two lines")
+            << (QStringList() << "{ \"type\": \"command\","
+                              << "\"data\": \"nextSlide\" }") << 1;
+
+    // Each character of the command in its own line
+    QStringList fragments;
+    QString message(command);
+    for (int i = 0; i < message.length(); i++)
+    {
+        fragments.append(message.mid(i, 1));
+    }
+    QTest::newRow("many fragments") << fragments << 1;
+
+    QTest::newRow("huge garbage line")
+            << QStringList(QString(garbageSize, 'x')) << 0;
+
+    QStringList garbage;
+    for (int i = 0; i < garbageSize / 64; i++)
+    {
+        garbage.append(QString(64, 'x'));
+    }
+    QTest::newRow("many garbage lines") << garbage << 0;
+}
+
+void ProtocolBenchmark::benchmarkHandleLine()
+{
+    QFETCH(QStringList, lines);
+    QFETCH(int, keys);
+
+    // The empty line completes the message
+    lines.append(QString());
+
+    for (const QString& line: lines)
+    {
+        connector->handleLine(*connector->client, line);
+    }
+    QCOMPARE(sentKeys(), keys);
+
+    QBENCHMARK
+    {
+        for (const QString& line: lines)
+        {
+            connector->handleLine(*connector->client, line);
+        }
+    }
+}
+
+void ProtocolBenchmark::benchmarkClientConnected()
+{
+    QVERIFY(RemoteControl::versionMessage().contains("\"minVersion\""));
+    QVERIFY(RemoteControl::versionMessage().endsWith("\n\n"));
+
+    QBENCHMARK
+    {
+        connector->handleClientConnected("benchmark");
+    }
+}
+
+QTEST_MAIN(ProtocolBenchmark)
@@ -0,0 +1,183 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ProtocolBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_PROTOCOLBENCHMARK_H_
+#define SRC_TEST_CONNECTOR_PROTOCOLBENCHMARK_H_
+
+#include <QTest>
+
+#include "../../main/connector/RemoteControl.h"
+#include "MockKeySender.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * A connector without a server. Exposes the protocol handling of the remote
+ * control, so it can be measured without any network in between.
+ */
+class BenchmarkConnector: public RemoteControl
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new connector with a single registered client.
+         *
+         * @param keySender The key sender, owned by the connector.
+         */
+        BenchmarkConnector(KeySender* keySender);
+
+        /**
+         * The registered client that sends all messages.
+         */
+        ClientState* client;
+
+        /**
+         * Exposes the handling of a new client.
+         */
+        using RemoteControl::handleClientConnected;
+
+        /**
+         * Exposes the handling of received lines.
+         */
+        using RemoteControl::handleLine;
+
+        /**
+         * Exposes the handling of complete messages.
+         */
+        using RemoteControl::handleMessage;
+
+        /**
+         * Exposes the handling of pointer moves.
+         */
+        using RemoteControl::handleMotion;
+
+    protected:
+        /**
+         * Nothing to start.
+         *
+         * @return Always true.
+         */
+        bool start();
+
+        /**
+         * Nothing to stop.
+         */
+        void stop();
+
+        /**
+         * Drops the message.
+         *
+         * @param message The message, unused.
+         */
+        void write(const QString& message);
+};
+
+/**
+ * Measures the protocol handling of the connectors: parsing of complete
+ * messages, collecting messages from lines and creating the version
+ * message for new clients. The inputs range from tiny commands to huge
+ * garbage and messages split into many fragments, so improvements of the
+ * hot path can be measured and regressions are visible.
+ */
+class ProtocolBenchmark: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The connector that handles the messages.
+         */
+        BenchmarkConnector* connector;
+
+        /**
+         * The key sender of the connector, owned by the connector.
+         */
+        MockKeySender* keySender;
+
+        /**
+         * Returns the number of keys the connector sent.
+         *
+         * @return The number of keys.
+         */
+        int sentKeys() const;
+
+    private slots:
+        /**
+         * Creates the connector.
+         */
+        void init();
+
+        /**
+         * Deletes the connector.
+         */
+        void cleanup();
+
+        /**
+         * The messages for {@link #benchmarkHandleMessage}.
+         */
+        void benchmarkHandleMessage_data();
+
+        /**
+         * Measures the handling of a complete message.
+         */
+        void benchmarkHandleMessage();
+
+        /**
+         * The moves for {@link #benchmarkHandleMotion}.
+         */
+        void benchmarkHandleMotion_data();
+
+        /**
+         * Measures decoding and forwarding a pointer move, which happens at
+         * the rate of the motion of each client.
+         */
+        void benchmarkHandleMotion();
+
+        /**
+         * The lines for {@link #benchmarkHandleLine}.
+         */
+        void benchmarkHandleLine_data();
+
+        /**
+         * Measures collecting a message from its lines and handling it.
+         */
+        void benchmarkHandleLine();
+
+        /**
+         * Measures the handling of a new client, which is sent the version
+         * message.
+         */
+        void benchmarkClientConnected();
+};
+
+#endif /* SRC_TEST_CONNECTOR_PROTOCOLBENCHMARK_H_ */
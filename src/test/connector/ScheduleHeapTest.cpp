@@ -0,0 +1,167 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ScheduleHeapTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "ScheduleHeapTest.h"
+
+#include <QList>
+
+Schedule ScheduleHeapTest::schedule(quint32 id, qint64 deadline,
+                                    qint64 interval, quintptr owner)
+{
+    Schedule schedule;
+    schedule.id = id;
+    schedule.owner = owner;
+    schedule.command = 0;
+    schedule.deadline = deadline;
+    schedule.interval = interval;
+
+    return schedule;
+}
+
+void ScheduleHeapTest::verifyOrder()
+{
+    const int count = 100;
+    ScheduleHeap heap;
+    QCOMPARE(heap.nextDeadline(), qint64(-1));
+
+    // A fixed permutation of the deadlines
+    for (int i = 0; i < count; i++)
+    {
+        quint32 id = quint32((i * 37) % count);
+        heap.add(schedule(id, qint64(id) * 10));
+    }
+    QCOMPARE(heap.size(), count);
+    QCOMPARE(heap.nextDeadline(), qint64(0));
+
+    Schedule due;
+    QVERIFY(!heap.takeDue(-1, &due));
+    for (int i = 0; i < count; i++)
+    {
+        QVERIFY(heap.takeDue(count * 10, &due));
+        QCOMPARE(due.id, quint32(i));
+        QCOMPARE(due.deadline, qint64(i) * 10);
+    }
+    QVERIFY(!heap.takeDue(count * 10, &due));
+    QCOMPARE(heap.size(), 0);
+}
+
+void ScheduleHeapTest::verifyCancel()
+{
+    ScheduleHeap heap;
+    for (quint32 id = 1; id <= 10; id++)
+    {
+        heap.add(schedule(id, id * 100));
+    }
+
+    QVERIFY(heap.cancel(1));
+    QVERIFY(heap.cancel(5));
+    QVERIFY(!heap.cancel(5));
+    QVERIFY(!heap.cancel(42));
+    QCOMPARE(heap.size(), 8);
+    QCOMPARE(heap.nextDeadline(), qint64(200));
+
+    QList<quint32> ran;
+    Schedule due;
+    while (heap.takeDue(1000, &due))
+    {
+        ran.append(due.id);
+    }
+    QCOMPARE(ran, QList<quint32>() << 2 << 3 << 4 << 6 << 7 << 8 << 9 << 10);
+
+    heap.add(schedule(1, 100));
+    heap.clear();
+    QCOMPARE(heap.size(), 0);
+    QCOMPARE(heap.nextDeadline(), qint64(-1));
+}
+
+void ScheduleHeapTest::verifyOwners()
+{
+    // Both owners use the same ids
+    ScheduleHeap heap;
+    for (quint32 id = 1; id <= 10; id++)
+    {
+        heap.add(schedule(id, id * 100, 0, 1));
+        heap.add(schedule(id, id * 100 + 50, 0, 2));
+    }
+
+    QVERIFY(heap.cancel(1, 1));
+    QVERIFY(!heap.cancel(1, 1));
+    QVERIFY(!heap.cancel(1, 3));
+    QCOMPARE(heap.size(), 19);
+    QCOMPARE(heap.nextDeadline(), qint64(150));
+
+    QCOMPARE(heap.cancelAll(2), 10);
+    QCOMPARE(heap.cancelAll(2), 0);
+    QCOMPARE(heap.size(), 9);
+
+    QList<quint32> ran;
+    Schedule due;
+    while (heap.takeDue(1000, &due))
+    {
+        QCOMPARE(due.owner, quintptr(1));
+        ran.append(due.id);
+    }
+    QCOMPARE(ran, QList<quint32>() << 2 << 3 << 4 << 5 << 6 << 7 << 8 << 9
+                                   << 10);
+}
+
+void ScheduleHeapTest::verifyNoDrift()
+{
+    const qint64 interval = 1000;
+    ScheduleHeap heap;
+    heap.add(schedule(1, interval, interval));
+
+    // Each wakeup is late, but the deadlines stay on the grid
+    Schedule due;
+    for (qint64 period = 1; period <= 10; period++)
+    {
+        qint64 now = period * interval + 300;
+        QVERIFY(heap.takeDue(now, &due));
+        QCOMPARE(due.deadline, period * interval);
+        QVERIFY(!heap.takeDue(now, &due));
+        QCOMPARE(heap.nextDeadline(), (period + 1) * interval);
+    }
+    QCOMPARE(heap.size(), 1);
+}
+
+void ScheduleHeapTest::verifySkipMissedPeriods()
+{
+    const qint64 interval = 1000;
+    ScheduleHeap heap;
+    heap.add(schedule(1, interval, interval));
+    heap.add(schedule(2, 5500));
+
+    // Both are due once, the missed periods are dropped
+    Schedule due;
+    QVERIFY(heap.takeDue(5600, &due));
+    QCOMPARE(due.id, quint32(1));
+    QVERIFY(heap.takeDue(5600, &due));
+    QCOMPARE(due.id, quint32(2));
+    QVERIFY(!heap.takeDue(5600, &due));
+
+    QCOMPARE(heap.size(), 1);
+    QCOMPARE(heap.nextDeadline(), 6 * interval);
+}
+
+QTEST_MAIN(ScheduleHeapTest)
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * ScheduleHeapTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_SCHEDULEHEAPTEST_H_
+#define SRC_TEST_CONNECTOR_SCHEDULEHEAPTEST_H_
+
+#include <QTest>
+
+#include "../../main/connector/ScheduleHeap.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies the order and the periods of the scheduled commands.
+ */
+class ScheduleHeapTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * Creates a schedule.
+         *
+         * @param id The id of the schedule.
+         * @param deadline The first deadline.
+         * @param interval The interval, 0 to run once.
+         * @param owner The owner of the schedule.
+         * @return The schedule.
+         */
+        static Schedule schedule(quint32 id, qint64 deadline,
+                                 qint64 interval = 0, quintptr owner = 0);
+
+    private slots:
+        /**
+         * Verifies that schedules are due in the order of their deadlines,
+         * independent of the order they were added.
+         */
+        void verifyOrder();
+
+        /**
+         * Verifies that cancelled schedules don't run and the others keep
+         * their order.
+         */
+        void verifyCancel();
+
+        /**
+         * Verifies that the same ids of different owners don't collide and
+         * that cancelling all schedules of an owner keeps the others.
+         */
+        void verifyOwners();
+
+        /**
+         * Verifies that late wakeups don't shift the deadlines of periodic
+         * schedules.
+         */
+        void verifyNoDrift();
+
+        /**
+         * Verifies that missed periods are skipped instead of running in a
+         * burst.
+         */
+        void verifySkipMissedPeriods();
+};
+
+#endif /* SRC_TEST_CONNECTOR_SCHEDULEHEAPTEST_H_ */
@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * SequenceWindowTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "SequenceWindowTest.h"
+
+void SequenceWindowTest::verifyDuplicates()
+{
+    SequenceWindow window;
+    QVERIFY(window.accept(5));
+    QVERIFY(!window.accept(5));
+
+    // A gap is filled by late datagrams, each once
+    QVERIFY(window.accept(8));
+    QVERIFY(window.accept(6));
+    QVERIFY(!window.accept(6));
+    QVERIFY(!window.accept(8));
+    QCOMPARE(window.highest(), quint32(8));
+    QCOMPARE(window.received(), quint64(0xd));
+
+    QVERIFY(window.accept(7));
+    QCOMPARE(window.received(), quint64(0xf));
+}
+
+void SequenceWindowTest::verifyWindowMoves()
+{
+    SequenceWindow window;
+    QVERIFY(window.accept(100));
+    QVERIFY(window.accept(100 + SequenceWindow::size - 1));
+
+    // The first one is at the end of the window
+    QCOMPARE(window.received(),
+             (Q_UINT64_C(1) << (SequenceWindow::size - 1)) | 1);
+    QVERIFY(!window.accept(100));
+
+    // A jump beyond the window only keeps the new sequence number
+    QVERIFY(window.accept(1000));
+    QCOMPARE(window.highest(), quint32(1000));
+    QCOMPARE(window.received(), quint64(1));
+}
+
+void SequenceWindowTest::verifyWrapAround()
+{
+    SequenceWindow window;
+    QVERIFY(window.accept(0xfffffffe));
+    QVERIFY(window.accept(1));
+    QCOMPARE(window.highest(), quint32(1));
+    QVERIFY(window.accept(0xffffffff));
+    QVERIFY(window.accept(0));
+    QVERIFY(!window.accept(0xfffffffe));
+    QVERIFY(!window.accept(0xffffffff));
+    QCOMPARE(window.received(), quint64(0xf));
+
+    // Half of the number space apart is neither newer nor in the window
+    SequenceWindow half;
+    QVERIFY(half.accept(10));
+    QVERIFY(!half.accept(10 + 0x80000000u));
+    QCOMPARE(half.highest(), quint32(10));
+    QVERIFY(half.accept(11));
+}
+
+void SequenceWindowTest::verifyRestart()
+{
+    SequenceWindow window;
+    for (quint32 sequence = 0; sequence < 200; sequence++)
+    {
+        QVERIFY(window.accept(sequence));
+    }
+
+    // Behind the window, it might be an old duplicate
+    QVERIFY(!window.accept(0));
+    QVERIFY(!window.accept(199 - SequenceWindow::size));
+    QCOMPARE(window.highest(), quint32(199));
+
+    // The owner of the window detects that the sender started over
+    window.reset();
+    QVERIFY(window.accept(0));
+    QVERIFY(!window.accept(0));
+    QCOMPARE(window.received(), quint64(1));
+}
+
+QTEST_MAIN(SequenceWindowTest)
@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * SequenceWindowTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_SEQUENCEWINDOWTEST_H_
+#define SRC_TEST_CONNECTOR_SEQUENCEWINDOWTEST_H_
+
+#include <QTest>
+
+#include "../../main/connector/network/SequenceWindow.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies the duplicate detection of command datagrams.
+ */
+class SequenceWindowTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies that duplicates are dropped, also if they arrive out of
+         * order.
+         */
+        void verifyDuplicates();
+
+        /**
+         * Verifies that the window moves with new sequence numbers and that
+         * big jumps clear it.
+         */
+        void verifyWindowMoves();
+
+        /**
+         * Verifies that the window continues across the wrap around of the
+         * sequence number and drops numbers half of the number space apart.
+         */
+        void verifyWrapAround();
+
+        /**
+         * Verifies that sequence numbers behind the window are dropped and
+         * that a sender that starts over is accepted after a reset.
+         */
+        void verifyRestart();
+};
+
+#endif /* SRC_TEST_CONNECTOR_SEQUENCEWINDOWTEST_H_ */
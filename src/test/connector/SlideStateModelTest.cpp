@@ -0,0 +1,97 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * SlideStateModelTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "SlideStateModelTest.h"
+
+#include <QSignalSpy>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+void SlideStateModelTest::verifySlidePosition()
+{
+    SlideStateModel model;
+    QCOMPARE(model.slide(), 0);
+    QVERIFY(!model.isPresenting());
+
+    model.keySent("client", "startPresentation");
+    QVERIFY(model.isPresenting());
+
+    model.keySent("client", "nextSlide");
+    model.keySent("client", "nextSlide");
+    model.keySent("client", "prevSlide");
+    QCOMPARE(model.slide(), 1);
+
+    model.keySent("client", "stopPresentation");
+    QVERIFY(!model.isPresenting());
+    QCOMPARE(model.slide(), 1);
+
+    model.keySent("client", "startPresentation");
+    QCOMPARE(model.slide(), 0);
+}
+
+void SlideStateModelTest::verifyNoEventWithoutChange()
+{
+    SlideStateModel model;
+    QSignalSpy spy(&model, SIGNAL(stateChanged(QByteArray)));
+
+    model.keySent("client", "prevSlide");
+    model.keySent("client", "stopPresentation");
+    model.keySent("client", "unknown");
+    QCOMPARE(spy.count(), 0);
+
+    model.keySent("client", "nextSlide");
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toByteArray(), model.event());
+}
+
+void SlideStateModelTest::verifyEventEncoding()
+{
+    SlideStateModel model;
+    model.keySent("client", "startPresentation");
+    model.keySent("client", "nextSlide");
+
+    QByteArray event = model.event();
+    QVERIFY(event.endsWith("\n\n"));
+
+    QJsonObject message = QJsonDocument::fromJson(event.trimmed()).object();
+    QCOMPARE(message["type"].toString(), QString("slideState"));
+
+    QJsonObject state = QJsonDocument::fromJson(
+            message["data"].toString().toUtf8()).object();
+    QCOMPARE(state["slide"].toInt(), 1);
+    QCOMPARE(state["presenting"].toBool(), true);
+}
+
+void SlideStateModelTest::verifyPublish()
+{
+    SlideStateModel model;
+    model.keySent("client", "nextSlide");
+
+    QSignalSpy spy(&model, SIGNAL(stateChanged(QByteArray)));
+    model.publish();
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toByteArray(), model.event());
+}
+
+QTEST_MAIN(SlideStateModelTest)
@@ -0,0 +1,72 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * SlideStateModelTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_SLIDESTATEMODELTEST_H_
+#define SRC_TEST_CONNECTOR_SLIDESTATEMODELTEST_H_
+
+#include <QTest>
+
+#include "../../main/connector/SlideStateModel.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies that the slide state model follows the sent keys and encodes
+ * its events as expected.
+ */
+class SlideStateModelTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies the slide position for a sequence of keys.
+         */
+        void verifySlidePosition();
+
+        /**
+         * Verifies that keys that don't change the state don't emit events.
+         */
+        void verifyNoEventWithoutChange();
+
+        /**
+         * Verifies the encoded event message.
+         */
+        void verifyEventEncoding();
+
+        /**
+         * Verifies that the current state can be published on request.
+         */
+        void verifyPublish();
+};
+
+#endif /* SRC_TEST_CONNECTOR_SLIDESTATEMODELTEST_H_ */
@@ -0,0 +1,416 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * WebSocketConnectorTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "WebSocketConnectorTest.h"
+
+#include <QSignalSpy>
+#include <QElapsedTimer>
+
+// The websocket opcodes
+static const int opcodeContinuation = 0x0;
+static const int opcodeText = 0x1;
+static const int opcodeClose = 0x8;
+static const int opcodePing = 0x9;
+static const int opcodePong = 0xa;
+
+// The host the requests are sent to, our own page is served from there
+static const char* const host = "presenter.local:43157";
+
+// The example key of RFC 6455 and its accept value
+static const char* const key = "dGhlIHNhbXBsZSBub25jZQ==";
+static const char* const accept = "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=";
+
+// The size of the receive buffer of the connector
+static const int bufferSize = 4096;
+
+void WebSocketConnectorTest::init()
+{
+    keySender = new MockKeySender();
+    connector = new WebSocketConnector(keySender);
+    connector->setPort(0);
+    connector->startServer();
+}
+
+void WebSocketConnectorTest::cleanup()
+{
+    qDeleteAll(clients);
+    clients.clear();
+    delete connector;
+}
+
+QByteArray WebSocketConnectorTest::request(const QByteArray& headers)
+{
+    QTcpSocket* client = new QTcpSocket();
+    clients.append(client);
+    client->connectToHost(QHostAddress::LocalHost, connector->port());
+    if (!client->waitForConnected(1000))
+    {
+        return QByteArray();
+    }
+
+    client->write(QByteArray("GET / HTTP/1.1\r\nHost: ") + host + "\r\n"
+                  + headers + "\r\n");
+
+    // Only the header is read, frames might follow
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 5000)
+    {
+        QByteArray received = client->peek(client->bytesAvailable());
+        int end = received.indexOf("\r\n\r\n");
+        if (end >= 0)
+        {
+            return client->read(end + 4).left(end);
+        }
+        QTest::qWait(1);
+    }
+
+    return QByteArray();
+}
+
+QTcpSocket* WebSocketConnectorTest::openWebSocket()
+{
+    QByteArray response = request(QByteArray("Upgrade: websocket\r\n"
+                                             "Connection: Upgrade\r\n"
+                                             "Sec-WebSocket-Version: 13\r\n"
+                                             "Sec-WebSocket-Key: ")
+                                  + key + "\r\n");
+    bool upgraded =
+            response.startsWith("HTTP/1.1 101 Switching Protocols\r\n")
+            && response.contains(QByteArray("Sec-WebSocket-Accept: ")
+                                 + accept);
+
+    return upgraded ? clients.last() : NULL;
+}
+
+bool WebSocketConnectorTest::readFrame(QTcpSocket* client, int opcode,
+                                       QByteArray& payload)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 5000)
+    {
+        // Server frames are not masked and our replies are small
+        QByteArray header = client->peek(4);
+        int length = header.size() >= 2 ? header[1] & 0x7f : -1;
+        int headerLength = 2;
+        if (length == 126)
+        {
+            length = header.size() == 4 ? (uchar(header[2]) << 8)
+                                          | uchar(header[3])
+                                        : -1;
+            headerLength = 4;
+        }
+
+        if (length >= 0 && client->bytesAvailable() >= headerLength + length)
+        {
+            int received = header[0] & 0x0f;
+            client->read(headerLength);
+            payload = client->read(length);
+            if (received == opcode)
+            {
+                return true;
+            }
+            continue;
+        }
+        QTest::qWait(1);
+    }
+
+    return false;
+}
+
+quint16 WebSocketConnectorTest::closeCode(QTcpSocket* client)
+{
+    QByteArray payload;
+    if (!readFrame(client, opcodeClose, payload) || payload.size() != 2)
+    {
+        return 0;
+    }
+
+    return quint16((uchar(payload[0]) << 8) | uchar(payload[1]));
+}
+
+bool WebSocketConnectorTest::waitForNext(int count)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (keySender->nextCount < count)
+    {
+        if (timer.elapsed() > 5000)
+        {
+            return false;
+        }
+        QTest::qWait(1);
+    }
+
+    return keySender->nextCount == count;
+}
+
+QByteArray WebSocketConnectorTest::frame(int opcode,
+                                         const QByteArray& payload,
+                                         bool isFinal, bool masked)
+{
+    QByteArray frame;
+    frame.append(char((isFinal ? 0x80 : 0) | opcode));
+
+    char maskBit = masked ? char(0x80) : char(0);
+    if (payload.size() < 126)
+    {
+        frame.append(char(maskBit | payload.size()));
+    }
+    else
+    {
+        frame.append(char(maskBit | 126));
+        frame.append(char(payload.size() >> 8));
+        frame.append(char(payload.size() & 0xff));
+    }
+
+    if (!masked)
+    {
+        return frame + payload;
+    }
+
+    const char mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+    frame.append(mask, sizeof(mask));
+    for (int i = 0; i < payload.size(); i++)
+    {
+        frame.append(char(payload[i] ^ mask[i & 3]));
+    }
+
+    return frame;
+}
+
+void WebSocketConnectorTest::testHandshake_data()
+{
+    QTest::addColumn<QByteArray>("connection");
+    QTest::addColumn<QByteArray>("version");
+    QTest::addColumn<QByteArray>("origin");
+    QTest::addColumn<QByteArray>("status");
+
+    QByteArray upgraded("HTTP/1.1 101 Switching Protocols");
+    QByteArray ownPage = QByteArray("http://") + host;
+
+    QTest::newRow("no origin")
+            << QByteArray("Upgrade") << QByteArray("13") << QByteArray()
+            << upgraded;
+    QTest::newRow("own page")
+            << QByteArray("Upgrade") << QByteArray("13") << ownPage
+            << upgraded;
+    QTest::newRow("own page in upper case")
+            << QByteArray("Upgrade") << QByteArray("13") << ownPage.toUpper()
+            << upgraded;
+    QTest::newRow("connection list")
+            << QByteArray("keep-alive, Upgrade") << QByteArray("13")
+            << ownPage << upgraded;
+    QTest::newRow("foreign page")
+            << QByteArray("Upgrade") << QByteArray("13")
+            << QByteArray("http://example.com")
+            << QByteArray("HTTP/1.1 403 Forbidden");
+    QTest::newRow("other port")
+            << QByteArray("Upgrade") << QByteArray("13")
+            << QByteArray("http://presenter.local:8080")
+            << QByteArray("HTTP/1.1 403 Forbidden");
+    QTest::newRow("old version")
+            << QByteArray("Upgrade") << QByteArray("8") << QByteArray()
+            << QByteArray("HTTP/1.1 426 Upgrade Required");
+    QTest::newRow("no version")
+            << QByteArray("Upgrade") << QByteArray() << QByteArray()
+            << QByteArray("HTTP/1.1 426 Upgrade Required");
+    QTest::newRow("no connection upgrade")
+            << QByteArray("keep-alive") << QByteArray("13") << QByteArray()
+            << QByteArray("HTTP/1.1 200 OK");
+}
+
+void WebSocketConnectorTest::testHandshake()
+{
+    QFETCH(QByteArray, connection);
+    QFETCH(QByteArray, version);
+    QFETCH(QByteArray, origin);
+    QFETCH(QByteArray, status);
+
+    QByteArray headers = QByteArray("Upgrade: websocket\r\n"
+                                    "Sec-WebSocket-Key: ") + key + "\r\n"
+                         "Connection: " + connection + "\r\n";
+    if (!version.isEmpty())
+    {
+        headers += "Sec-WebSocket-Version: " + version + "\r\n";
+    }
+    if (!origin.isEmpty())
+    {
+        headers += "Origin: " + origin + "\r\n";
+    }
+
+    QSignalSpy connected(connector, SIGNAL(clientConnected(QString)));
+    QByteArray response = request(headers);
+    QCOMPARE(response.left(response.indexOf("\r\n")), status);
+    QCOMPARE(connected.count(), status.startsWith("HTTP/1.1 101") ? 1 : 0);
+}
+
+void WebSocketConnectorTest::testVersionMessage()
+{
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+    QByteArray payload;
+    QVERIFY(readFrame(client, opcodeText, payload));
+    QVERIFY(payload.contains("\"minVersion\""));
+
+    QTcpSocket* other = openWebSocket();
+    QVERIFY(other);
+    QVERIFY(readFrame(other, opcodeText, payload));
+    QVERIFY(payload.contains("\"minVersion\""));
+
+    // The next frame of the first client is the answer to its ping
+    client->write(frame(opcodePing, "ping"));
+    QTRY_VERIFY_WITH_TIMEOUT(client->bytesAvailable() > 0, 5000);
+    QCOMPARE(client->peek(1).at(0) & 0x0f, opcodePong);
+}
+
+void WebSocketConnectorTest::testHandshakeTimeout()
+{
+    QTcpSocket* client = new QTcpSocket();
+    clients.append(client);
+    client->connectToHost(QHostAddress::LocalHost, connector->port());
+    QVERIFY(client->waitForConnected(1000));
+
+    // The connector checks once per second after a timeout of 5 seconds
+    QElapsedTimer timer;
+    timer.start();
+    while (client->state() != QAbstractSocket::UnconnectedState
+           && timer.elapsed() < 10000)
+    {
+        QTest::qWait(10);
+    }
+    QCOMPARE(client->state(), QAbstractSocket::UnconnectedState);
+    QVERIFY(timer.elapsed() >= 4000);
+}
+
+void WebSocketConnectorTest::testTextFrame()
+{
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+
+    client->write(frame(opcodeText,
+                        "{ \"type\": \"command\", \"data\": \"nextSlide\" }"));
+    QVERIFY(waitForNext(1));
+}
+
+void WebSocketConnectorTest::testUnmaskedFrame()
+{
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+
+    client->write(frame(opcodeText,
+                        "{ \"type\": \"command\", \"data\": \"nextSlide\" }",
+                        true, false));
+    QCOMPARE(closeCode(client), quint16(1002));
+    QCOMPARE(keySender->nextCount, 0);
+}
+
+void WebSocketConnectorTest::testFragmentation()
+{
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+
+    // A ping between the fragments is allowed
+    client->write(frame(opcodeText, "{ \"type\": \"command\", ", false));
+    client->write(frame(opcodePing, "ping"));
+    client->write(frame(opcodeContinuation, "\"data\": ", false));
+    client->write(frame(opcodeContinuation, "\"nextSlide\" }"));
+    QVERIFY(waitForNext(1));
+
+    // A new message can't start before the fragmented one is complete
+    client->write(frame(opcodeText, "{ \"type\": ", false));
+    client->write(frame(opcodeText, "\"command\" }"));
+    QCOMPARE(closeCode(client), quint16(1002));
+
+    // Continuation frames need a first frame
+    QTcpSocket* other = openWebSocket();
+    QVERIFY(other);
+    other->write(frame(opcodeContinuation,
+                       "{ \"type\": \"command\", \"data\": \"nextSlide\" }"));
+    QCOMPARE(closeCode(other), quint16(1002));
+    QCOMPARE(keySender->nextCount, 1);
+}
+
+void WebSocketConnectorTest::testPing()
+{
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+
+    QByteArray payload;
+    client->write(frame(opcodePing, "payload"));
+    QVERIFY(readFrame(client, opcodePong, payload));
+    QCOMPARE(payload, QByteArray("payload"));
+
+    // Control frames may not be fragmented
+    client->write(frame(opcodePing, "payload", false));
+    QCOMPARE(closeCode(client), quint16(1002));
+
+    // Control frames are limited to 125 bytes
+    QTcpSocket* other = openWebSocket();
+    QVERIFY(other);
+    other->write(frame(opcodePing, QByteArray(126, 'x')));
+    QCOMPARE(closeCode(other), quint16(1002));
+}
+
+void WebSocketConnectorTest::testClose()
+{
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+
+    QSignalSpy disconnected(connector, SIGNAL(clientDisconnected()));
+    client->write(frame(opcodeClose, QByteArray("\x03\xe8", 2)));
+    QCOMPARE(closeCode(client), quint16(1000));
+
+    QElapsedTimer timer;
+    timer.start();
+    while ((client->state() != QAbstractSocket::UnconnectedState
+            || disconnected.count() == 0) && timer.elapsed() < 5000)
+    {
+        QTest::qWait(1);
+    }
+    QCOMPARE(client->state(), QAbstractSocket::UnconnectedState);
+    QCOMPARE(disconnected.count(), 1);
+}
+
+void WebSocketConnectorTest::testOversizeFrames()
+{
+    // The header announces a frame of 1 MiB
+    QTcpSocket* client = openWebSocket();
+    QVERIFY(client);
+    client->write(QByteArray("\x81\xff\x00\x00\x00\x00\x00\x10\x00\x00"
+                             "\x12\x34\x56\x78", 14));
+    QCOMPARE(closeCode(client), quint16(1009));
+
+    // Each fragment fits, but the message does not
+    QTcpSocket* other = openWebSocket();
+    QVERIFY(other);
+    other->write(frame(opcodeText, QByteArray(bufferSize / 2, ' '), false));
+    other->write(frame(opcodeContinuation, QByteArray(bufferSize / 2, ' '),
+                       false));
+    other->write(frame(opcodeContinuation, QByteArray(bufferSize / 2, ' ')));
+    QCOMPARE(closeCode(other), quint16(1009));
+}
+
+QTEST_MAIN(WebSocketConnectorTest)
@@ -0,0 +1,195 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * WebSocketConnectorTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_CONNECTOR_WEBSOCKETCONNECTORTEST_H_
+#define SRC_TEST_CONNECTOR_WEBSOCKETCONNECTORTEST_H_
+
+#include <QTest>
+
+#include <QList>
+#include <QTcpSocket>
+
+#include "../../main/connector/websocket/WebSocketConnector.h"
+#include "MockKeySender.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Tests the handshake and the frame parser of the websocket connector with
+ * loopback clients that write raw http requests and frames.
+ */
+class WebSocketConnectorTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The connector under test.
+         */
+        WebSocketConnector* connector;
+
+        /**
+         * The key sender of the connector, owned by the connector.
+         */
+        MockKeySender* keySender;
+
+        /**
+         * The clients of the current test.
+         */
+        QList<QTcpSocket*> clients;
+
+        /**
+         * Connects a new client and sends a request for the remote page.
+         *
+         * @param headers The header lines besides the host, each ending with
+         *                "\r\n".
+         * @return The header of the response without the empty line or an
+         *         empty array on timeout. The client is the last one in the
+         *         client list.
+         */
+        QByteArray request(const QByteArray& headers);
+
+        /**
+         * Connects a new client and upgrades it to a websocket.
+         *
+         * @return The client or NULL if the handshake failed.
+         */
+        QTcpSocket* openWebSocket();
+
+        /**
+         * Waits for a frame with the given opcode. Other frames, like the
+         * version message that is sent on connect, are skipped.
+         *
+         * @param client The client to read from.
+         * @param opcode The opcode to wait for.
+         * @param payload Set to the payload of the frame.
+         * @return True if a frame was received before the timeout.
+         */
+        static bool readFrame(QTcpSocket* client, int opcode,
+                              QByteArray& payload);
+
+        /**
+         * Waits for a close frame and returns its close code.
+         *
+         * @param client The client to read from.
+         * @return The close code or 0 on timeout.
+         */
+        static quint16 closeCode(QTcpSocket* client);
+
+        /**
+         * Waits until the connector sent the given number of "next" keys.
+         *
+         * @param count The number of keys.
+         * @return True if the keys were sent before the timeout.
+         */
+        bool waitForNext(int count);
+
+        /**
+         * Creates a client frame.
+         *
+         * @param opcode The opcode of the frame.
+         * @param payload The payload of the frame.
+         * @param isFinal If this is the last frame of a message.
+         * @param masked If the payload should be masked, as required for
+         *               clients.
+         * @return The frame.
+         */
+        static QByteArray frame(int opcode, const QByteArray& payload,
+                                bool isFinal = true, bool masked = true);
+
+    private slots:
+        /**
+         * Creates and starts the connector on a free port.
+         */
+        void init();
+
+        /**
+         * Deletes the clients and the connector.
+         */
+        void cleanup();
+
+        /**
+         * Provides the handshake headers and the expected responses.
+         */
+        void testHandshake_data();
+
+        /**
+         * Tests that only valid websocket requests of our own page or of
+         * clients without an origin are upgraded.
+         */
+        void testHandshake();
+
+        /**
+         * Tests that the version message is sent to new clients only.
+         */
+        void testVersionMessage();
+
+        /**
+         * Tests that connections which never send a request are closed.
+         */
+        void testHandshakeTimeout();
+
+        /**
+         * Tests that a command in a single text frame is handled.
+         */
+        void testTextFrame();
+
+        /**
+         * Tests that unmasked client frames close the connection.
+         */
+        void testUnmaskedFrame();
+
+        /**
+         * Tests that fragmented messages are reassembled and that
+         * continuation frames without a first frame are rejected.
+         */
+        void testFragmentation();
+
+        /**
+         * Tests that pings are answered with their payload and that too
+         * big pings are rejected.
+         */
+        void testPing();
+
+        /**
+         * Tests that a close frame is answered and the connection closed.
+         */
+        void testClose();
+
+        /**
+         * Tests that frames and messages bigger than the receive buffer
+         * close the connection.
+         */
+        void testOversizeFrames();
+};
+
+#endif /* SRC_TEST_CONNECTOR_WEBSOCKETCONNECTORTEST_H_ */
@@ -0,0 +1,100 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * EventLoopMonitorTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "EventLoopMonitorTest.h"
+
+#include <QThread>
+#include <QSignalSpy>
+
+#include "../../main/diagnostics/Metrics.h"
+
+void EventLoopMonitorTest::verifyProbes()
+{
+    const char* handler;
+    StallProbe::takeLongest(&handler);
+
+    {
+        StallProbe probe("shortHandler");
+    }
+    {
+        StallProbe probe("longHandler");
+        QThread::msleep(20);
+    }
+    {
+        StallProbe probe("otherHandler");
+    }
+
+    qint64 duration = StallProbe::takeLongest(&handler);
+    QCOMPARE(QByteArray(handler), QByteArray("longHandler"));
+    QVERIFY(duration >= 20000);
+
+    // Taking the handler forgets it
+    QCOMPARE(StallProbe::takeLongest(&handler), qint64(0));
+    QVERIFY(handler == NULL);
+}
+
+void EventLoopMonitorTest::verifyResponsiveLoop()
+{
+    EventLoopMonitor monitor("test", 20, 200);
+    QSignalSpy spy(&monitor, SIGNAL(stalled(QString)));
+    monitor.start();
+
+    QTest::qWait(200);
+    monitor.stop();
+
+    QCOMPARE(spy.count(), 0);
+    QVERIFY(monitor.maximumLag() < 200000);
+}
+
+void EventLoopMonitorTest::verifyStall()
+{
+    Metrics metrics;
+    Metrics::setInstance(&metrics);
+
+    EventLoopMonitor monitor("test", 20, 50);
+    QSignalSpy spy(&monitor, SIGNAL(stalled(QString)));
+    monitor.start();
+    QTest::qWait(60);
+
+    // Block the event loop in a probed handler
+    {
+        StallProbe probe("blockingHandler");
+        QThread::msleep(150);
+    }
+
+    QTRY_VERIFY(spy.count() > 0);
+    monitor.stop();
+    Metrics::setInstance(NULL);
+
+    QString message = spy.first().first().toString();
+    QVERIFY2(message.contains("Event loop test stalled"), qPrintable(message));
+    QVERIFY2(message.contains("blockingHandler"), qPrintable(message));
+    QVERIFY(monitor.maximumLag() >= 100000);
+
+    QByteArray rendered = metrics.render();
+    QVERIFY(rendered.contains("presenter_event_loop_stalls_total{"
+            "loop=\"test\",handler=\"blockingHandler\"} 1\n"));
+}
+
+QTEST_MAIN(EventLoopMonitorTest)
@@ -0,0 +1,68 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * EventLoopMonitorTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_DIAGNOSTICS_EVENTLOOPMONITORTEST_H_
+#define SRC_TEST_DIAGNOSTICS_EVENTLOOPMONITORTEST_H_
+
+#include <QTest>
+
+#include "../../main/diagnostics/EventLoopMonitor.h"
+#include "../../main/diagnostics/StallProbe.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies the stall detection of the event loop monitor.
+ */
+class EventLoopMonitorTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies that the probes keep the longest handler.
+         */
+        void verifyProbes();
+
+        /**
+         * Verifies that no stall is reported for a responsive event loop.
+         */
+        void verifyResponsiveLoop();
+
+        /**
+         * Verifies that a blocking handler is reported as cause of a stall
+         * and counted in the metrics.
+         */
+        void verifyStall();
+};
+
+#endif /* SRC_TEST_DIAGNOSTICS_EVENTLOOPMONITORTEST_H_ */
@@ -0,0 +1,153 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * FileLogSinkTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "FileLogSinkTest.h"
+
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+void FileLogSinkTest::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+}
+
+void FileLogSinkTest::cleanup()
+{
+    delete directory;
+}
+
+QList<QByteArray> FileLogSinkTest::readLines(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QList<QByteArray>();
+    }
+
+    return file.readAll().split('\n');
+}
+
+void FileLogSinkTest::verifyJsonLines()
+{
+    QString fileName = directory->path() + "/test.log";
+    FileLogSink sink(fileName);
+    QVERIFY(sink.open());
+
+    sink.write(QtInfoMsg, "test", "first message");
+    sink.write(QtWarningMsg, NULL, "second \"message\"");
+    sink.close();
+
+    QList<QByteArray> lines = readLines(fileName);
+    QCOMPARE(lines.size(), 3); // Last line is empty
+    QVERIFY(lines.last().isEmpty());
+
+    QJsonObject first = QJsonDocument::fromJson(lines.at(0)).object();
+    QCOMPARE(first["level"].toString(), QString("info"));
+    QCOMPARE(first["category"].toString(), QString("test"));
+    QCOMPARE(first["message"].toString(), QString("first message"));
+    QVERIFY(first["time"].toString().endsWith("Z"));
+
+    QJsonObject second = QJsonDocument::fromJson(lines.at(1)).object();
+    QCOMPARE(second["level"].toString(), QString("warning"));
+    QCOMPARE(second["category"].toString(), QString("default"));
+    QCOMPARE(second["message"].toString(), QString("second \"message\""));
+}
+
+void FileLogSinkTest::verifyRotation()
+{
+    QString fileName = directory->path() + "/test.log";
+    FileLogSink sink(fileName, 1024, 2);
+    QVERIFY(sink.open());
+
+    for (int i = 0; i < 100; i++)
+    {
+        sink.write(QtInfoMsg, "test", QString("message %1").arg(i));
+    }
+    sink.close();
+
+    QVERIFY(QFile::exists(fileName));
+    QVERIFY(QFile::exists(fileName + ".1"));
+    QVERIFY(QFile::exists(fileName + ".2"));
+    QVERIFY(!QFile::exists(fileName + ".3"));
+    QVERIFY(QFile(fileName + ".1").size() >= 1024);
+
+    // The latest message is in the current file
+    QList<QByteArray> lines = readLines(fileName);
+    QVERIFY(lines.size() >= 2);
+    QCOMPARE(QJsonDocument::fromJson(lines.at(lines.size() - 2)).object()
+                 ["message"].toString(),
+             QString("message 99"));
+}
+
+void FileLogSinkTest::verifyMessageHandler()
+{
+    QString fileName = directory->path() + "/test.log";
+    FileLogSink sink(fileName);
+    QVERIFY(sink.open());
+
+    FileLogSink::install(&sink);
+    qInfo("installed");
+    FileLogSink::install(NULL);
+    qInfo("not installed");
+    sink.close();
+
+    QList<QByteArray> lines = readLines(fileName);
+    QCOMPARE(lines.size(), 2);
+    QCOMPARE(QJsonDocument::fromJson(lines.at(0)).object()
+                 ["message"].toString(),
+             QString("installed"));
+}
+
+void FileLogSinkTest::verifyLinksRejected()
+{
+    #ifdef _WIN32
+        QSKIP("Links are only rejected on unix systems");
+    #else
+        QString target = directory->path() + "/target";
+        QFile file(target);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+
+        QString symLink = directory->path() + "/symlink.log";
+        QVERIFY(QFile::link(target, symLink));
+        FileLogSink symLinkSink(symLink);
+        QVERIFY(!symLinkSink.open());
+
+        QString hardLink = directory->path() + "/hardlink.log";
+        QCOMPARE(link(QFile::encodeName(target).constData(),
+                      QFile::encodeName(hardLink).constData()), 0);
+        FileLogSink hardLinkSink(hardLink);
+        QVERIFY(!hardLinkSink.open());
+
+        QCOMPARE(QFile(target).size(), qint64(0));
+    #endif
+}
+
+QTEST_MAIN(FileLogSinkTest)
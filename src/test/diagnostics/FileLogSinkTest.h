@@ -0,0 +1,96 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * FileLogSinkTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_DIAGNOSTICS_FILELOGSINKTEST_H_
+#define SRC_TEST_DIAGNOSTICS_FILELOGSINKTEST_H_
+
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "../../main/diagnostics/FileLogSink.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies that the file log sink writes and rotates its log files.
+ */
+class FileLogSinkTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The directory for the log files.
+         */
+        QTemporaryDir* directory;
+
+        /**
+         * Reads the lines of a file.
+         *
+         * @param fileName The name of the file.
+         * @return The lines of the file.
+         */
+        QList<QByteArray> readLines(const QString& fileName);
+
+    private slots:
+        /**
+         * Creates the directory for the log files.
+         */
+        void init();
+
+        /**
+         * Removes the directory for the log files.
+         */
+        void cleanup();
+
+        /**
+         * Verifies that messages are written as JSON lines.
+         */
+        void verifyJsonLines();
+
+        /**
+         * Verifies that the file is rotated once it is full.
+         */
+        void verifyRotation();
+
+        /**
+         * Verifies that Qt messages are written once the sink is installed.
+         */
+        void verifyMessageHandler();
+
+        /**
+         * Verifies that a log file which is a link is not opened.
+         */
+        void verifyLinksRejected();
+};
+
+#endif /* SRC_TEST_DIAGNOSTICS_FILELOGSINKTEST_H_ */
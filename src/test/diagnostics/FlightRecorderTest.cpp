@@ -0,0 +1,204 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * FlightRecorderTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "FlightRecorderTest.h"
+
+#include <QFile>
+#include <QList>
+#include <QDateTime>
+
+#include <string.h>
+
+RecordingThread::RecordingThread(FlightRecorder* recorder, quint32 clientId,
+                                 int count) :
+    recorder(recorder), clientId(clientId), count(count)
+{}
+
+void RecordingThread::run()
+{
+    QString client = QString("thread %1").arg(clientId);
+    for (int i = 0; i < count; i++)
+    {
+        recorder->record(FlightRecorder::Network, clientId, client,
+                         FlightRecorder::NextSlide, FlightRecorder::Sent);
+    }
+}
+
+void FlightRecorderTest::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+}
+
+void FlightRecorderTest::cleanup()
+{
+    delete directory;
+}
+
+QVector<FlightRecord> FlightRecorderTest::readRecords(
+        const QString& fileName, FlightRecorderHeader* header)
+{
+    QVector<FlightRecord> records;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return records;
+    }
+
+    QByteArray data = file.readAll();
+    memcpy(header, data.constData(), sizeof(FlightRecorderHeader));
+    for (quint32 i = 0; i < header->capacity; i++)
+    {
+        FlightRecord record;
+        memcpy(&record, data.constData() + sizeof(FlightRecorderHeader)
+                   + i * sizeof(FlightRecord), sizeof(record));
+        if (record.sequence != 0)
+        {
+            records.append(record);
+        }
+    }
+
+    return records;
+}
+
+void FlightRecorderTest::verifyRecord()
+{
+    QString fileName = directory->path() + "/flight.bin";
+    {
+        FlightRecorder recorder(fileName, 16);
+        QVERIFY(recorder.open());
+        recorder.record(FlightRecorder::Network, 7,
+                        QString::fromUtf8("client \xc3\xa4 with a very long "
+                                          "name"),
+                        FlightRecorder::NextSlide, FlightRecorder::Sent);
+    }
+
+    FlightRecorderHeader header;
+    QVector<FlightRecord> records = readRecords(fileName, &header);
+    QCOMPARE(memcmp(header.magic, FlightRecorder::magic, 8), 0);
+    QCOMPARE(header.capacity, quint32(16));
+    QCOMPARE(header.nextSequence, quint64(2));
+    QCOMPARE(records.size(), 1);
+
+    const FlightRecord& record = records.first();
+    QCOMPARE(record.sequence, quint64(1));
+    QCOMPARE(record.clientId, quint32(7));
+    QCOMPARE(int(record.source), int(FlightRecorder::Network));
+    QCOMPARE(int(record.command), int(FlightRecorder::NextSlide));
+    QCOMPARE(int(record.outcome), int(FlightRecorder::Sent));
+    QCOMPARE(QByteArray(record.client), QByteArray("client ? with a very lo"));
+    QVERIFY(qAbs(record.timestamp / 1000
+                 - QDateTime::currentMSecsSinceEpoch()) < 10000);
+}
+
+void FlightRecorderTest::verifyWrapAround()
+{
+    QString fileName = directory->path() + "/flight.bin";
+    {
+        FlightRecorder recorder(fileName, 4);
+        QVERIFY(recorder.open());
+        for (int i = 0; i < 10; i++)
+        {
+            recorder.record(FlightRecorder::Bluetooth, 1, "client",
+                            FlightRecorder::PrevSlide, FlightRecorder::Sent);
+        }
+    }
+
+    FlightRecorderHeader header;
+    QVector<FlightRecord> records = readRecords(fileName, &header);
+    QCOMPARE(records.size(), 4);
+
+    quint64 oldest = records.first().sequence;
+    for (const FlightRecord& record: records)
+    {
+        oldest = qMin(oldest, record.sequence);
+    }
+    QCOMPARE(oldest, quint64(7));
+}
+
+void FlightRecorderTest::verifyContinue()
+{
+    QString fileName = directory->path() + "/flight.bin";
+    for (int run = 0; run < 2; run++)
+    {
+        FlightRecorder recorder(fileName, 8);
+        QVERIFY(recorder.open());
+        recorder.record(FlightRecorder::WebSocket, 1, "client",
+                        FlightRecorder::StartPresentation,
+                        FlightRecorder::Sent);
+    }
+
+    FlightRecorderHeader header;
+    QCOMPARE(readRecords(fileName, &header).size(), 2);
+    QCOMPARE(header.nextSequence, quint64(3));
+
+    // A ring with another capacity is started from scratch
+    {
+        FlightRecorder recorder(fileName, 4);
+        QVERIFY(recorder.open());
+    }
+    QCOMPARE(readRecords(fileName, &header).size(), 0);
+}
+
+void FlightRecorderTest::verifyConcurrentRecord()
+{
+    const int threadCount = 4;
+    const int count = 1000;
+
+    QString fileName = directory->path() + "/flight.bin";
+    {
+        FlightRecorder recorder(fileName, threadCount * count);
+        QVERIFY(recorder.open());
+
+        QList<RecordingThread*> threads;
+        for (int i = 0; i < threadCount; i++)
+        {
+            threads.append(new RecordingThread(&recorder, quint32(i + 1),
+                                               count));
+            threads.last()->start();
+        }
+
+        for (RecordingThread* thread: threads)
+        {
+            thread->wait();
+        }
+        qDeleteAll(threads);
+    }
+
+    FlightRecorderHeader header;
+    QVector<FlightRecord> records = readRecords(fileName, &header);
+    QCOMPARE(records.size(), threadCount * count);
+    QCOMPARE(header.nextSequence, quint64(threadCount * count + 1));
+
+    // Each record is in the slot of its sequence number
+    for (int i = 0; i < records.size(); i++)
+    {
+        const FlightRecord& record = records.at(i);
+        QCOMPARE(record.sequence, quint64(i + 1));
+        QCOMPARE(QByteArray(record.client),
+                 QString("thread %1").arg(record.clientId).toLatin1());
+    }
+}
+
+QTEST_MAIN(FlightRecorderTest)
@@ -0,0 +1,141 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * FlightRecorderTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_DIAGNOSTICS_FLIGHTRECORDERTEST_H_
+#define SRC_TEST_DIAGNOSTICS_FLIGHTRECORDERTEST_H_
+
+#include <QTest>
+#include <QThread>
+#include <QVector>
+#include <QTemporaryDir>
+
+#include "../../main/diagnostics/FlightRecorder.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * A thread that records events for the concurrency test.
+ */
+class RecordingThread: public QThread
+{
+    public:
+        /**
+         * Creates a new thread. Call start to record the events.
+         *
+         * @param recorder The recorder to record the events into.
+         * @param clientId The client id of the recorded events.
+         * @param count The number of events to record.
+         */
+        RecordingThread(FlightRecorder* recorder, quint32 clientId,
+                        int count);
+
+    protected:
+        /**
+         * Records the events.
+         */
+        void run();
+
+    private:
+        /**
+         * The recorder to record the events into.
+         */
+        FlightRecorder* recorder;
+
+        /**
+         * The client id of the recorded events.
+         */
+        quint32 clientId;
+
+        /**
+         * The number of events to record.
+         */
+        int count;
+};
+
+/**
+ * Verifies that the flight recorder writes its records into the ring file.
+ */
+class FlightRecorderTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The directory for the ring file.
+         */
+        QTemporaryDir* directory;
+
+        /**
+         * Reads the used records of a ring file.
+         *
+         * @param fileName The name of the file.
+         * @param header Set to the header of the file.
+         * @return The used records, in file order.
+         */
+        QVector<FlightRecord> readRecords(const QString& fileName,
+                                          FlightRecorderHeader* header);
+
+    private slots:
+        /**
+         * Creates the directory for the ring file.
+         */
+        void init();
+
+        /**
+         * Removes the directory for the ring file.
+         */
+        void cleanup();
+
+        /**
+         * Verifies the content of a record.
+         */
+        void verifyRecord();
+
+        /**
+         * Verifies that the oldest records are overwritten once the ring is
+         * full.
+         */
+        void verifyWrapAround();
+
+        /**
+         * Verifies that an existing ring is continued after a restart.
+         */
+        void verifyContinue();
+
+        /**
+         * Verifies that events recorded by several threads at once get
+         * distinct sequence numbers and complete records.
+         */
+        void verifyConcurrentRecord();
+};
+
+#endif /* SRC_TEST_DIAGNOSTICS_FLIGHTRECORDERTEST_H_ */
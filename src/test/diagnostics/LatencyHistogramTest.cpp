@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * LatencyHistogramTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "LatencyHistogramTest.h"
+
+void LatencyHistogramTest::verifyEmpty()
+{
+    LatencyHistogram histogram;
+
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.sum(), quint64(0));
+    QCOMPARE(histogram.percentile(0.5), qint64(-1));
+}
+
+void LatencyHistogramTest::verifyBuckets()
+{
+    LatencyHistogram histogram;
+
+    // Bounds are inclusive
+    histogram.record(0);
+    histogram.record(50);
+    histogram.record(51);
+    histogram.record(-5);
+
+    QCOMPARE(histogram.count(), quint64(4));
+    QCOMPARE(histogram.sum(), quint64(101));
+    QCOMPARE(histogram.bucket(0), quint64(3));
+    QCOMPARE(histogram.bucket(1), quint64(1));
+    QCOMPARE(LatencyHistogram::bound(0), qint64(50));
+    QCOMPARE(LatencyHistogram::bound(LatencyHistogram::bucketCount - 1),
+             qint64(-1));
+
+    // The bounds must be ascending
+    for (int i = 1; i < LatencyHistogram::bucketCount - 1; i++)
+    {
+        QVERIFY(LatencyHistogram::bound(i) > LatencyHistogram::bound(i - 1));
+    }
+}
+
+void LatencyHistogramTest::verifyPercentiles()
+{
+    LatencyHistogram histogram;
+
+    for (int i = 0; i < 90; i++)
+    {
+        histogram.record(200);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        histogram.record(4000);
+    }
+
+    QCOMPARE(histogram.percentile(0.5), qint64(250));
+    QCOMPARE(histogram.percentile(0.9), qint64(250));
+    QCOMPARE(histogram.percentile(0.99), qint64(5000));
+    QCOMPARE(histogram.percentile(0), qint64(250));
+}
+
+void LatencyHistogramTest::verifyOverflow()
+{
+    LatencyHistogram histogram;
+
+    histogram.record(10000000);
+    histogram.record(7000000);
+
+    QCOMPARE(histogram.bucket(LatencyHistogram::bucketCount - 1), quint64(2));
+    QCOMPARE(histogram.percentile(0.99), qint64(10000000));
+}
+
+void LatencyHistogramTest::verifyReset()
+{
+    LatencyHistogram histogram;
+
+    histogram.record(300);
+    histogram.reset();
+
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.bucket(3), quint64(0));
+    QCOMPARE(histogram.percentile(0.99), qint64(-1));
+}
+
+QTEST_MAIN(LatencyHistogramTest)
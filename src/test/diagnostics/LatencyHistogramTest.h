@@ -0,0 +1,76 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * LatencyHistogramTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_DIAGNOSTICS_LATENCYHISTOGRAMTEST_H_
+#define SRC_TEST_DIAGNOSTICS_LATENCYHISTOGRAMTEST_H_
+
+#include <QTest>
+
+#include "../../main/diagnostics/LatencyHistogram.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies the buckets and percentiles of the latency histogram.
+ */
+class LatencyHistogramTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies that an empty histogram has no percentiles.
+         */
+        void verifyEmpty();
+
+        /**
+         * Verifies that latencies are counted in the right buckets.
+         */
+        void verifyBuckets();
+
+        /**
+         * Verifies the percentile estimation.
+         */
+        void verifyPercentiles();
+
+        /**
+         * Verifies that the maximum is returned for the overflow bucket.
+         */
+        void verifyOverflow();
+
+        /**
+         * Verifies that reset removes all latencies.
+         */
+        void verifyReset();
+};
+
+#endif /* SRC_TEST_DIAGNOSTICS_LATENCYHISTOGRAMTEST_H_ */
@@ -0,0 +1,217 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * MetricsTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "MetricsTest.h"
+
+#include <QList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+
+FakeDaemon::FakeDaemon() :
+    port(0), acceptedConnections(0)
+{}
+
+FakeDaemon::~FakeDaemon()
+{
+    requestInterruption();
+    wait();
+}
+
+quint16 FakeDaemon::open()
+{
+    start();
+    started.acquire();
+    return port;
+}
+
+int FakeDaemon::connections() const
+{
+    return acceptedConnections.load();
+}
+
+void FakeDaemon::run()
+{
+    QTcpServer server;
+    if (server.listen(QHostAddress::LocalHost))
+    {
+        port = server.serverPort();
+    }
+    started.release();
+
+    QList<QTcpSocket*> sockets;
+    while (port != 0 && !isInterruptionRequested())
+    {
+        if (server.waitForNewConnection(10))
+        {
+            sockets.append(server.nextPendingConnection());
+            acceptedConnections.ref();
+        }
+
+        for (QTcpSocket* socket: sockets)
+        {
+            socket->waitForReadyRead(10);
+            while (socket->canReadLine())
+            {
+                if (socket->readLine() == "stats\n")
+                {
+                    socket->write("fake_daemon_metric 1\n# EOF\n");
+                    socket->waitForBytesWritten(1000);
+                }
+            }
+        }
+    }
+    qDeleteAll(sockets);
+}
+
+void MetricsTest::verifyEmpty()
+{
+    Metrics metrics;
+    QByteArray rendered = metrics.render();
+
+    QVERIFY(rendered.contains(
+            "# TYPE presenter_connected_clients gauge\n"));
+    QVERIFY(rendered.contains(
+            "presenter_connected_clients{connector=\"network\"} 0\n"));
+    QVERIFY(rendered.contains("presenter_injection_errors_total 0\n"));
+    QVERIFY(rendered.contains("presenter_discovery_beacons_total 0\n"));
+    QVERIFY(rendered.contains("presenter_command_latency_seconds_count 0\n"));
+    QVERIFY(rendered.contains(
+            "presenter_client_round_trip_seconds_count 0\n"));
+
+    // Commands are only rendered once received
+    QVERIFY(!rendered.contains("presenter_commands_total{"));
+}
+
+void MetricsTest::verifyCounters()
+{
+    Metrics metrics;
+    metrics.addConnectedClients(FlightRecorder::Network, 2);
+    metrics.addConnectedClients(FlightRecorder::Network, -1);
+    metrics.addConnectedClients(FlightRecorder::WebSocket, 3);
+    metrics.countCommand(FlightRecorder::NextSlide, FlightRecorder::Sent);
+    metrics.countCommand(FlightRecorder::NextSlide, FlightRecorder::Sent);
+    metrics.countCommand(FlightRecorder::PrevSlide,
+                         FlightRecorder::Duplicate);
+    metrics.countInjectionErrors();
+    metrics.countBeacons(4);
+
+    QByteArray rendered = metrics.render();
+    QVERIFY(rendered.contains(
+            "presenter_connected_clients{connector=\"network\"} 1\n"));
+    QVERIFY(rendered.contains(
+            "presenter_connected_clients{connector=\"websocket\"} 3\n"));
+    QVERIFY(rendered.contains("presenter_commands_total{"
+            "command=\"nextSlide\",outcome=\"sent\"} 2\n"));
+    QVERIFY(rendered.contains("presenter_commands_total{"
+            "command=\"prevSlide\",outcome=\"duplicate\"} 1\n"));
+    QVERIFY(rendered.contains("presenter_injection_errors_total 1\n"));
+    QVERIFY(rendered.contains("presenter_discovery_beacons_total 4\n"));
+}
+
+void MetricsTest::verifyHistogram()
+{
+    LatencyHistogram histogram;
+    histogram.record(40);
+    histogram.record(900);
+    histogram.record(5000000);
+
+    QByteArray rendered;
+    Metrics::appendHistogram(rendered, "test_seconds", "Test.", histogram);
+
+    QVERIFY(rendered.startsWith("# HELP test_seconds Test.\n"
+                                "# TYPE test_seconds histogram\n"));
+    QVERIFY(rendered.contains("test_seconds_bucket{le=\"5e-05\"} 1\n"));
+    QVERIFY(rendered.contains("test_seconds_bucket{le=\"0.0005\"} 1\n"));
+    QVERIFY(rendered.contains("test_seconds_bucket{le=\"0.001\"} 2\n"));
+    QVERIFY(rendered.contains("test_seconds_bucket{le=\"2.5\"} 2\n"));
+    QVERIFY(rendered.contains("test_seconds_bucket{le=\"+Inf\"} 3\n"));
+    QVERIFY(rendered.contains("test_seconds_sum 5.00094\n"));
+    QVERIFY(rendered.endsWith("test_seconds_count 3\n"));
+}
+
+void MetricsTest::verifyServer()
+{
+    Metrics metrics;
+    metrics.countBeacons(7);
+
+    MetricsServer server(&metrics, 0);
+    QVERIFY2(server.open(), qPrintable(server.errorString()));
+    QVERIFY(server.serverPort() != 0);
+
+    QByteArray response = get(server.serverPort(), "/metrics");
+    QVERIFY(response.startsWith("HTTP/1.1 200 OK\r\n"));
+    QVERIFY(response.contains("version=0.0.4"));
+    QVERIFY(response.endsWith(metrics.render()));
+    QVERIFY(response.contains("presenter_discovery_beacons_total 7\n"));
+
+    response = get(server.serverPort(), "/other");
+    QVERIFY(response.startsWith("HTTP/1.1 404 Not Found\r\n"));
+
+    server.close();
+    QCOMPARE(server.serverPort(), quint16(0));
+}
+
+void MetricsTest::verifyDaemonStatistics()
+{
+    FakeDaemon daemon;
+    quint16 daemonPort = daemon.open();
+    QVERIFY(daemonPort != 0);
+
+    Metrics metrics;
+    MetricsServer server(&metrics, 0);
+    server.setDaemonPort(daemonPort);
+    QVERIFY2(server.open(), qPrintable(server.errorString()));
+
+    for (int i = 0; i < 3; i++)
+    {
+        QByteArray response = get(server.serverPort(), "/metrics");
+        QVERIFY(response.endsWith("fake_daemon_metric 1\n"));
+    }
+    QCOMPARE(daemon.connections(), 1);
+}
+
+QByteArray MetricsTest::get(quint16 port, const QByteArray& path)
+{
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(1000))
+    {
+        return QByteArray();
+    }
+
+    socket.write("GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+    // The server closes the connection after the response
+    QByteArray response;
+    while (socket.waitForReadyRead(1000))
+    {
+        response.append(socket.readAll());
+    }
+    response.append(socket.readAll());
+
+    return response;
+}
+
+QTEST_MAIN(MetricsTest)
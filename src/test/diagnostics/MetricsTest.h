@@ -0,0 +1,146 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * MetricsTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_DIAGNOSTICS_METRICSTEST_H_
+#define SRC_TEST_DIAGNOSTICS_METRICSTEST_H_
+
+#include <QTest>
+#include <QThread>
+#include <QAtomicInt>
+#include <QSemaphore>
+
+#include "../../main/diagnostics/Metrics.h"
+#include "../../main/diagnostics/MetricsServer.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * A key sender daemon that answers stats commands with a fixed metric. It
+ * runs in its own thread, since the metrics server and the test block
+ * while they wait for their answers.
+ */
+class FakeDaemon: public QThread
+{
+    public:
+        /**
+         * Creates a new daemon. Call {@link #open} to start it.
+         */
+        FakeDaemon();
+
+        /**
+         * Stops the daemon.
+         */
+        ~FakeDaemon();
+
+        /**
+         * Starts the daemon thread and waits until it is listening.
+         *
+         * @return The port the daemon listens on, 0 on error.
+         */
+        quint16 open();
+
+        /**
+         * Returns the number of connections the daemon accepted.
+         *
+         * @return The number of connections.
+         */
+        int connections() const;
+
+    protected:
+        /**
+         * The daemon thread.
+         */
+        void run();
+
+    private:
+        /**
+         * The port the daemon listens on.
+         */
+        quint16 port;
+
+        /**
+         * The number of connections the daemon accepted.
+         */
+        QAtomicInt acceptedConnections;
+
+        /**
+         * Released by the daemon thread once it is listening or failed.
+         */
+        QSemaphore started;
+};
+
+/**
+ * Verifies the rendering of the metrics and the metrics server.
+ */
+class MetricsTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies the metrics without any events.
+         */
+        void verifyEmpty();
+
+        /**
+         * Verifies that the counters are rendered with their labels.
+         */
+        void verifyCounters();
+
+        /**
+         * Verifies that histograms have cumulative buckets in seconds.
+         */
+        void verifyHistogram();
+
+        /**
+         * Verifies that the server answers scrapes and rejects other paths.
+         */
+        void verifyServer();
+
+        /**
+         * Verifies that the daemon statistics are appended and that the
+         * connection to the daemon is reused.
+         */
+        void verifyDaemonStatistics();
+
+    private:
+        /**
+         * Sends a request to a metrics server.
+         *
+         * @param port The port of the server.
+         * @param path The requested path.
+         * @return The response.
+         */
+        static QByteArray get(quint16 port, const QByteArray& path);
+};
+
+#endif /* SRC_TEST_DIAGNOSTICS_METRICSTEST_H_ */
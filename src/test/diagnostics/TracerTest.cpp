@@ -0,0 +1,174 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * TracerTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "TracerTest.h"
+
+#include <QFile>
+#include <QJsonDocument>
+
+void SpanThread::run()
+{
+    Tracer::beginTrace();
+    TraceSpan span("worker span");
+}
+
+void TracerTest::init()
+{
+    directory = new QTemporaryDir();
+    QVERIFY(directory->isValid());
+}
+
+void TracerTest::cleanup()
+{
+    Tracer::setInstance(NULL);
+    Tracer::setCurrentTrace(0);
+    delete directory;
+}
+
+QJsonArray TracerTest::readEvents(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QJsonArray();
+    }
+
+    return QJsonDocument::fromJson(file.readAll()).array();
+}
+
+QJsonObject TracerTest::find(const QJsonArray& events, const QString& name,
+                             const QString& phase)
+{
+    for (const QJsonValue& event: events)
+    {
+        if (event.toObject()["name"].toString() == name
+                && event.toObject()["ph"].toString() == phase)
+        {
+            return event.toObject();
+        }
+    }
+
+    return QJsonObject();
+}
+
+void TracerTest::verifyDisabled()
+{
+    QCOMPARE(Tracer::instance(), static_cast<Tracer*>(NULL));
+    QCOMPARE(Tracer::beginTrace(), quint64(0));
+
+    // Must not crash without a tracer
+    TraceSpan span("disabled");
+}
+
+void TracerTest::verifySpans()
+{
+    QString fileName = directory->path() + "/trace.json";
+    Tracer tracer(fileName);
+    QVERIFY(tracer.open());
+    Tracer::setInstance(&tracer);
+
+    quint64 traceId = Tracer::beginTrace();
+    QVERIFY(traceId != 0);
+    QCOMPARE(Tracer::currentTrace(), traceId);
+    {
+        TraceSpan outer("outer");
+        {
+            TraceSpan inner("inner");
+        }
+        tracer.flowStart(traceId);
+        tracer.flowEnd(traceId);
+    }
+
+    SpanThread thread;
+    thread.setObjectName("worker");
+    thread.start();
+    QVERIFY(thread.wait(1000));
+
+    tracer.close();
+    QCOMPARE(tracer.droppedEvents(), quint64(0));
+
+    QJsonArray events = readEvents(fileName);
+    QVERIFY(!events.isEmpty());
+
+    QJsonObject outer = find(events, "outer", "X");
+    QJsonObject inner = find(events, "inner", "X");
+    QVERIFY(!outer.isEmpty());
+    QVERIFY(!inner.isEmpty());
+    QCOMPARE(quint64(outer["args"].toObject()["trace"].toDouble()), traceId);
+    QCOMPARE(quint64(inner["args"].toObject()["trace"].toDouble()), traceId);
+    QVERIFY(inner["ts"].toDouble() >= outer["ts"].toDouble());
+    QVERIFY(inner["ts"].toDouble() + inner["dur"].toDouble()
+            <= outer["ts"].toDouble() + outer["dur"].toDouble());
+
+    QJsonObject flowStart = find(events, "command", "s");
+    QJsonObject flowEnd = find(events, "command", "f");
+    QCOMPARE(quint64(flowStart["id"].toDouble()), traceId);
+    QCOMPARE(quint64(flowEnd["id"].toDouble()), traceId);
+    QCOMPARE(flowEnd["bp"].toString(), QString("e"));
+
+    // The worker has its own trace and thread
+    QJsonObject worker = find(events, "worker span", "X");
+    QVERIFY(!worker.isEmpty());
+    QVERIFY(quint64(worker["args"].toObject()["trace"].toDouble())
+            != traceId);
+    QVERIFY(worker["tid"].toInt() != outer["tid"].toInt());
+    QCOMPARE(worker["pid"].toInt(), outer["pid"].toInt());
+
+    bool named = false;
+    for (const QJsonValue& event: events)
+    {
+        QJsonObject object = event.toObject();
+        if (object["ph"].toString() == "M"
+                && object["tid"].toInt() == worker["tid"].toInt())
+        {
+            QCOMPARE(object["args"].toObject()["name"].toString(),
+                     QString("worker"));
+            named = true;
+        }
+    }
+    QVERIFY(named);
+}
+
+void TracerTest::verifyDroppedEvents()
+{
+    QString fileName = directory->path() + "/trace.json";
+    Tracer tracer(fileName);
+
+    // Nothing is written before the file is open, so the buffer fills up
+    for (int i = 0; i < 10000; i++)
+    {
+        tracer.span("span", Tracer::now(), 0, 0);
+    }
+    QVERIFY(tracer.droppedEvents() > 0);
+
+    QVERIFY(tracer.open());
+    tracer.close();
+
+    QJsonArray events = readEvents(fileName);
+    QVERIFY(!events.isEmpty());
+    QCOMPARE(quint64(events.size()) + tracer.droppedEvents(),
+             quint64(10000 + 1)); // The thread name is not dropped
+}
+
+QTEST_MAIN(TracerTest)
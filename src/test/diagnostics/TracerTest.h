@@ -0,0 +1,117 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * TracerTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_DIAGNOSTICS_TRACERTEST_H_
+#define SRC_TEST_DIAGNOSTICS_TRACERTEST_H_
+
+#include <QTest>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "../../main/diagnostics/Tracer.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * A thread that records a single span.
+ */
+class SpanThread: public QThread
+{
+    protected:
+        /**
+         * Records the span.
+         */
+        void run();
+};
+
+/**
+ * Verifies that the tracer writes valid Chrome trace events.
+ */
+class TracerTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The directory for the trace files.
+         */
+        QTemporaryDir* directory;
+
+        /**
+         * Reads the events of a trace file.
+         *
+         * @param fileName The name of the file.
+         * @return The events, empty if the file is not valid.
+         */
+        QJsonArray readEvents(const QString& fileName);
+
+        /**
+         * Finds the first event with a given name and phase.
+         *
+         * @param events The events.
+         * @param name The name of the event.
+         * @param phase The phase of the event.
+         * @return The event, empty if not found.
+         */
+        static QJsonObject find(const QJsonArray& events, const QString& name,
+                                const QString& phase);
+
+    private slots:
+        /**
+         * Creates the directory for the trace files.
+         */
+        void init();
+
+        /**
+         * Removes the directory and disables tracing.
+         */
+        void cleanup();
+
+        /**
+         * Verifies that nothing is traced without a tracer.
+         */
+        void verifyDisabled();
+
+        /**
+         * Verifies the spans and flows of several threads.
+         */
+        void verifySpans();
+
+        /**
+         * Verifies that events are dropped if a buffer is full.
+         */
+        void verifyDroppedEvents();
+};
+
+#endif /* SRC_TEST_DIAGNOSTICS_TRACERTEST_H_ */
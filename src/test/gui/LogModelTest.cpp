@@ -0,0 +1,95 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * LogModelTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "LogModelTest.h"
+
+#include <QSignalSpy>
+
+void LogModelTest::verifyBatching()
+{
+    LogModel model;
+    QSignalSpy spy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+    model.append("first");
+    model.append("second");
+    QCOMPARE(model.rowCount(), 0);
+
+    QTRY_COMPARE(model.rowCount(), 2);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(model.data(model.index(1), Qt::DisplayRole).toString()
+                .endsWith("second"));
+}
+
+void LogModelTest::verifyCapacity()
+{
+    LogModel model(3);
+
+    for (int i = 0; i < 5; i++)
+    {
+        model.append(QString::number(i));
+        model.flush();
+    }
+
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(0), Qt::ToolTipRole).toString(),
+             QString("2"));
+    QCOMPARE(model.data(model.index(2), Qt::ToolTipRole).toString(),
+             QString("4"));
+}
+
+void LogModelTest::verifyLargeBatch()
+{
+    LogModel model(3);
+    model.append("old");
+    model.flush();
+
+    for (int i = 0; i < 10; i++)
+    {
+        model.append(QString::number(i));
+    }
+    model.flush();
+
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.data(model.index(0), Qt::ToolTipRole).toString(),
+             QString("7"));
+    QCOMPARE(model.data(model.index(2), Qt::ToolTipRole).toString(),
+             QString("9"));
+}
+
+void LogModelTest::verifySeverity()
+{
+    LogModel model;
+    model.append("info");
+    model.append("error", LogModel::Error);
+    model.flush();
+
+    QCOMPARE(model.data(model.index(0), LogModel::SeverityRole).toInt(),
+             int(LogModel::Info));
+    QCOMPARE(model.data(model.index(1), LogModel::SeverityRole).toInt(),
+             int(LogModel::Error));
+    QVERIFY(!model.data(model.index(0), Qt::ForegroundRole).isValid());
+    QVERIFY(model.data(model.index(1), Qt::ForegroundRole).isValid());
+}
+
+QTEST_MAIN(LogModelTest)
@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * LogModelTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_GUI_LOGMODELTEST_H_
+#define SRC_TEST_GUI_LOGMODELTEST_H_
+
+#include <QTest>
+
+#include "../../main/gui/LogModel.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Verifies the batching and the capacity of the log model.
+ */
+class LogModelTest: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * Verifies that messages are added in batches.
+         */
+        void verifyBatching();
+
+        /**
+         * Verifies that the oldest messages are dropped once the capacity
+         * is reached.
+         */
+        void verifyCapacity();
+
+        /**
+         * Verifies that a batch larger than the capacity keeps the latest
+         * messages.
+         */
+        void verifyLargeBatch();
+
+        /**
+         * Verifies the severity of the messages.
+         */
+        void verifySeverity();
+};
+
+#endif /* SRC_TEST_GUI_LOGMODELTEST_H_ */
@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * KeySenderDaemonBenchmark.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "KeySenderDaemonBenchmark.h"
+
+#include <string.h>
+
+// The size of the command buffer of the daemon. Longer lines are split.
+static const int bufferSize = 64;
+
+Q_DECLARE_METATYPE(KeySenderDaemon::Command)
+
+void KeySenderDaemonBenchmark::benchmarkParseCommand_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<KeySenderDaemon::Command>("command");
+
+    QTest::newRow("sendNext") << QByteArray("sendNext\n")
+                              << KeySenderDaemon::SendNext;
+    QTest::newRow("stopPresentation") << QByteArray("stopPresentation\n")
+                                      << KeySenderDaemon::StopPresentation;
+    QTest::newRow("ping") << QByteArray("ping\n") << KeySenderDaemon::Ping;
+    QTest::newRow("windows line end") << QByteArray("sendPrev\r\n")
+                                      << KeySenderDaemon::SendPrev;
+    QTest::newRow("trailing spaces") << QByteArray("sendNext   \t\n")
+                                     << KeySenderDaemon::SendNext;
+    QTest::newRow("empty line") << QByteArray("\n")
+                                << KeySenderDaemon::Ignored;
+    QTest::newRow("similar prefix") << QByteArray("sendNextSlide\n")
+                                    << KeySenderDaemon::Ignored;
+    QTest::newRow("full garbage line")
+            << QByteArray(bufferSize - 1, 'x') << KeySenderDaemon::Ignored;
+    QTest::newRow("whitespace line")
+            << QByteArray(bufferSize - 1, ' ') << KeySenderDaemon::Ignored;
+    QTest::newRow("trace id") << QByteArray("trace 1234567\n")
+                              << KeySenderDaemon::Trace;
+    QTest::newRow("invalid trace id") << QByteArray("trace 12ab\n")
+                                      << KeySenderDaemon::Ignored;
+    QTest::newRow("command with argument")
+            << QByteArray("sendNext 1234567\n") << KeySenderDaemon::Ignored;
+    QTest::newRow("schedule") << QByteArray("schedule 1 sendNext 0 500\n")
+                              << KeySenderDaemon::Schedule;
+    QTest::newRow("cancelAll") << QByteArray("cancelAll\n")
+                               << KeySenderDaemon::CancelAll;
+    QTest::newRow("move") << QByteArray("move -3 12\n")
+                          << KeySenderDaemon::Move;
+}
+
+void KeySenderDaemonBenchmark::benchmarkParseCommand()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(KeySenderDaemon::Command, command);
+
+    // The line is changed in place, so it is copied for each run like the
+    // daemon reads it from the socket
+    char buffer[bufferSize];
+    quint64 traceId = 0;
+    memcpy(buffer, line.constData(), line.size() + 1);
+    QCOMPARE(KeySenderDaemon::parseCommand(buffer, line.size(), &traceId),
+             command);
+    QCOMPARE(traceId, quint64(line.startsWith("trace 1") ? 1234567 : 0));
+
+    QBENCHMARK
+    {
+        memcpy(buffer, line.constData(), line.size() + 1);
+        KeySenderDaemon::parseCommand(buffer, line.size(), &traceId);
+    }
+}
+
+QTEST_MAIN(KeySenderDaemonBenchmark)
@@ -0,0 +1,62 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * KeySenderDaemonBenchmark.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_KEYSENDERDAEMON_KEYSENDERDAEMONBENCHMARK_H_
+#define SRC_TEST_KEYSENDERDAEMON_KEYSENDERDAEMONBENCHMARK_H_
+
+#include <QTest>
+
+#include "../../keysenderDaemon/KeySenderDaemon.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * Measures how the key sender daemon matches the received lines to its
+ * commands, for known commands as well as garbage.
+ */
+class KeySenderDaemonBenchmark: public QObject
+{
+    Q_OBJECT
+
+    private slots:
+        /**
+         * The lines for {@link #benchmarkParseCommand}.
+         */
+        void benchmarkParseCommand_data();
+
+        /**
+         * Measures parsing a single line.
+         */
+        void benchmarkParseCommand();
+};
+
+#endif /* SRC_TEST_KEYSENDERDAEMON_KEYSENDERDAEMONBENCHMARK_H_ */
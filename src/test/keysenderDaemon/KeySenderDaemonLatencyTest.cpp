@@ -0,0 +1,264 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * KeySenderDaemonLatencyTest.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "KeySenderDaemonLatencyTest.h"
+
+#include <QList>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include <sched.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "../../keysenderDaemon/RealtimeConfig.h"
+
+// The number of measured commands
+static const int samples = 500;
+
+// The maximum accepted 99th percentile latency in nanoseconds
+static const qint64 maxLatency = 2000000;
+
+CpuHog::CpuHog() :
+    keepRunning(1)
+{}
+
+void CpuHog::stop()
+{
+    keepRunning.store(0);
+}
+
+void CpuHog::run()
+{
+    // Threads inherit the real-time priority, but the hogs must not get it
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    sched_setscheduler(0, SCHED_OTHER, &param);
+
+    volatile quint64 counter = 0;
+    while (keepRunning.load())
+    {
+        counter++;
+    }
+}
+
+void KeySenderDaemonLatencyTest::init()
+{
+    daemon = new KeySenderDaemon(0, true);
+    QVERIFY(daemon->isListening());
+
+    client = new QTcpSocket();
+    client->connectToHost(QHostAddress::LocalHost, daemon->serverPort());
+    QVERIFY(client->waitForConnected(1000));
+    client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+}
+
+void KeySenderDaemonLatencyTest::cleanup()
+{
+    delete client;
+    delete daemon;
+}
+
+qint64 KeySenderDaemonLatencyTest::roundTrip(const QByteArray& command)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    client->write(command + "\nping\n");
+    while (!client->canReadLine())
+    {
+        if (timer.elapsed() > 1000)
+        {
+            return -1;
+        }
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+
+    qint64 elapsed = timer.nsecsElapsed();
+    if (client->readLine() != "pong\n")
+    {
+        return -1;
+    }
+
+    return elapsed;
+}
+
+void KeySenderDaemonLatencyTest::verifyPing()
+{
+    QVERIFY(roundTrip("sendNext") >= 0);
+    QVERIFY(roundTrip("unknown") >= 0);
+}
+
+QByteArray KeySenderDaemonLatencyTest::statistics(const QByteArray& lines)
+{
+    client->write(lines + "stats\n");
+
+    // The statistics end with a marker
+    QByteArray statistics;
+    QElapsedTimer timer;
+    timer.start();
+    while (!statistics.endsWith("# EOF\n") && timer.elapsed() < 1000)
+    {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+        statistics.append(client->readAll());
+    }
+
+    return statistics;
+}
+
+void KeySenderDaemonLatencyTest::verifyMotionCoalescing()
+{
+    const int moves = 100;
+
+    QByteArray lines;
+    for (int i = 0; i < moves; i++)
+    {
+        lines.append("move 1 -1\n");
+    }
+    QByteArray statistics = this->statistics(lines);
+
+    QVERIFY(statistics.contains(
+            "presenter_daemon_pointer_moves_total 100\n"));
+
+    QByteArray name("presenter_daemon_pointer_flushes_total ");
+    int start = statistics.indexOf("\n" + name) + 1 + name.length();
+    quint64 flushes = statistics.mid(start, statistics.indexOf('\n', start)
+                                                - start).toULongLong();
+    qInfo("%d moves were injected as %llu motions", moves, flushes);
+    QVERIFY(flushes >= 1);
+    QVERIFY(flushes < quint64(moves));
+}
+
+void KeySenderDaemonLatencyTest::verifyLongLines()
+{
+    // The second piece of the line would be a valid command on its own
+    QByteArray statistics = this->statistics(QByteArray(63, 'x')
+                                             + "sendNext\n");
+
+    QVERIFY(statistics.contains(
+            "presenter_daemon_commands_total{command=\"sendNext\"} 0\n"));
+    QVERIFY(statistics.contains(
+            "presenter_daemon_commands_total{command=\"ignored\"} 1\n"));
+}
+
+void KeySenderDaemonLatencyTest::verifyScheduleOwners()
+{
+    QTcpSocket other;
+    other.connectToHost(QHostAddress::LocalHost, daemon->serverPort());
+    QVERIFY(other.waitForConnected(1000));
+    other.write("schedule 1 sendNext 60000 0\n");
+
+    // The connections are read independently
+    QElapsedTimer timer;
+    timer.start();
+    while (!statistics("").contains("presenter_daemon_schedules 1\n"))
+    {
+        QVERIFY(timer.elapsed() < 5000);
+    }
+
+    // Same id, so it must not replace the schedule of the other connection
+    QVERIFY(statistics("schedule 1 sendPrev 60000 0\n").contains(
+            "presenter_daemon_schedules 2\n"));
+    QVERIFY(statistics("cancel 1\ncancelAll\n").contains(
+            "presenter_daemon_schedules 1\n"));
+
+    other.disconnectFromHost();
+    timer.restart();
+    while (!statistics("").contains("presenter_daemon_schedules 0\n"))
+    {
+        QVERIFY(timer.elapsed() < 5000);
+    }
+}
+
+void KeySenderDaemonLatencyTest::verifyScheduleLimit()
+{
+    QByteArray lines;
+    for (int id = 1; id <= 65; id++)
+    {
+        lines.append(QString("schedule %1 sendNext 60000 0\n").arg(id)
+                     .toLatin1());
+    }
+    lines.append("schedule 66 unknown 60000 0\n");
+
+    QByteArray statistics = this->statistics(lines);
+    QVERIFY(statistics.startsWith("scheduled 1\n"));
+    QVERIFY(statistics.contains("scheduled 64\n"));
+    QVERIFY(statistics.contains("rejected 65\n"));
+    QVERIFY(statistics.contains("rejected 66\n"));
+    QVERIFY(statistics.contains("presenter_daemon_schedules 64\n"));
+}
+
+void KeySenderDaemonLatencyTest::verifyLatencyUnderLoad()
+{
+    // The config applies to all threads that exist, the hogs are started
+    // afterwards and drop the inherited priority
+    RealtimeConfig config;
+    config.setPriority(10);
+    bool realtime = config.apply();
+
+    QList<CpuHog*> hogs;
+    for (int i = 0; i < qMax(2, QThread::idealThreadCount()); i++)
+    {
+        hogs.append(new CpuHog());
+        hogs.last()->start();
+    }
+
+    QVector<qint64> latencies;
+    if (realtime)
+    {
+        for (int i = 0; i < samples; i++)
+        {
+            latencies.append(roundTrip(i % 2 ? "sendNext" : "sendPrev"));
+        }
+
+        // Back to normal scheduling for the remaining tests
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        sched_setscheduler(0, SCHED_OTHER, &param);
+    }
+
+    for (CpuHog* hog: hogs)
+    {
+        hog->stop();
+        hog->wait();
+    }
+    qDeleteAll(hogs);
+
+    if (!realtime)
+    {
+        QSKIP("Real-time scheduling is not permitted");
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    QVERIFY2(latencies.first() >= 0, "Command timed out");
+
+    qint64 p99 = latencies.at(samples * 99 / 100);
+    qInfo("Latency under load: median %lld us, p99 %lld us",
+          latencies.at(samples / 2) / 1000, p99 / 1000);
+    QVERIFY2(p99 < maxLatency, "99th percentile latency too high");
+}
+
+QTEST_MAIN(KeySenderDaemonLatencyTest)
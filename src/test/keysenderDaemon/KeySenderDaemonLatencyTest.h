@@ -0,0 +1,158 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * KeySenderDaemonLatencyTest.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TEST_KEYSENDERDAEMON_KEYSENDERDAEMONLATENCYTEST_H_
+#define SRC_TEST_KEYSENDERDAEMON_KEYSENDERDAEMONLATENCYTEST_H_
+
+#include <QTest>
+#include <QThread>
+#include <QAtomicInt>
+#include <QTcpSocket>
+
+#include "../../keysenderDaemon/KeySenderDaemon.h"
+
+#ifdef _DEBUG
+    #ifdef _WIN32
+        #ifdef _MSC_VER
+             // Uncomment this if you installed visual memory
+             // leak detector from http://vld.codeplex.com/
+            #include <vld.h>
+        #endif
+    #endif
+#endif
+
+/**
+ * A thread that keeps a cpu busy until it is stopped.
+ */
+class CpuHog: public QThread
+{
+    public:
+        /**
+         * Creates a new hog. Call start to keep the cpu busy.
+         */
+        CpuHog();
+
+        /**
+         * Stops the hog.
+         */
+        void stop();
+
+    protected:
+        /**
+         * Keeps the cpu busy until stopped.
+         */
+        void run();
+
+    private:
+        /**
+         * If the hog should keep running.
+         */
+        QAtomicInt keepRunning;
+};
+
+/**
+ * Verifies the latency of the key sender daemon while all cpus are busy.
+ * The daemon writes its keys to the null device, so the test does not
+ * inject keys and runs without uinput access.
+ */
+class KeySenderDaemonLatencyTest: public QObject
+{
+    Q_OBJECT
+
+    private:
+        /**
+         * The daemon under test.
+         */
+        KeySenderDaemon* daemon;
+
+        /**
+         * The client that sends the commands.
+         */
+        QTcpSocket* client;
+
+        /**
+         * Sends a command followed by a ping and waits for the pong.
+         *
+         * @param command The command to send.
+         * @return The round trip time in nanoseconds or -1 on timeout.
+         */
+        qint64 roundTrip(const QByteArray& command);
+
+        /**
+         * Sends the given lines followed by a stats command and waits for
+         * the statistics.
+         *
+         * @param lines The lines to send before the stats command.
+         * @return The statistics or what was received until the timeout.
+         */
+        QByteArray statistics(const QByteArray& lines);
+
+    private slots:
+        /**
+         * Starts the daemon and connects the client.
+         */
+        void init();
+
+        /**
+         * Disconnects the client and stops the daemon.
+         */
+        void cleanup();
+
+        /**
+         * Verifies that the daemon answers pings.
+         */
+        void verifyPing();
+
+        /**
+         * Verifies that pointer moves which arrive at once are injected as
+         * a single motion.
+         */
+        void verifyMotionCoalescing();
+
+        /**
+         * Verifies that a line longer than the command buffer is ignored as
+         * a whole instead of being parsed in pieces.
+         */
+        void verifyLongLines();
+
+        /**
+         * Verifies that the schedules of different connections don't
+         * collide and are cancelled with their connection.
+         */
+        void verifyScheduleOwners();
+
+        /**
+         * Verifies that schedules are answered and rejected once too many
+         * are pending.
+         */
+        void verifyScheduleLimit();
+
+        /**
+         * Verifies the latency of commands while other threads keep all
+         * cpus busy. Skipped if real-time scheduling is not permitted.
+         */
+        void verifyLatencyUnderLoad();
+};
+
+#endif /* SRC_TEST_KEYSENDERDAEMON_KEYSENDERDAEMONLATENCYTEST_H_ */
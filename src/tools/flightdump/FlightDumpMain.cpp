@@ -0,0 +1,157 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FlightDumpMain.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include <QFile>
+#include <QVector>
+#include <QDateTime>
+#include <QTextStream>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "../../main/diagnostics/FlightRecorder.h"
+
+/**
+ * Compares records by their sequence number.
+ */
+static bool olderThan(const FlightRecord& first, const FlightRecord& second)
+{
+    return first.sequence < second.sequence;
+}
+
+/**
+ * Main method of the flight dump tool. Prints the last records of a flight
+ * recorder file, oldest first.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+            "Prints the command events of a presenter flight recorder file.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "The flight recorder file.");
+    QCommandLineOption lastOption("last",
+            "Print only the last <count> events.", "count", "1000");
+    parser.addOption(lastOption);
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+    {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    bool valid = false;
+    int last = parser.value(lastOption).toInt(&valid);
+    if (!valid || last <= 0)
+    {
+        err << "Invalid count" << endl;
+        return EXIT_FAILURE;
+    }
+
+    QFile file(parser.positionalArguments().first());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        err << "Could not open " << file.fileName() << endl;
+        return EXIT_FAILURE;
+    }
+
+    QByteArray data = file.readAll();
+    FlightRecorderHeader header;
+    if (data.size() < int(sizeof(header)))
+    {
+        err << "File too small" << endl;
+        return EXIT_FAILURE;
+    }
+    memcpy(&header, data.constData(), sizeof(header));
+
+    if (memcmp(header.magic, FlightRecorder::magic,
+               sizeof(header.magic)) != 0
+        || header.version != FlightRecorder::version
+        || header.recordSize != sizeof(FlightRecord)
+        || data.size() < int(sizeof(header)
+                             + header.capacity * sizeof(FlightRecord)))
+    {
+        err << "Not a flight recorder file or unsupported version" << endl;
+        return EXIT_FAILURE;
+    }
+
+    // The server may record while the file is read. A record that is being
+    // written has no sequence number, and a record that was rewritten while
+    // it was read has a different sequence number in a second read. Both
+    // are skipped.
+    file.seek(0);
+    QByteArray again = file.read(data.size());
+
+    QVector<FlightRecord> records;
+    records.reserve(int(header.capacity));
+    const char* recordData = data.constData() + sizeof(header);
+    for (quint32 i = 0; i < header.capacity; i++)
+    {
+        FlightRecord record;
+        memcpy(&record, recordData + i * sizeof(FlightRecord), sizeof(record));
+
+        quint64 sequence = 0;
+        int offset = int(sizeof(header) + i * sizeof(FlightRecord));
+        if (again.size() >= offset + int(sizeof(sequence)))
+        {
+            memcpy(&sequence, again.constData() + offset, sizeof(sequence));
+        }
+
+        if (record.sequence != 0 && record.sequence == sequence)
+        {
+            record.client[sizeof(record.client) - 1] = '\0';
+            records.append(record);
+        }
+    }
+
+    std::sort(records.begin(), records.end(), olderThan);
+    int first = qMax(records.size() - last, 0);
+
+    for (int i = first; i < records.size(); i++)
+    {
+        const FlightRecord& record = records.at(i);
+        QDateTime time = QDateTime::fromMSecsSinceEpoch(
+                record.timestamp / 1000).toUTC();
+
+        out << time.toString("yyyy-MM-dd'T'HH:mm:ss.zzz")
+            << QString("%1").arg(record.timestamp % 1000, 3, 10, QChar('0'))
+            << "Z #" << record.sequence
+            << " " << FlightRecorder::sourceName(record.source)
+            << " client " << record.clientId
+            << " (" << record.client << ")"
+            << " " << FlightRecorder::commandName(record.command)
+            << " " << FlightRecorder::outcomeName(record.outcome)
+            << endl;
+    }
+
+    return EXIT_SUCCESS;
+}
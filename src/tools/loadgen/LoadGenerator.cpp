@@ -0,0 +1,324 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LoadGenerator.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include "LoadGenerator.h"
+
+#include <QSet>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <cmath>
+#include <algorithm>
+
+LoadGenerator::LoadGenerator(const QHostAddress& server, quint16 port,
+                             int clientCount) :
+    server(server), port(port), clientCount(clientCount), rate(10),
+    burst(1), command("nextSlide"), duration(10), durationTimer(this),
+    drainTimer(this), failedClients(0), sentCommands(0), lostCommands(0),
+    firstSend(-1), lastAck(0), sending(false), running(false)
+{
+    durationTimer.setSingleShot(true);
+    connect(&durationTimer, SIGNAL(timeout()), this, SLOT(stopSending()));
+    drainTimer.setSingleShot(true);
+    connect(&drainTimer, SIGNAL(timeout()), this, SLOT(finish()));
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    // Each client is registered with its socket and its timer
+    for (Client* client: clients.values().toSet())
+    {
+        delete client->timer;
+        delete client->socket;
+        delete client;
+    }
+}
+
+void LoadGenerator::setRate(double rate, int burst)
+{
+    this->rate = rate;
+    this->burst = burst;
+}
+
+void LoadGenerator::setCommand(const QString& command)
+{
+    this->command = command;
+}
+
+void LoadGenerator::setDuration(int seconds)
+{
+    duration = seconds;
+}
+
+qint64 LoadGenerator::now() const
+{
+    return clock.nsecsElapsed() / 1000;
+}
+
+void LoadGenerator::start()
+{
+    clock.start();
+    sending = true;
+    running = true;
+
+    // A burst is sent each interval, so the rate is kept on average
+    int interval = qMax(int(1000 * burst / rate), 1);
+
+    connectTimes.reserve(clientCount);
+    latencies.reserve(int(qMin(rate * duration * clientCount, 1e7)));
+
+    for (int i = 0; i < clientCount; i++)
+    {
+        Client* client = new Client();
+        client->socket = new QTcpSocket();
+        client->timer = new QTimer();
+        client->timer->setTimerType(Qt::PreciseTimer);
+        client->timer->setInterval(interval);
+        client->nextId = 0;
+        client->failed = false;
+        clients.insert(client->socket, client);
+        clients.insert(client->timer, client);
+
+        connect(client->socket, SIGNAL(connected()),
+                          this, SLOT(clientConnected()));
+        connect(client->socket, SIGNAL(error(QAbstractSocket::SocketError)),
+                          this, SLOT(clientError()));
+        connect(client->socket, SIGNAL(readyRead()),
+                          this, SLOT(readSocket()));
+        connect(client->timer, SIGNAL(timeout()), this, SLOT(sendBurst()));
+
+        client->connectStart = now();
+        client->socket->connectToHost(server, port);
+    }
+
+    durationTimer.start(duration * 1000);
+}
+
+void LoadGenerator::clientConnected()
+{
+    Client* client = clients.value(sender());
+    if (!client)
+    {
+        return;
+    }
+
+    // Send each command right away like the apps do
+    client->socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connectTimes.append(now() - client->connectStart);
+
+    if (sending)
+    {
+        client->timer->start();
+    }
+}
+
+void LoadGenerator::clientError()
+{
+    Client* client = clients.value(sender());
+    if (!client || client->failed)
+    {
+        return;
+    }
+
+    client->failed = true;
+    client->timer->stop();
+    failedClients++;
+    lostCommands += client->pending.size();
+    client->pending.clear();
+
+    qWarning("Client %d: %s", client->socket->localPort(),
+             qPrintable(client->socket->errorString()));
+    checkFinished();
+}
+
+void LoadGenerator::sendBurst()
+{
+    Client* client = clients.value(sender());
+    if (!client || client->failed)
+    {
+        return;
+    }
+
+    qint64 sendTime = now();
+    if (firstSend < 0)
+    {
+        firstSend = sendTime;
+    }
+
+    QByteArray commands;
+    for (int i = 0; i < burst; i++)
+    {
+        quint64 id = client->nextId++;
+        commands.append("{ \"type\": \"command\", \"data\": \"")
+                .append(command.toUtf8())
+                .append("\", \"id\": ")
+                .append(QByteArray::number(id))
+                .append(" }\n\n");
+        client->pending.insert(id, sendTime);
+    }
+    client->socket->write(commands);
+    sentCommands += burst;
+}
+
+void LoadGenerator::readSocket()
+{
+    Client* client = clients.value(sender());
+    if (!client)
+    {
+        return;
+    }
+
+    client->buffer.append(client->socket->readAll());
+
+    // Messages end with an empty line
+    int end;
+    while ((end = client->buffer.indexOf("\n\n")) >= 0)
+    {
+        handleMessage(client, client->buffer.left(end));
+        client->buffer.remove(0, end + 2);
+    }
+
+    checkFinished();
+}
+
+void LoadGenerator::handleMessage(Client* client, const QByteArray& message)
+{
+    // Other messages, e.g. the version, are not of interest
+    QJsonObject object = QJsonDocument::fromJson(message).object();
+    if (object["type"].toString() != "ack")
+    {
+        return;
+    }
+
+    quint64 id = quint64(object["data"].toDouble());
+    QHash<quint64, qint64>::iterator sent = client->pending.find(id);
+    if (sent == client->pending.end())
+    {
+        qWarning("Unexpected acknowledgement %llu", id);
+        return;
+    }
+
+    lastAck = now();
+    latencies.append(lastAck - sent.value());
+    client->pending.erase(sent);
+}
+
+void LoadGenerator::stopSending()
+{
+    sending = false;
+    for (Client* client: clients)
+    {
+        client->timer->stop();
+    }
+
+    drainTimer.start(drainTimeout);
+    checkFinished();
+}
+
+int LoadGenerator::pendingCommands() const
+{
+    int pending = 0;
+    for (QHash<QObject*, Client*>::const_iterator client = clients.begin();
+         client != clients.end(); ++client)
+    {
+        // Each client is registered twice
+        if (client.key() == client.value()->socket)
+        {
+            pending += client.value()->pending.size();
+        }
+    }
+
+    return pending;
+}
+
+void LoadGenerator::checkFinished()
+{
+    if (running && !sending && pendingCommands() == 0)
+    {
+        finish();
+    }
+}
+
+void LoadGenerator::finish()
+{
+    if (!running)
+    {
+        return;
+    }
+
+    running = false;
+    sending = false;
+    drainTimer.stop();
+    durationTimer.stop();
+
+    lostCommands += pendingCommands();
+    emit finished();
+}
+
+double LoadGenerator::percentile(const QVector<qint64>& sorted,
+                                 double fraction)
+{
+    if (sorted.isEmpty())
+    {
+        return 0;
+    }
+
+    int rank = int(std::ceil(fraction * sorted.size()));
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1)) / 1000.0;
+}
+
+void LoadGenerator::printReport(QTextStream& out) const
+{
+    QVector<qint64> sortedConnectTimes(connectTimes);
+    std::sort(sortedConnectTimes.begin(), sortedConnectTimes.end());
+    QVector<qint64> sortedLatencies(latencies);
+    std::sort(sortedLatencies.begin(), sortedLatencies.end());
+
+    double seconds = firstSend >= 0 && lastAck > firstSend
+            ? (lastAck - firstSend) / 1000000.0 : 0;
+
+    out << "Clients:      " << connectTimes.size() << " connected, "
+        << failedClients << " failed" << endl;
+    out << "Connect time: p50 " << percentile(sortedConnectTimes, 0.5)
+        << " ms, p99 " << percentile(sortedConnectTimes, 0.99)
+        << " ms, max " << percentile(sortedConnectTimes, 1) << " ms"
+        << endl;
+    out << "Commands:     " << sentCommands << " sent, "
+        << latencies.size() << " acknowledged, " << lostCommands
+        << " lost" << endl;
+    out << "Throughput:   "
+        << (seconds > 0 ? latencies.size() / seconds : 0)
+        << " commands/s" << endl;
+    out << "Latency:      p50 " << percentile(sortedLatencies, 0.5)
+        << " ms, p90 " << percentile(sortedLatencies, 0.9)
+        << " ms, p99 " << percentile(sortedLatencies, 0.99)
+        << " ms, p99.9 " << percentile(sortedLatencies, 0.999)
+        << " ms, max " << percentile(sortedLatencies, 1) << " ms" << endl;
+}
+
+bool LoadGenerator::succeeded() const
+{
+    return failedClients == 0 && lostCommands == 0 && sentCommands > 0;
+}
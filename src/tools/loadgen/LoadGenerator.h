@@ -0,0 +1,335 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LoadGenerator.h
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#ifndef SRC_TOOLS_LOADGEN_LOADGENERATOR_H_
+#define SRC_TOOLS_LOADGEN_LOADGENERATOR_H_
+
+#include <QHash>
+#include <QList>
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QHostAddress>
+#include <QElapsedTimer>
+
+/**
+ * Generates load on the network connector of a presenter server. Opens
+ * concurrent client connections, sends commands with an id in bursts at a
+ * fixed rate and measures the time until the server acknowledged them.
+ */
+class LoadGenerator: public QObject
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * Creates a new load generator.
+         *
+         * @param server The address of the server.
+         * @param port The port of the tcp server.
+         * @param clientCount The number of concurrent clients.
+         */
+        LoadGenerator(const QHostAddress& server, quint16 port,
+                      int clientCount);
+
+        /**
+         * Closes all connections.
+         */
+        ~LoadGenerator();
+
+        /**
+         * Sets the rate of the commands.
+         *
+         * @param rate The commands per second of each client.
+         * @param burst The number of commands that are sent at once.
+         */
+        void setRate(double rate, int burst);
+
+        /**
+         * Sets the command that is sent.
+         *
+         * @param command The command, e.g. "nextSlide".
+         */
+        void setCommand(const QString& command);
+
+        /**
+         * Sets the time the commands are sent.
+         *
+         * @param seconds The duration in seconds.
+         */
+        void setDuration(int seconds);
+
+        /**
+         * Connects the clients and starts sending. Emits {@link #finished}
+         * once done.
+         */
+        void start();
+
+        /**
+         * Prints the measured connect times, throughput and latencies.
+         *
+         * @param out The stream to print to.
+         */
+        void printReport(QTextStream& out) const;
+
+        /**
+         * Returns if all clients connected and all commands were
+         * acknowledged.
+         *
+         * @return True if the run was successful.
+         */
+        bool succeeded() const;
+
+    signals:
+        /**
+         * Emitted once all commands were sent and acknowledged or the
+         * acknowledgements timed out.
+         */
+        void finished();
+
+    private:
+        /**
+         * Time in milliseconds to wait for outstanding acknowledgements.
+         */
+        static const int drainTimeout = 2000;
+
+        /**
+         * The state of a client.
+         */
+        struct Client
+        {
+            /**
+             * The connection to the server.
+             */
+            QTcpSocket* socket;
+
+            /**
+             * Triggers the bursts of the client.
+             */
+            QTimer* timer;
+
+            /**
+             * The time the connection was started in microseconds.
+             */
+            qint64 connectStart;
+
+            /**
+             * The id of the next command.
+             */
+            quint64 nextId;
+
+            /**
+             * The send time in microseconds of the commands that were not
+             * acknowledged yet, by id.
+             */
+            QHash<quint64, qint64> pending;
+
+            /**
+             * The received data that does not form a complete message yet.
+             */
+            QByteArray buffer;
+
+            /**
+             * If the client could not connect or lost the connection.
+             */
+            bool failed;
+        };
+
+        /**
+         * The address of the server.
+         */
+        QHostAddress server;
+
+        /**
+         * The port of the tcp server.
+         */
+        quint16 port;
+
+        /**
+         * The number of concurrent clients.
+         */
+        int clientCount;
+
+        /**
+         * The commands per second of each client.
+         */
+        double rate;
+
+        /**
+         * The number of commands that are sent at once.
+         */
+        int burst;
+
+        /**
+         * The command that is sent.
+         */
+        QString command;
+
+        /**
+         * The time in seconds the commands are sent.
+         */
+        int duration;
+
+        /**
+         * The clients by their socket and their timer.
+         */
+        QHash<QObject*, Client*> clients;
+
+        /**
+         * Monotonic clock of all measurements.
+         */
+        QElapsedTimer clock;
+
+        /**
+         * Ends the sending once the duration is over.
+         */
+        QTimer durationTimer;
+
+        /**
+         * Ends the run if not all commands are acknowledged.
+         */
+        QTimer drainTimer;
+
+        /**
+         * The measured connect times in microseconds.
+         */
+        QVector<qint64> connectTimes;
+
+        /**
+         * The measured latencies from sending a command to its
+         * acknowledgement in microseconds.
+         */
+        QVector<qint64> latencies;
+
+        /**
+         * The number of clients that could not connect or lost their
+         * connection.
+         */
+        int failedClients;
+
+        /**
+         * The number of sent commands.
+         */
+        quint64 sentCommands;
+
+        /**
+         * The number of commands whose connection was lost before they
+         * were acknowledged.
+         */
+        quint64 lostCommands;
+
+        /**
+         * The time the first command was sent in microseconds, -1 if none.
+         */
+        qint64 firstSend;
+
+        /**
+         * The time the last acknowledgement was received in microseconds.
+         */
+        qint64 lastAck;
+
+        /**
+         * If the commands are still sent.
+         */
+        bool sending;
+
+        /**
+         * If the run did not finish yet.
+         */
+        bool running;
+
+        /**
+         * Returns the current time of the clock.
+         *
+         * @return The time in microseconds.
+         */
+        qint64 now() const;
+
+        /**
+         * Returns the number of commands that were not acknowledged yet.
+         *
+         * @return The number of commands.
+         */
+        int pendingCommands() const;
+
+        /**
+         * Emits {@link #finished} if nothing is outstanding anymore.
+         */
+        void checkFinished();
+
+        /**
+         * Handles a complete message from the server.
+         *
+         * @param client The client that received the message.
+         * @param message The message.
+         */
+        void handleMessage(Client* client, const QByteArray& message);
+
+        /**
+         * Returns a percentile of sorted values.
+         *
+         * @param sorted The sorted values.
+         * @param fraction The fraction of values that are lower or equal,
+         *                 e.g. 0.99.
+         * @return The percentile in milliseconds, 0 if there are no values.
+         */
+        static double percentile(const QVector<qint64>& sorted,
+                                 double fraction);
+
+    private slots:
+        /**
+         * Called once a client connected. Starts its bursts.
+         */
+        void clientConnected();
+
+        /**
+         * Called if a client could not connect or lost the connection.
+         */
+        void clientError();
+
+        /**
+         * Reads the acknowledgements of a client.
+         */
+        void readSocket();
+
+        /**
+         * Sends a burst of commands.
+         */
+        void sendBurst();
+
+        /**
+         * Stops sending and waits for the outstanding acknowledgements.
+         */
+        void stopSending();
+
+        /**
+         * Ends the run.
+         */
+        void finish();
+};
+
+#endif /* SRC_TOOLS_LOADGEN_LOADGENERATOR_H_ */
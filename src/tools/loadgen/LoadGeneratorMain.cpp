@@ -0,0 +1,187 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *  Presenter. Server software to remote control a presentation.         *
+ *  Copyright (C) 2026 Felix Wohlfrom                                    *
+ *                                                                       *
+ *  This program is free software: you can redistribute it and/or modify *
+ *  it under the terms of the GNU General Public License as published by *
+ *  the Free Software Foundation, either version 3 of the License, or    *
+ *  (at your option) any later version.                                  *
+ *                                                                       *
+ *  This program is distributed in the hope that it will be useful,      *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ *  GNU General Public License for more details.                         *
+ *                                                                       *
+ *  You should have received a copy of the GNU General Public License    *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * LoadGeneratorMain.cpp
+ *
+ *  Created on: 19.10.2026
+ *      Author: Felix Wohlfrom
+ */
+
+#include <QUdpSocket>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "LoadGenerator.h"
+#include "../../main/connector/network/NetworkConnector.h"
+
+// The message that asks the servers to send their announcement. Same as the
+// first line of the announcement.
+static const QByteArray probeMessage("be71c255-8349-4d86-b09e-7983c035a191");
+
+/**
+ * Finds a server by probing for its announcement on the local host, via
+ * broadcast and via the IPv4 multicast group.
+ *
+ * @param server Receives the address of the first server that answered.
+ * @param name Receives the host name of the server.
+ * @param timeout Time in milliseconds to wait for an answer.
+ * @return False if no server answered.
+ */
+static bool discover(QHostAddress* server, QString* name, int timeout)
+{
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::AnyIPv4, 0))
+    {
+        return false;
+    }
+
+    QList<QHostAddress> targets;
+    targets << QHostAddress(QHostAddress::LocalHost)
+            << QHostAddress(QHostAddress::Broadcast)
+            << QHostAddress(QString(NetworkConnector::multicastGroupIPv4));
+
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < timeout)
+    {
+        // Probes may get lost, so repeat them until a server answered
+        for (const QHostAddress& target: targets)
+        {
+            socket.writeDatagram(probeMessage, target,
+                                 NetworkConnector::broadcastPort);
+        }
+
+        if (!socket.waitForReadyRead(500))
+        {
+            continue;
+        }
+
+        while (socket.hasPendingDatagrams())
+        {
+            QByteArray datagram(int(socket.pendingDatagramSize()), '\0');
+            socket.readDatagram(datagram.data(), datagram.size(), server);
+
+            // The announcement is the probe followed by the host name
+            if (datagram.startsWith(probeMessage + "\n"))
+            {
+                *name = QString::fromUtf8(
+                        datagram.mid(probeMessage.size() + 1));
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Main method of the load generator. Sends commands from concurrent clients
+ * to a presenter server and reports the throughput and latencies. Start the
+ * server with --no-key-injection to measure it without controlling the
+ * presentation.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+            "Generates load on the network connector of a presenter server.");
+    parser.addHelpOption();
+    QCommandLineOption hostOption("host",
+            "The address of the server. Discovered if not set.", "address");
+    parser.addOption(hostOption);
+    QCommandLineOption portOption("port", "The port of the server.", "port",
+            QString::number(NetworkConnector::defaultCommandPort));
+    parser.addOption(portOption);
+    QCommandLineOption clientsOption("clients",
+            "The number of concurrent clients.", "count", "10");
+    parser.addOption(clientsOption);
+    QCommandLineOption rateOption("rate",
+            "The commands per second of each client.", "rate", "10");
+    parser.addOption(rateOption);
+    QCommandLineOption burstOption("burst",
+            "The number of commands each client sends at once.", "count",
+            "1");
+    parser.addOption(burstOption);
+    QCommandLineOption durationOption("duration",
+            "The time in seconds the commands are sent.", "seconds", "10");
+    parser.addOption(durationOption);
+    QCommandLineOption commandOption("command", "The command to send.",
+            "command", "nextSlide");
+    parser.addOption(commandOption);
+    parser.process(app);
+
+    bool validPort = false;
+    bool validClients = false;
+    bool validRate = false;
+    bool validBurst = false;
+    bool validDuration = false;
+    quint16 port = parser.value(portOption).toUShort(&validPort);
+    int clients = parser.value(clientsOption).toInt(&validClients);
+    double rate = parser.value(rateOption).toDouble(&validRate);
+    int burst = parser.value(burstOption).toInt(&validBurst);
+    int duration = parser.value(durationOption).toInt(&validDuration);
+    if (!validPort || !validClients || clients <= 0 || !validRate
+        || rate <= 0 || !validBurst || burst <= 0 || !validDuration
+        || duration <= 0)
+    {
+        err << "Invalid option, see --help" << endl;
+        return EXIT_FAILURE;
+    }
+
+    QHostAddress server;
+    if (parser.isSet(hostOption))
+    {
+        if (!server.setAddress(parser.value(hostOption)))
+        {
+            err << "Invalid address " << parser.value(hostOption) << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        QString name;
+        if (!discover(&server, &name, 5000))
+        {
+            err << "No server found" << endl;
+            return EXIT_FAILURE;
+        }
+        out << "Found " << name << " at " << server.toString() << endl;
+    }
+
+    out << "Sending " << rate << " commands/s in bursts of " << burst
+        << " from " << clients << " clients for " << duration << " s"
+        << endl;
+
+    LoadGenerator generator(server, port, clients);
+    generator.setRate(rate, burst);
+    generator.setCommand(parser.value(commandOption));
+    generator.setDuration(duration);
+    QObject::connect(&generator, SIGNAL(finished()), &app, SLOT(quit()));
+    generator.start();
+    app.exec();
+
+    generator.printReport(out);
+    return generator.succeeded() ? EXIT_SUCCESS : EXIT_FAILURE;
+}